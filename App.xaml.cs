@@ -34,9 +34,33 @@ namespace VilsSharpX
                 ex.SetObserved();
             };
 
+            // --trace [file]: record a TraceLog session, exported to Chrome/Perfetto JSON on exit
+            int traceArg = Array.IndexOf(e.Args, "--trace");
+            if (traceArg >= 0)
+            {
+                string path = traceArg + 1 < e.Args.Length && !e.Args[traceArg + 1].StartsWith("--")
+                    ? e.Args[traceArg + 1]
+                    : Path.Combine(AppContext.BaseDirectory, $"trace_{DateTime.Now:yyyyMMdd_HHmmss}{TraceLog.FileExtension}");
+                try { TraceLog.Start(path); }
+                catch (Exception ex) { Log("TraceLog.Start", ex); }
+            }
+
             base.OnStartup(e);
         }
 
+        protected override void OnExit(ExitEventArgs e)
+        {
+            string? tracePath = TraceLog.Path;
+            if (tracePath != null)
+            {
+                TraceLog.Stop();
+                try { TraceLog.ExportChromeJson(tracePath, Path.ChangeExtension(tracePath, ".json")); }
+                catch (Exception ex) { Log("TraceLog.ExportChromeJson", ex); }
+            }
+            DiagnosticLogger.Flush();
+            base.OnExit(e);
+        }
+
         private static void Log(string tag, Exception ex)
         {
             try
@@ -45,6 +45,12 @@ public sealed class AppSettings
 
     // LVDS serial capture (Pico 2 board via USB CDC COM port)
     public string? LvdsPortHint { get; set; } = null;
+
+    // PCAP TX in player mode: inject the capture's packets at their recorded timing
+    // (false = re-encode the decoded frames at the FPS setting, like other sources).
+    // Speed scales the recorded timing of the replay; 0 = as fast as possible.
+    public bool PcapTxAsCaptured { get; set; } = true;
+    public double PcapReplaySpeed { get; set; } = 1.0;
 }
 
 public static class AppSettingsStore
@@ -110,7 +110,9 @@ public sealed class AviTripletRecorder : IDisposable
     public bool TryEnqueue(byte[] aGray, byte[] bGray, byte[] dBgrTopDown)
     {
         if (_queue.IsAddingCompleted) return false;
-        return _queue.TryAdd(new FrameSet(aGray, bGray, dBgrTopDown));
+        bool accepted = _queue.TryAdd(new FrameSet(aGray, bGray, dBgrTopDown));
+        TraceLog.Instant(TraceEvent.AviEnqueue, accepted ? 1 : 0, _queue.Count);
+        return accepted;
     }
 
     public void Dispose()
@@ -233,6 +235,7 @@ public sealed class AviTripletRecorder : IDisposable
                 // Start the stopwatch on the very first frame.
                 if (_frameCount == 0) _recSw.Start();
                 _frameCount++;
+                TraceLog.Begin(TraceEvent.AviWrite, _frameCount);
 
                 _lastAForReport = set.AGray;
                 _lastBForReport = set.BGray;
@@ -247,6 +250,7 @@ public sealed class AviTripletRecorder : IDisposable
                 _streamA.WriteFrame(true, _a8, 0, _a8.Length);
                 _streamB.WriteFrame(true, _b8, 0, _b8.Length);
                 _streamD.WriteFrame(true, _d32, 0, _d32.Length);
+                TraceLog.End(TraceEvent.AviWrite);
             }
         }
         catch (OperationCanceledException)
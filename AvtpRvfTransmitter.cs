@@ -73,6 +73,9 @@ namespace VilsSharpX
             _seq = 0;
         }
 
+        /// <summary>The opened TX device, e.g. for <see cref="PcapReplayTransmitter"/>.</summary>
+        public LibPcapLiveDevice Device => _dev;
+
         public void Dispose()
         {
             try { _dev?.Close(); } catch { /* ignore */ }
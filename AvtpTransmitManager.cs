@@ -24,6 +24,10 @@ public sealed class AvtpTransmitManager : IDisposable
     private readonly byte[] _blackFrame;
     private readonly byte[] _paddedFrame; // Reusable buffer for padding
 
+    private readonly object _replayLock = new();
+    private CancellationTokenSource? _replayCts;
+    private volatile Thread? _replayThread;
+
     private int _txErrOnce;
     private int _txNoDevOnce;
 
@@ -43,6 +47,15 @@ public sealed class AvtpTransmitManager : IDisposable
     /// </summary>
     public bool IsReady => _tx != null;
 
+    /// <summary>
+    /// Whether a PCAP replay (<see cref="StartPcapReplay"/>) is running or
+    /// finished and not stopped yet; <see cref="SendFrameAsync"/> sends nothing meanwhile.
+    /// </summary>
+    public bool IsReplayingPcap => _replayThread != null;
+
+    /// <summary>Totals of the current or last PCAP replay.</summary>
+    public PcapReplayStats? LastReplayStats { get; private set; }
+
     /// <summary>
     /// Initializes the transmitter on the specified device.
     /// </summary>
@@ -87,6 +100,7 @@ public sealed class AvtpTransmitManager : IDisposable
                 _log("[avtp-tx] TX is NULL -> nothing will be sent (select NIC and press Start).");
             return false;
         }
+        if (IsReplayingPcap) return false;
 
         try
         {
@@ -130,6 +144,81 @@ public sealed class AvtpTransmitManager : IDisposable
         return _paddedFrame;
     }
 
+    /// <summary>
+    /// Injects the packets of <paramref name="cache"/> as captured, at
+    /// <paramref name="speed"/> × their recorded timing
+    /// (<see cref="PcapReplayTransmitter.Unpaced"/> for as fast as possible),
+    /// once or in a loop until <see cref="StopPcapReplay"/>.  Runs on its own
+    /// thread; totals are logged after every pass.  May be called from any thread.
+    /// </summary>
+    public bool StartPcapReplay(PcapPacketCache cache, double speed, bool loop,
+        ManualResetEventSlim? pauseGate = null, Action<PcapReplayStats>? onComplete = null)
+    {
+        lock (_replayLock)
+        {
+            StopPcapReplay();
+            StopBlackLoop();
+            if (_tx == null)
+            {
+                _log("[avtp-tx] PCAP TX not started: no TX device.");
+                return false;
+            }
+
+            var replay = new PcapReplayTransmitter(_tx.Device, _log);
+            var cts = new CancellationTokenSource();
+            var ct = cts.Token;
+            _replayCts = cts;
+            LastReplayStats = null;
+            _replayThread = new Thread(() =>
+            {
+                try
+                {
+                    var stats = replay.Run(cache, speed, loop ? 0 : 1, ct, pauseGate, s =>
+                    {
+                        LastReplayStats = s;
+                        _log($"[avtp-tx] PCAP pass {s.Passes}: {s}");
+                    });
+                    LastReplayStats = stats;
+                    onComplete?.Invoke(stats);
+                }
+                catch (OperationCanceledException) { }
+                catch (Exception ex)
+                {
+                    _log($"[avtp-tx] PCAP TX error: {ex.GetType().Name}: {ex.Message}");
+                }
+            })
+            {
+                Name = "PcapReplayTx",
+                IsBackground = true,
+                Priority = ThreadPriority.Highest,
+            };
+            _replayThread.Start();
+
+            string rate = double.IsPositiveInfinity(speed) ? "unpaced" : $"{speed:0.##}x";
+            _log($"[avtp-tx] PCAP TX started: {cache.Count} packets, {rate}, {(loop ? "loop" : "once")}");
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// Stops a PCAP replay started by <see cref="StartPcapReplay"/> and waits for it.
+    /// </summary>
+    public void StopPcapReplay()
+    {
+        lock (_replayLock)
+        {
+            var thread = _replayThread;
+            if (thread == null) return;
+            try { _replayCts?.Cancel(); } catch { }
+            thread.Join(2000);
+            try { _replayCts?.Dispose(); } catch { }
+            _replayCts = null;
+            _replayThread = null;
+            if (LastReplayStats != null)
+                _log($"[avtp-tx] PCAP TX stopped: {LastReplayStats}");
+        }
+    }
+
     /// <summary>
     /// Starts a background loop that sends BLACK frames at the specified FPS.
     /// Used when Player mode is stopped but we need to keep AVTP signal alive.
@@ -190,6 +279,7 @@ public sealed class AvtpTransmitManager : IDisposable
     /// </summary>
     public void Dispose()
     {
+        StopPcapReplay();
         StopBlackLoop();
         try { _tx?.Dispose(); } catch { }
         _tx = null;
@@ -1,15 +1,25 @@
 ﻿using System;
+using System.Collections.Concurrent;
 using System.IO;
+using System.Threading;
 
 namespace VilsSharpX
 {
     /// <summary>
     /// Simple file-based logging utility for AVTP diagnostic messages.
+    /// Messages are stamped when logged and appended by a background thread,
+    /// so a caller never waits for the file; per-frame timing belongs in
+    /// <see cref="TraceLog"/> instead.
     /// </summary>
     public static class DiagnosticLogger
     {
-        private static readonly object _logLock = new();
         private static readonly string _logPath = Path.Combine(AppContext.BaseDirectory, "diagnostic.log");
+        private static readonly ConcurrentQueue<string> _pending = new();
+        private static readonly AutoResetEvent _wake = new(false);
+        private static readonly object _startLock = new();
+        private static Thread? _writer;
+        private static long _logged;    // messages queued
+        private static long _handled;   // messages written (or lost to a file error)
 
         public static string LogPath => _logPath;
 
@@ -18,16 +28,64 @@ namespace VilsSharpX
         /// </summary>
         public static void Log(string message)
         {
-            try
+            _pending.Enqueue($"[{DateTime.Now:HH:mm:ss.fff}] {message}\r\n");
+            Interlocked.Increment(ref _logged);
+            if (_writer == null) StartWriter();
+            _wake.Set();
+        }
+
+        /// <summary>
+        /// Waits until messages logged so far are in the file (or <paramref name="timeoutMs"/> passes).
+        /// </summary>
+        public static void Flush(int timeoutMs = 1000)
+        {
+            long target = Interlocked.Read(ref _logged);
+            var deadline = Environment.TickCount64 + timeoutMs;
+            while (Interlocked.Read(ref _handled) < target && Environment.TickCount64 < deadline)
             {
-                lock (_logLock)
-                {
-                    File.AppendAllText(_logPath, $"[{DateTime.Now:HH:mm:ss.fff}] {message}\r\n");
-                }
+                _wake.Set();
+                Thread.Sleep(5);
             }
-            catch
+        }
+
+        private static void StartWriter()
+        {
+            lock (_startLock)
             {
-                // ignore logging errors
+                if (_writer != null) return;
+                _writer = new Thread(WriterLoop) { Name = "DiagnosticLogger", IsBackground = true };
+                _writer.Start();
+                AppDomain.CurrentDomain.ProcessExit += (_, _) => Flush();
+            }
+        }
+
+        private static void WriterLoop()
+        {
+            StreamWriter? file = null;
+            while (true)
+            {
+                _wake.WaitOne(500);
+                if (_pending.IsEmpty) continue;
+                try
+                {
+                    file ??= new StreamWriter(new FileStream(_logPath, FileMode.Append, FileAccess.Write, FileShare.ReadWrite));
+                    long n = 0;
+                    while (_pending.TryDequeue(out var line))
+                    {
+                        file.Write(line);
+                        n++;
+                    }
+                    file.Flush();
+                    Interlocked.Add(ref _handled, n);
+                }
+                catch
+                {
+                    // ignore logging errors (reopen on the next message)
+                    try { file?.Dispose(); } catch { }
+                    file = null;
+                    while (_pending.TryDequeue(out _)) { }
+                    Interlocked.Exchange(ref _handled, Interlocked.Read(ref _logged));
+                }
             }
         }
     }
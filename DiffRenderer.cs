@@ -1,9 +1,18 @@
 ﻿using System;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Threading;
+using System.Threading.Tasks;
 
 namespace VilsSharpX;
 
 /// <summary>
 /// Renders difference (comparison) between two grayscale frames to a color-coded BGR24 image.
+///
+/// <see cref="RenderCompareToBgr"/> computes the statistics <see cref="Vector{T}"/>-wide
+/// and takes colors from a table indexed by B−A, built from <see cref="ComparePixelToBgr"/>;
+/// frames of <see cref="ParallelMinPixels"/> or more are split into row bands across cores.
+/// <see cref="RenderCompareToBgrScalar"/> is the per-pixel reference it must match bit for bit.
 /// </summary>
 public static class DiffRenderer
 {
@@ -17,6 +26,121 @@ public static class DiffRenderer
     /// </summary>
     private const int VisualMax = 128;
 
+    /// <summary>
+    /// Frames with at least this many pixels are rendered in parallel row bands.
+    /// The LSM panels (≤ 320×84) stay on the calling thread.
+    /// </summary>
+    public const int ParallelMinPixels = 256 * 1024;
+
+    /// <summary>
+    /// Pixels per band below which another band costs more than it saves.
+    /// </summary>
+    private const int MinBandPixels = 64 * 1024;
+
+    /// <summary>
+    /// Vector blocks between flushes of the 16-bit accumulators:
+    /// each block adds up to 2 × 255 to a lane of the B−A sum.
+    /// </summary>
+    private const int FlushBlocks = 64;
+
+    /// <summary>
+    /// Colors for one (deadband, zeroZeroIsWhite) setting, BGR in the low three bytes.
+    /// A pixel's color depends only on B−A except for the cases
+    /// <see cref="ComparePixelToBgr"/> checks first, which have their own entries.
+    /// </summary>
+    private sealed class ColorTable
+    {
+        public readonly byte Deadband;
+        public readonly bool ZeroZeroIsWhite;
+        public readonly uint[] ByDiff = new uint[511];   // index B−A+255
+        public readonly uint Dark;                       // A>0, B=0
+        public readonly uint ZeroZero;                   // A=0, B=0
+        public readonly uint FullFull;                   // A=255, B=255
+
+        public ColorTable(byte deadband, bool zeroZeroIsWhite)
+        {
+            Deadband = deadband;
+            ZeroZeroIsWhite = zeroZeroIsWhite;
+            for (int d = -255; d <= 255; d++)
+            {
+                // Any pair with this difference that is not one of the special cases
+                // (only A=255, B=0 is left for -255, and it is always dark)
+                byte a, b;
+                if (d >= 0)
+                {
+                    a = (byte)(d == 255 ? 0 : 1);
+                    b = (byte)(a + d);
+                }
+                else
+                {
+                    b = (byte)(d == -255 ? 0 : 1);
+                    a = (byte)(b - d);
+                }
+                ByDiff[d + 255] = Color(a, b);
+            }
+            Dark = Color(1, 0);
+            ZeroZero = Color(0, 0);
+            FullFull = Color(255, 255);
+        }
+
+        private uint Color(byte a, byte b)
+        {
+            ComparePixelToBgr(a, b, Deadband, ZeroZeroIsWhite, out var bl, out var g, out var r);
+            return bl | (uint)g << 8 | (uint)r << 16;
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public uint Lookup(byte a, byte b)
+        {
+            if (b == 0)
+                return a > 0 ? Dark : ZeroZero;
+            if ((a & b) == 255)
+                return FullFull;
+            return ByDiff[b - a + 255];
+        }
+    }
+
+    private static ColorTable? _colors;
+
+    private static ColorTable GetColors(byte deadband, bool zeroZeroIsWhite)
+    {
+        // Rebuilt only when the settings change; a race just builds it twice
+        var t = Volatile.Read(ref _colors);
+        if (t == null || t.Deadband != deadband || t.ZeroZeroIsWhite != zeroZeroIsWhite)
+        {
+            t = new ColorTable(deadband, zeroZeroIsWhite);
+            Volatile.Write(ref _colors, t);
+        }
+        return t;
+    }
+
+    /// <summary>
+    /// Running statistics of one row band.
+    /// </summary>
+    private struct DiffStats
+    {
+        public long SumAbs;
+        public long SumDiff;
+        public int MaxAbs;
+        public int Above;
+        public int Dark;
+        public int MinD;
+        public int MaxD;
+
+        public static DiffStats Empty => new() { MinD = int.MaxValue, MaxD = int.MinValue };
+
+        public void Add(in DiffStats o)
+        {
+            SumAbs += o.SumAbs;
+            SumDiff += o.SumDiff;
+            if (o.MaxAbs > MaxAbs) MaxAbs = o.MaxAbs;
+            Above += o.Above;
+            Dark += o.Dark;
+            if (o.MinD < MinD) MinD = o.MinD;
+            if (o.MaxD > MaxD) MaxD = o.MaxD;
+        }
+    }
+
     /// <summary>
     /// Renders the comparison between two grayscale images to a BGR24 buffer.
     /// Green = within deadband, Yellow/Red = B > A, Turquoise/Blue/White = B &lt; A, Magenta = dark pixel.
@@ -40,6 +164,58 @@ public static class DiffRenderer
         out int minDiff, out int maxDiff, out double meanDiff,
         out int maxAbsDiff, out double meanAbsDiff, out int aboveDeadband,
         out int totalDarkPixels)
+    {
+        int n = w * h;
+        using var trace = TraceLog.Scope(TraceEvent.DiffRender, n);
+        if (n <= 0 || !Vector.IsHardwareAccelerated)
+        {
+            RenderCompareToBgrScalar(dstBgr, aGray, bGray, w, h, deadband, zeroZeroIsWhite,
+                out minDiff, out maxDiff, out meanDiff, out maxAbsDiff, out meanAbsDiff,
+                out aboveDeadband, out totalDarkPixels);
+            return;
+        }
+        if (aGray.Length < n || bGray.Length < n || dstBgr.Length < n * 3)
+            throw new ArgumentException("Buffers smaller than w*h pixels");
+
+        var colors = GetColors(deadband, zeroZeroIsWhite);
+        DiffStats st;
+        int bands = n >= ParallelMinPixels ? Math.Min(Environment.ProcessorCount, Math.Min(h, n / MinBandPixels)) : 1;
+        if (bands <= 1)
+        {
+            st = RenderBand(dstBgr, aGray, bGray, 0, n, colors);
+        }
+        else
+        {
+            var parts = new DiffStats[bands];
+            Parallel.For(0, bands, k =>
+            {
+                int r0 = (int)((long)h * k / bands);
+                int r1 = (int)((long)h * (k + 1) / bands);
+                parts[k] = RenderBand(dstBgr, aGray, bGray, r0 * w, r1 * w, colors);
+            });
+            st = parts[0];
+            for (int k = 1; k < bands; k++)
+                st.Add(parts[k]);
+        }
+
+        minDiff = st.MinD;
+        maxDiff = st.MaxD;
+        meanDiff = (double)st.SumDiff / n;
+        maxAbsDiff = st.MaxAbs;
+        meanAbsDiff = (double)st.SumAbs / n;
+        aboveDeadband = st.Above;
+        totalDarkPixels = st.Dark;
+    }
+
+    /// <summary>
+    /// Per-pixel reference implementation of <see cref="RenderCompareToBgr"/>, same
+    /// parameters and results.  Used where vectors are not hardware accelerated.
+    /// </summary>
+    public static void RenderCompareToBgrScalar(byte[] dstBgr, byte[] aGray, byte[] bGray, int w, int h, byte deadband,
+        bool zeroZeroIsWhite,
+        out int minDiff, out int maxDiff, out double meanDiff,
+        out int maxAbsDiff, out double meanAbsDiff, out int aboveDeadband,
+        out int totalDarkPixels)
     {
         long sumAbs = 0;
         long sumDiff = 0;
@@ -93,6 +269,135 @@ public static class DiffRenderer
         totalDarkPixels = dark;
     }
 
+    /// <summary>
+    /// Renders pixels [start, end) and returns their statistics.  Colors are written
+    /// four bytes at a time, so only the band's last pixel is stored byte by byte and
+    /// bands never write into each other.
+    /// </summary>
+    private static DiffStats RenderBand(byte[] dstBgr, byte[] aGray, byte[] bGray, int start, int end, ColorTable colors)
+    {
+        var st = DiffStats.Empty;
+        int vc = Vector<byte>.Count;
+        ref byte a0 = ref aGray[0];
+        ref byte b0 = ref bGray[0];
+        ref byte d0 = ref dstBgr[0];
+        uint[] byDiff = colors.ByDiff;
+
+        var vDeadband = new Vector<byte>(colors.Deadband);
+        var vFull = new Vector<byte>(255);
+        var vMinD = new Vector<short>(short.MaxValue);
+        var vMaxD = new Vector<short>(short.MinValue);
+        var vMaxAbs = Vector<byte>.Zero;
+        var vSumAbs = Vector<ushort>.Zero;
+        var vSumDiff = Vector<short>.Zero;
+        var vAbove = Vector<byte>.Zero;
+        var vDark = Vector<byte>.Zero;
+        int blocks = 0;
+
+        int i = start;
+        for (; i + vc < end; i += vc)
+        {
+            var va = Unsafe.ReadUnaligned<Vector<byte>>(ref Unsafe.Add(ref a0, i));
+            var vb = Unsafe.ReadUnaligned<Vector<byte>>(ref Unsafe.Add(ref b0, i));
+
+            var ad = Vector.Max(va, vb) - Vector.Min(va, vb);
+            vMaxAbs = Vector.Max(vMaxAbs, ad);
+            vAbove -= Vector.GreaterThan(ad, vDeadband);        // true lanes are 0xFF = -1
+            var bZero = Vector.Equals(vb, Vector<byte>.Zero);
+            vDark -= Vector.AndNot(bZero, Vector.Equals(va, Vector<byte>.Zero));
+
+            Vector.Widen(ad, out var adLo, out var adHi);
+            vSumAbs += adLo + adHi;
+            Vector.Widen(va, out var aLo, out var aHi);
+            Vector.Widen(vb, out var bLo, out var bHi);
+            var dLo = Vector.AsVectorInt16(bLo) - Vector.AsVectorInt16(aLo);
+            var dHi = Vector.AsVectorInt16(bHi) - Vector.AsVectorInt16(aHi);
+            vMinD = Vector.Min(vMinD, Vector.Min(dLo, dHi));
+            vMaxD = Vector.Max(vMaxD, Vector.Max(dLo, dHi));
+            vSumDiff += dLo + dHi;
+
+            if (++blocks == FlushBlocks)
+            {
+                Flush(ref st, ref vSumAbs, ref vSumDiff, ref vAbove, ref vDark);
+                blocks = 0;
+            }
+
+            ref byte dst = ref Unsafe.Add(ref d0, i * 3);
+            if (Vector.EqualsAll(bZero | Vector.Equals(va & vb, vFull), Vector<byte>.Zero))
+            {
+                // No special case in this block: B−A alone picks the color
+                for (int j = 0; j < vc; j++)
+                {
+                    int d = Unsafe.Add(ref b0, i + j) - Unsafe.Add(ref a0, i + j);
+                    Unsafe.WriteUnaligned(ref Unsafe.Add(ref dst, j * 3), byDiff[d + 255]);
+                }
+            }
+            else
+            {
+                for (int j = 0; j < vc; j++)
+                {
+                    uint c = colors.Lookup(Unsafe.Add(ref a0, i + j), Unsafe.Add(ref b0, i + j));
+                    Unsafe.WriteUnaligned(ref Unsafe.Add(ref dst, j * 3), c);
+                }
+            }
+        }
+        Flush(ref st, ref vSumAbs, ref vSumDiff, ref vAbove, ref vDark);
+        for (int j = 0; j < Vector<byte>.Count; j++)
+        {
+            if (vMaxAbs[j] > st.MaxAbs) st.MaxAbs = vMaxAbs[j];
+        }
+        if (i > start)
+        {
+            for (int j = 0; j < Vector<short>.Count; j++)
+            {
+                if (vMinD[j] < st.MinD) st.MinD = vMinD[j];
+                if (vMaxD[j] > st.MaxD) st.MaxD = vMaxD[j];
+            }
+        }
+
+        for (; i < end; i++)
+        {
+            byte a = aGray[i];
+            byte b = bGray[i];
+            int diff = b - a;
+            int ad = diff < 0 ? -diff : diff;
+            st.SumAbs += ad;
+            st.SumDiff += diff;
+            if (diff < st.MinD) st.MinD = diff;
+            if (diff > st.MaxD) st.MaxD = diff;
+            if (ad > st.MaxAbs) st.MaxAbs = ad;
+            if (ad > colors.Deadband) st.Above++;
+            if (a > 0 && b == 0) st.Dark++;
+
+            uint c = colors.Lookup(a, b);
+            int p = i * 3;
+            dstBgr[p] = (byte)c;
+            dstBgr[p + 1] = (byte)(c >> 8);
+            dstBgr[p + 2] = (byte)(c >> 16);
+        }
+        return st;
+    }
+
+    /// <summary>
+    /// Adds the narrow vector accumulators into <paramref name="st"/> and clears them.
+    /// </summary>
+    private static void Flush(ref DiffStats st, ref Vector<ushort> vSumAbs, ref Vector<short> vSumDiff,
+        ref Vector<byte> vAbove, ref Vector<byte> vDark)
+    {
+        Vector.Widen(vSumAbs, out var sa0, out var sa1);
+        st.SumAbs += Vector.Sum(sa0 + sa1);
+        Vector.Widen(vSumDiff, out var sd0, out var sd1);
+        st.SumDiff += Vector.Sum(sd0 + sd1);
+        Vector.Widen(vAbove, out var ab0, out var ab1);
+        st.Above += Vector.Sum(ab0 + ab1);
+        Vector.Widen(vDark, out var dk0, out var dk1);
+        st.Dark += Vector.Sum(dk0 + dk1);
+        vSumAbs = Vector<ushort>.Zero;
+        vSumDiff = Vector<short>.Zero;
+        vAbove = Vector<byte>.Zero;
+        vDark = Vector<byte>.Zero;
+    }
+
     /// <summary>
     /// Computes the BGR color for a single comparison pixel.
     /// </summary>
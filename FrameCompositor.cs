@@ -0,0 +1,303 @@
+using System;
+using System.Collections.Generic;
+using System.Threading;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// Composes the A / B / DIFF panes on a worker thread so the UI thread
+/// only copies finished buffers into its bitmaps.
+///
+/// <see cref="Submit"/> posts a frame pair to a latest-wins
+/// <see cref="FrameMailbox{T}"/>: when composition or display falls behind,
+/// older pairs are replaced instead of queued, so capture and analysis keep
+/// their full rate and the display shows the newest frame it can.  The
+/// worker copies A and B and renders the diff with
+/// <see cref="DiffRenderer.RenderCompareToBgr"/> into pre-allocated buffers,
+/// triple-buffered: one being composed, one ready, one shown.
+/// <see cref="TryAcquire"/> (UI thread, once per display frame) swaps in
+/// the ready one.  Steady state allocates nothing.
+///
+/// Frames submitted with the record flag are not dropped: they wait in a
+/// short FIFO, are all composed in order and go to <see cref="Recorder"/>
+/// whether or not the display ever shows them.
+/// </summary>
+public sealed class FrameCompositor : IDisposable
+{
+    /// <summary>
+    /// A composed frame.  Owned by the caller of <see cref="TryAcquire"/>
+    /// until its next call; do not keep references to the buffers.
+    /// </summary>
+    public sealed class Output
+    {
+        public int Width { get; private set; }
+        public int Height { get; private set; }
+        public byte[] A { get; private set; } = Array.Empty<byte>();
+        public byte[] B { get; private set; } = Array.Empty<byte>();
+        public byte[] DiffBgr { get; private set; } = Array.Empty<byte>();
+
+        /// <summary>Number of the <see cref="Submit"/> call this frame came from (1-based).</summary>
+        public long Sequence { get; internal set; }
+
+        public int MinDiff { get; internal set; }
+        public int MaxDiff { get; internal set; }
+        public double MeanAbsDiff { get; internal set; }
+        public int AboveDeadband { get; internal set; }
+        public int TotalDarkPixels { get; internal set; }
+
+        internal int Generation;
+
+        internal void EnsureSize(int w, int h)
+        {
+            if (Width == w && Height == h) return;
+            Width = w;
+            Height = h;
+            A = new byte[w * h];
+            B = new byte[w * h];
+            DiffBgr = new byte[w * h * 3];
+        }
+    }
+
+    private sealed class Request
+    {
+        public byte[] A = Array.Empty<byte>();
+        public byte[] B = Array.Empty<byte>();
+        public int Width, Height;
+        public byte Deadband;
+        public bool ZeroZeroIsWhite;
+        public bool Record;
+        public int Generation;
+        public long Sequence;
+    }
+
+    /// <summary>Recorded frames that may wait for the worker before more are dropped.</summary>
+    public const int MaxPendingRecords = 8;
+
+    private readonly FrameMailbox<Request> _input = new();
+
+    // Requests are reused: a free list, and a ring of record requests (under _records)
+    private readonly Stack<Request> _free = new();
+    private readonly Request?[] _records = new Request?[MaxPendingRecords];
+    private int _recordHead, _recordCount;
+    private readonly AutoResetEvent _wake = new(false);
+    private readonly Thread _thread;
+    private volatile bool _stop;
+
+    // Triple buffer: _back is the worker's, _front the consumer's; _ready is swapped under _swapLock
+    private readonly object _swapLock = new();
+    private Output _back = new();
+    private Output _ready = new();
+    private Output _front = new();
+    private bool _readyFresh;
+
+    private int _generation;
+    private long _submitted;
+    private long _composed;
+    private long _presented;
+    private long _recorded;
+    private long _recordsDropped;
+    private long _lastComposed;
+
+    public FrameCompositor()
+    {
+        _thread = new Thread(WorkerLoop)
+        {
+            Name = "FrameCompositor",
+            IsBackground = true,
+        };
+        _thread.Start();
+    }
+
+    /// <summary>Frame pairs submitted.</summary>
+    public long Submitted => Interlocked.Read(ref _submitted);
+
+    /// <summary>Frame pairs composed (the rest were replaced by newer ones first).</summary>
+    public long Composed => Interlocked.Read(ref _composed);
+
+    /// <summary>Composed frames handed out by <see cref="TryAcquire"/>.</summary>
+    public long Presented => Interlocked.Read(ref _presented);
+
+    /// <summary>Frames passed to <see cref="Recorder"/>.</summary>
+    public long Recorded => Interlocked.Read(ref _recorded);
+
+    /// <summary>Record submits that found <see cref="MaxPendingRecords"/> waiting (shown only, if at all).</summary>
+    public long RecordsDropped => Interlocked.Read(ref _recordsDropped);
+
+    /// <summary>
+    /// Called on the worker thread, in submit order, for every frame
+    /// submitted with record set: the submitted A and B arrays and a new
+    /// Bgr24 diff array the callee may keep.
+    /// </summary>
+    public Action<byte[], byte[], byte[]>? Recorder { get; set; }
+
+    /// <summary>
+    /// Compose <paramref name="a"/> and <paramref name="b"/> (Gray8,
+    /// <paramref name="w"/> × <paramref name="h"/>) with their diff.  The
+    /// arrays are read on the worker thread and must not be changed afterwards.
+    /// With <paramref name="record"/> the pair also goes to <see cref="Recorder"/>.
+    /// </summary>
+    public void Submit(byte[] a, byte[] b, int w, int h, byte deadband, bool zeroZeroIsWhite, bool record = false)
+    {
+        if (a.Length < w * h || b.Length < w * h)
+            throw new ArgumentException($"Frame smaller than {w}×{h}");
+        var req = RentRequest();
+        req.A = a;
+        req.B = b;
+        req.Width = w;
+        req.Height = h;
+        req.Deadband = deadband;
+        req.ZeroZeroIsWhite = zeroZeroIsWhite;
+        req.Record = record && Recorder != null;
+        req.Generation = Volatile.Read(ref _generation);
+        req.Sequence = Interlocked.Increment(ref _submitted);
+
+        if (!req.Record || !TryQueueRecord(req))
+        {
+            if (req.Record) Interlocked.Increment(ref _recordsDropped);
+            req.Record = false;
+            if (_input.Post(req) is { } replaced)
+                ReturnRequest(replaced);
+        }
+        _wake.Set();
+    }
+
+    /// <summary>
+    /// Drop everything submitted so far: frames not yet shown are never
+    /// returned by <see cref="TryAcquire"/> (e.g. after the panes were
+    /// cleared to "no signal").
+    /// </summary>
+    public void Invalidate()
+    {
+        Interlocked.Increment(ref _generation);
+        if (_input.Take() is { } req)
+            ReturnRequest(req);
+    }
+
+    /// <summary>
+    /// The newest composed frame not handed out yet, or null.  Call from one
+    /// thread (the UI thread); the previous frame returned is reused.
+    /// </summary>
+    public Output? TryAcquire()
+    {
+        lock (_swapLock)
+        {
+            if (!_readyFresh) return null;
+            (_front, _ready) = (_ready, _front);
+            _readyFresh = false;
+        }
+        if (_front.Generation != Volatile.Read(ref _generation)) return null;
+        Interlocked.Increment(ref _presented);
+        return _front;
+    }
+
+    private void WorkerLoop()
+    {
+        while (!_stop)
+        {
+            _wake.WaitOne();
+            while (!_stop && (TryTakeRecord() ?? _input.Take()) is { } req)
+            {
+                // Records are in order and all kept; a shown-only frame older
+                // than a record already composed would step the display back
+                bool stale = req.Generation != Volatile.Read(ref _generation);
+                if (req.Record || (!stale && req.Sequence > _lastComposed))
+                {
+                    Compose(req, _back);
+                    _lastComposed = req.Sequence;
+                    if (req.Record)
+                        Record(req, _back);
+                    if (!stale)
+                        Publish();
+                }
+                ReturnRequest(req);
+            }
+        }
+    }
+
+    private void Publish()
+    {
+        lock (_swapLock)
+        {
+            (_back, _ready) = (_ready, _back);
+            _readyFresh = true;
+        }
+        Interlocked.Increment(ref _composed);
+    }
+
+    private void Record(Request req, Output composed)
+    {
+        var recorder = Recorder;
+        if (recorder == null) return;
+        var d = new byte[composed.DiffBgr.Length];   // the recorder keeps it
+        Buffer.BlockCopy(composed.DiffBgr, 0, d, 0, d.Length);
+        recorder(req.A, req.B, d);
+        Interlocked.Increment(ref _recorded);
+    }
+
+    private Request RentRequest()
+    {
+        lock (_free)
+            return _free.Count > 0 ? _free.Pop() : new Request();
+    }
+
+    private void ReturnRequest(Request req)
+    {
+        req.A = req.B = Array.Empty<byte>();   // do not keep the caller's frames alive
+        lock (_free)
+            _free.Push(req);
+    }
+
+    private bool TryQueueRecord(Request req)
+    {
+        lock (_records)
+        {
+            if (_recordCount == MaxPendingRecords) return false;
+            _records[(_recordHead + _recordCount++) % MaxPendingRecords] = req;
+            return true;
+        }
+    }
+
+    private Request? TryTakeRecord()
+    {
+        lock (_records)
+        {
+            if (_recordCount == 0) return null;
+            var req = _records[_recordHead]!;
+            _records[_recordHead] = null;
+            _recordHead = (_recordHead + 1) % MaxPendingRecords;
+            _recordCount--;
+            return req;
+        }
+    }
+
+    private static void Compose(Request req, Output dst)
+    {
+        using var trace = TraceLog.Scope(TraceEvent.Compose, req.Sequence);
+        int n = req.Width * req.Height;
+        dst.EnsureSize(req.Width, req.Height);
+        req.A.AsSpan(0, n).CopyTo(dst.A);
+        req.B.AsSpan(0, n).CopyTo(dst.B);
+        DiffRenderer.RenderCompareToBgr(dst.DiffBgr, dst.A, dst.B, req.Width, req.Height, req.Deadband,
+            req.ZeroZeroIsWhite,
+            out var minDiff, out var maxDiff, out _,
+            out _, out var meanAbsDiff, out var aboveDeadband,
+            out var totalDarkPixels);
+        dst.MinDiff = minDiff;
+        dst.MaxDiff = maxDiff;
+        dst.MeanAbsDiff = meanAbsDiff;
+        dst.AboveDeadband = aboveDeadband;
+        dst.TotalDarkPixels = totalDarkPixels;
+        dst.Sequence = req.Sequence;
+        dst.Generation = req.Generation;
+    }
+
+    public void Dispose()
+    {
+        if (_stop) return;
+        _stop = true;
+        _wake.Set();
+        // A worker still composing (or recording) after the timeout may yet touch _wake
+        if (_thread.Join(1000))
+            _wake.Dispose();
+    }
+}
@@ -0,0 +1,40 @@
+using System.Threading;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// Single-slot, latest-wins hand-off between a producer running at source
+/// rate and a consumer running at display rate.  <see cref="Post"/> replaces
+/// whatever the consumer has not taken yet, so a slow consumer always sees
+/// the newest item and never builds a backlog.  Lock-free; any number of
+/// threads may post and take.
+/// </summary>
+public sealed class FrameMailbox<T> where T : class
+{
+    private T? _slot;
+    private long _posted;
+    private long _replaced;
+
+    /// <summary>Items posted since construction.</summary>
+    public long Posted => Interlocked.Read(ref _posted);
+
+    /// <summary>Items replaced by a newer one before they were taken.</summary>
+    public long Replaced => Interlocked.Read(ref _replaced);
+
+    public bool IsEmpty => Volatile.Read(ref _slot) == null;
+
+    /// <summary>Store <paramref name="item"/>; returns the item it replaced, if any.</summary>
+    public T? Post(T item)
+    {
+        var old = Interlocked.Exchange(ref _slot, item);
+        Interlocked.Increment(ref _posted);
+        if (old != null) Interlocked.Increment(ref _replaced);
+        return old;
+    }
+
+    /// <summary>Take the newest item, leaving the slot empty; null if nothing was posted since.</summary>
+    public T? Take() => Interlocked.Exchange(ref _slot, null);
+
+    /// <summary>Drop the item waiting, if any.</summary>
+    public void Clear() => Interlocked.Exchange(ref _slot, null);
+}
@@ -22,6 +22,8 @@ namespace VilsSharpX
 
     private AvtpLiveCapture? _avtpLive;
     private CancellationTokenSource? _pcapCts;
+    private readonly object _pcapCacheLock = new();
+    private PcapPacketCache? _pcapCache;
 
     private int _activeFeed = (int)Feed.None;
 
@@ -176,9 +178,30 @@ namespace VilsSharpX
         }
 
         /// <summary>
-        /// Start PCAP replay.
+        /// The packets of PCAP <paramref name="path"/>, read once and kept for
+        /// replays of the same (unchanged) file.
         /// </summary>
-        public void StartPcapReplay(string path, ManualResetEventSlim pauseGate, Action? onComplete = null, Action<string>? onError = null)
+        public PcapPacketCache LoadPcap(string path)
+        {
+            lock (_pcapCacheLock)
+            {
+                if (_pcapCache == null || !_pcapCache.IsCurrent(path))
+                {
+                    _pcapCache = null;   // let the old capture go before reading the new one
+                    _pcapCache = PcapAvtpRvfReplay.Load(path, _log);
+                }
+                return _pcapCache;
+            }
+        }
+
+        /// <summary>
+        /// Start PCAP replay at <paramref name="speed"/> × the recorded timing.
+        /// The file is read on the first replay only (<see cref="LoadPcap"/>);
+        /// <paramref name="onLoaded"/> runs on the replay task once the packets
+        /// are in memory, right before the replay starts.
+        /// </summary>
+        public void StartPcapReplay(string path, ManualResetEventSlim pauseGate, Action? onComplete = null, Action<string>? onError = null,
+            double speed = 1.0, Action<PcapPacketCache>? onLoaded = null)
         {
             StopPcapReplay();
 
@@ -195,8 +218,12 @@ namespace VilsSharpX
             {
                 try
                 {
+                    var cache = LoadPcap(path);
+                    ct.ThrowIfCancellationRequested();
+                    onLoaded?.Invoke(cache);
+
                     await PcapAvtpRvfReplay.ReplayAsync(
-                        path,
+                        cache,
                         chunk =>
                         {
                             if (IsLiveInputSuppressed()) return;
@@ -205,7 +232,7 @@ namespace VilsSharpX
                         },
                         _log,
                         ct,
-                        speed: 1.0,
+                        speed: speed,
                         pauseGate: pauseGate);
 
                     if (!ct.IsCancellationRequested)
@@ -0,0 +1,176 @@
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// Captures from several Pico 2 bridges at once, one per LSM on the rig.
+///
+/// Bridges are told apart by their USB serial number (the firmware reports
+/// the RP2350 chip ID).  Each one gets its own <see cref="LvdsLiveManager"/>
+/// on the USB vendor interface, and with it its own read thread with queued
+/// bulk transfers, receiver, frame pool, FPS and capture file.  Nothing is
+/// shared on the data path, so a bridge that stalls or is unplugged does
+/// not hold up the others.
+///
+/// Events are raised on the read thread of the bridge they come from, with
+/// its serial number; handlers must not block it for long.
+/// </summary>
+public sealed class LvdsBridgeManager : IDisposable
+{
+    private readonly object _lock = new();
+    private readonly Dictionary<string, LvdsLiveManager> _bridges = new(StringComparer.Ordinal);
+    private readonly Action<string> _log;
+    private readonly double _signalLostTimeoutSec;
+    private LsmDeviceType _deviceType;
+
+    /// <summary>
+    /// A complete frame from bridge (serial).  The lease is released when the
+    /// handlers return; see <see cref="LvdsLiveManager.OnFrameLeased"/>.
+    /// </summary>
+    public event Action<string, LvdsFrameLease>? OnFrameLeased;
+
+    /// <summary>A firmware telemetry packet from bridge (serial).</summary>
+    public event Action<string, LvdsFirmwareTelemetry>? OnTelemetry;
+
+    public LvdsBridgeManager(LsmDeviceType deviceType, double signalLostTimeoutSec, Action<string> log)
+    {
+        _deviceType = deviceType;
+        _signalLostTimeoutSec = signalLostTimeoutSec;
+        _log = log ?? (_ => { });
+    }
+
+    /// <summary>Device type used for bridges started without one.</summary>
+    public LsmDeviceType DefaultDeviceType
+    {
+        get => _deviceType;
+        set => _deviceType = value;
+    }
+
+    /// <summary>Serial numbers of the bridges attached, open or not.</summary>
+    public static string[] ListBridges() => PicoUsbVendor.ListSerialNumbers();
+
+    /// <summary>Serial numbers of the bridges capturing, in order.</summary>
+    public string[] SerialNumbers
+    {
+        get
+        {
+            lock (_lock)
+            {
+                var serials = new string[_bridges.Count];
+                _bridges.Keys.CopyTo(serials, 0);
+                Array.Sort(serials, StringComparer.Ordinal);
+                return serials;
+            }
+        }
+    }
+
+    public int Count
+    {
+        get { lock (_lock) return _bridges.Count; }
+    }
+
+    /// <summary>Manager of bridge <paramref name="serialNumber"/>, null if it is not open.</summary>
+    public LvdsLiveManager? Get(string serialNumber)
+    {
+        lock (_lock)
+            return _bridges.TryGetValue(serialNumber, out var manager) ? manager : null;
+    }
+
+    /// <summary>
+    /// Start capturing from bridge <paramref name="serialNumber"/>, as
+    /// <paramref name="deviceType"/> (<see cref="DefaultDeviceType"/> when null).
+    /// A bridge already capturing is restarted.
+    /// </summary>
+    public LvdsLiveManager Start(string serialNumber, LsmDeviceType? deviceType = null)
+    {
+        Stop(serialNumber);
+
+        var type = deviceType ?? _deviceType;
+        var manager = new LvdsLiveManager(type, _signalLostTimeoutSec, msg => _log($"[{serialNumber}] {msg}"));
+        manager.OnFrameLeased += lease => OnFrameLeased?.Invoke(serialNumber, lease);
+        manager.OnTelemetry += t => OnTelemetry?.Invoke(serialNumber, t);
+        try
+        {
+            manager.StartCapture(LvdsUartCapture.UsbPortPrefix + serialNumber);
+        }
+        catch
+        {
+            manager.Dispose();
+            throw;
+        }
+
+        lock (_lock)
+            _bridges[serialNumber] = manager;
+        return manager;
+    }
+
+    /// <summary>
+    /// Start every attached bridge that is not capturing yet (also picks up
+    /// bridges plugged in since the last call).  Bridges that fail to open
+    /// are logged and skipped.  Returns the number started.
+    /// </summary>
+    public int StartAll()
+    {
+        int started = 0;
+        foreach (var serial in ListBridges())
+        {
+            if (Get(serial) != null) continue;
+            try
+            {
+                Start(serial);
+                started++;
+            }
+            catch (Exception ex)
+            {
+                _log($"[lvds-bridges] {serial}: {ex.Message}");
+            }
+        }
+        _log($"[lvds-bridges] {started} bridge(s) started, {Count} capturing");
+        return started;
+    }
+
+    public void Stop(string serialNumber)
+    {
+        LvdsLiveManager? manager;
+        lock (_lock)
+        {
+            if (!_bridges.Remove(serialNumber, out manager)) return;
+        }
+        manager.Dispose();
+    }
+
+    public void StopAll()
+    {
+        LvdsLiveManager[] managers;
+        lock (_lock)
+        {
+            managers = new LvdsLiveManager[_bridges.Count];
+            _bridges.Values.CopyTo(managers, 0);
+            _bridges.Clear();
+        }
+        foreach (var manager in managers)
+            manager.Dispose();
+    }
+
+    /// <summary>One <see cref="LvdsLiveManager.GetDiagnostics"/> line per bridge.</summary>
+    public string GetDiagnostics()
+    {
+        var sb = new StringBuilder();
+        foreach (var serial in SerialNumbers)
+        {
+            var manager = Get(serial);
+            if (manager == null) continue;
+            if (sb.Length > 0) sb.AppendLine();
+            sb.Append(manager.GetDiagnostics());
+            if (manager.IsSignalLost()) sb.Append(" (signal lost)");
+        }
+        return sb.Length > 0 ? sb.ToString() : "LVDS bridges: none";
+    }
+
+    public void Dispose()
+    {
+        StopAll();
+    }
+}
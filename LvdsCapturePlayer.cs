@@ -0,0 +1,221 @@
+using System;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// Plays an LVDS capture file (*.lvdscap) as a file source, the way
+/// <see cref="AviSourcePlayer"/> plays an AVI: frames follow the recorded
+/// host timestamps, so playback keeps the capture's real timing (gaps,
+/// skipped frames) instead of a fixed frame rate.  Frames are looked up
+/// by time in the file index; only the frame shown is read.
+///
+/// The generator thread reads frames while the UI thread loads, seeks and
+/// closes; every access to the reader holds <c>_lock</c>, so a close never
+/// unmaps the file under a frame being read.
+/// </summary>
+public sealed class LvdsCapturePlayer : IDisposable
+{
+    private readonly int _targetWidth;
+    private readonly int _targetHeight;
+    private readonly object _lock = new();
+
+    private LvdsCaptureReader? _capture;
+    private int _index;
+    private byte[]? _currentFrame;
+    private bool _atEnd;
+
+    // Playback clock: capture time _originHostUs is shown at _originUtc
+    private DateTime _originUtc;
+    private long _originHostUs;
+    private bool _clockValid;
+
+    public LvdsCapturePlayer(int targetWidth, int targetHeight)
+    {
+        _targetWidth = targetWidth;
+        _targetHeight = targetHeight;
+    }
+
+    public bool IsLoaded => _capture != null;
+    public string? Path => _capture?.Path;
+    public int CurrentIndex => _index;
+    public int FrameCount => _capture?.FrameCount ?? 0;
+    public bool LoopEnabled { get; set; }
+    public byte[]? CurrentFrame => _currentFrame;
+
+    /// <summary>
+    /// Capture open for direct (span) access, e.g. for analysis; valid
+    /// until the next <see cref="Load"/> or <see cref="Close"/>.
+    /// </summary>
+    public LvdsCaptureReader? Capture => _capture;
+
+    /// <summary>Mean frame rate of the recording.</summary>
+    public double SourceFps => _capture?.AverageFps ?? 0;
+
+    /// <summary>Meta of the frame shown.</summary>
+    public LvdsFrameMeta? CurrentMeta
+    {
+        get { lock (_lock) return _capture != null && _capture.FrameCount > 0 ? _capture.GetMeta(_index) : null; }
+    }
+
+    /// <summary>True when the last frame is shown and looping is disabled.</summary>
+    public bool IsAtEnd => !LoopEnabled && _capture != null && _capture.FrameCount > 0 && _atEnd;
+
+    public void Load(string path)
+    {
+        lock (_lock)
+        {
+            Close();
+            _capture = LvdsCaptureReader.Open(path);
+            Seek(0);
+        }
+    }
+
+    public void Close()
+    {
+        lock (_lock)
+        {
+            try { _capture?.Dispose(); } catch { }
+            _capture = null;
+            _index = 0;
+            _currentFrame = null;
+            _atEnd = false;
+            _clockValid = false;
+        }
+    }
+
+    public void Reset()
+    {
+        lock (_lock)
+        {
+            if (_capture == null) return;
+            Seek(0);
+        }
+    }
+
+    /// <summary>Show frame <paramref name="index"/>; playback continues from there.</summary>
+    public void Seek(int index)
+    {
+        lock (_lock) SeekLocked(index);
+    }
+
+    private void SeekLocked(int index)
+    {
+        if (_capture == null || _capture.FrameCount == 0) return;
+        _index = Math.Clamp(index, 0, _capture.FrameCount - 1);
+        _currentFrame = ReadFrame(_index);
+        _atEnd = _index >= _capture.FrameCount - 1;
+        _clockValid = false;
+    }
+
+    /// <summary>
+    /// Steps to next/previous frame manually.
+    /// </summary>
+    /// <returns>Status message for display.</returns>
+    public string Step(int dir)
+    {
+        lock (_lock) return StepLocked(dir);
+    }
+
+    private string StepLocked(int dir)
+    {
+        if (_capture == null)
+            return "LVDS capture: no file loaded.";
+
+        int n = _capture.FrameCount;
+        if (n <= 0)
+            return "LVDS capture: no frames.";
+
+        int next = _index + (dir < 0 ? -1 : 1);
+        if (LoopEnabled)
+        {
+            next %= n;
+            if (next < 0) next += n;
+        }
+        SeekLocked(next);
+
+        var meta = _capture.GetMeta(_index);
+        double t = (_capture.FrameHostUs(_index) - _capture.FrameHostUs(0)) / 1e6;
+        string name = System.IO.Path.GetFileName(_capture.Path);
+        return $"LVDS capture '{name}': frame {_index + 1}/{n} at {t:F3} s (fw #{meta.FirmwareFrameId}, " +
+               $"lines {meta.ValidLines}/{meta.LinesExpected}, loop={(LoopEnabled ? "ON" : "OFF")}).";
+    }
+
+    /// <summary>
+    /// Gets the current frame bytes, moving to the frame recorded at the
+    /// current playback time.
+    /// </summary>
+    public byte[]? GetBytesAndUpdateIfNeeded(DateTime nowUtc, bool isPaused)
+    {
+        lock (_lock) return GetBytesLocked(nowUtc, isPaused);
+    }
+
+    private byte[]? GetBytesLocked(DateTime nowUtc, bool isPaused)
+    {
+        var cap = _capture;
+        if (cap == null || cap.FrameCount == 0) return null;
+
+        // Paused or stepped: restart the clock at the frame shown when playback resumes
+        if (isPaused || !_clockValid)
+        {
+            _originUtc = nowUtc;
+            _originHostUs = cap.FrameHostUs(_index);
+            _clockValid = !isPaused;
+            return _currentFrame;
+        }
+
+        long targetUs = _originHostUs + (long)((nowUtc - _originUtc).TotalMilliseconds * 1000);
+        long lastUs = cap.FrameHostUs(cap.FrameCount - 1);
+        if (targetUs > lastUs && LoopEnabled && cap.FrameCount > 1)
+        {
+            // Next pass starts one mean frame interval after the last frame
+            long periodUs = (long)(1e6 / Math.Max(1.0, cap.AverageFps));
+            long passUs = lastUs - cap.FrameHostUs(0) + periodUs;
+            targetUs = cap.FrameHostUs(0) + (targetUs - cap.FrameHostUs(0)) % passUs;
+            _originHostUs = targetUs;
+            _originUtc = nowUtc;
+        }
+
+        int next = cap.FindFrame(targetUs);
+        if (next != _index)
+        {
+            _index = next;
+            _currentFrame = ReadFrame(next);
+        }
+        _atEnd = targetUs >= lastUs;
+        return _currentFrame;
+    }
+
+    /// <summary>Frame <paramref name="index"/> cropped / padded to the target size (top-left aligned).</summary>
+    private byte[] ReadFrame(int index)
+    {
+        var cap = _capture!;
+        var meta = cap.GetMeta(index);
+        var src = cap.GetPixels(index);
+        var dst = new byte[_targetWidth * _targetHeight];
+
+        int w = Math.Min(meta.Width, _targetWidth);
+        int h = meta.Width > 0 ? Math.Min(Math.Min(meta.Height, _targetHeight), src.Length / meta.Width) : 0;
+        for (int y = 0; y < h; y++)
+            src.Slice(y * meta.Width, w).CopyTo(dst.AsSpan(y * _targetWidth));
+        return dst;
+    }
+
+    public string BuildStatusMessage()
+    {
+        lock (_lock) return BuildStatusLocked();
+    }
+
+    private string BuildStatusLocked()
+    {
+        if (_capture == null) return "LVDS capture: no file loaded.";
+        string name = System.IO.Path.GetFileName(_capture.Path);
+        string state = _capture.IsComplete ? "" : ", not closed: recovered";
+        return $"LVDS capture loaded: '{name}' (frames={_capture.FrameCount}, telemetry={_capture.TelemetryCount}, " +
+               $"{_capture.Duration.TotalSeconds:F1} s, {_capture.AverageFps:F1} fps{state}). Press Start to play; Prev/Next steps frames.";
+    }
+
+    public void Dispose()
+    {
+        Close();
+    }
+}
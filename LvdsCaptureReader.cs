@@ -0,0 +1,230 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// Random access to a capture file written by <see cref="LvdsCaptureWriter"/>.
+///
+/// The file is memory-mapped: opening reads only the index, and a frame's
+/// pixels are a span straight into the mapping, so seeking, scrubbing and
+/// batch analysis touch only the pages of the frames they look at.
+/// Spans returned here are valid until <see cref="Dispose"/>; reading after
+/// it throws <see cref="ObjectDisposedException"/>.  A file that was not
+/// closed by its writer (no index) is opened by walking its records;
+/// <see cref="IsComplete"/> is false then.
+/// Concurrent reads are fine; Dispose must not race a read (the owner
+/// serialises them, see <see cref="LvdsCapturePlayer"/>).
+/// </summary>
+public sealed unsafe class LvdsCaptureReader : IDisposable
+{
+    private readonly MemoryMappedFile _mmf;
+    private readonly MemoryMappedViewAccessor _view;
+    private readonly byte* _base;
+    private readonly long _length;
+    private bool _disposed;
+
+    private readonly LvdsCaptureFormat.IndexEntry[] _frames;
+    private readonly LvdsCaptureFormat.IndexEntry[] _telemetry;
+
+    public string Path { get; }
+    public int FrameCount => _frames.Length;
+    public int TelemetryCount => _telemetry.Length;
+
+    /// <summary>File was closed by its writer and carries a frame index.</summary>
+    public bool IsComplete { get; }
+
+    /// <summary>Wall-clock time the recording started.</summary>
+    public DateTime StartUtc { get; }
+
+    /// <summary>Host Stopwatch time (µs) taken together with <see cref="StartUtc"/>.</summary>
+    public long StartHostUs { get; }
+
+    /// <summary>Time from the first to the last frame.</summary>
+    public TimeSpan Duration => _frames.Length < 2 ? TimeSpan.Zero
+        : TimeSpan.FromTicks((_frames[^1].HostUs - _frames[0].HostUs) * 10);
+
+    /// <summary>Mean frame rate of the recording (0 below two frames).</summary>
+    public double AverageFps => Duration.TotalSeconds > 0 ? (_frames.Length - 1) / Duration.TotalSeconds : 0;
+
+    private LvdsCaptureReader(string path, MemoryMappedFile mmf, MemoryMappedViewAccessor view, byte* basePtr, long length)
+    {
+        Path = path;
+        _mmf = mmf;
+        _view = view;
+        _base = basePtr;
+        _length = length;
+
+        var header = Span(0, LvdsCaptureFormat.HeaderSize);
+        if (!header.Slice(0, 8).SequenceEqual(LvdsCaptureFormat.Magic))
+            throw new InvalidDataException("Not an LVDS capture file");
+        int version = BinaryPrimitives.ReadUInt16LittleEndian(header.Slice(8));
+        if (version != LvdsCaptureFormat.Version)
+            throw new InvalidDataException($"Unsupported LVDS capture version {version}");
+
+        StartUtc = new DateTime(BinaryPrimitives.ReadInt64LittleEndian(header.Slice(32)), DateTimeKind.Utc);
+        StartHostUs = BinaryPrimitives.ReadInt64LittleEndian(header.Slice(40));
+
+        uint flags = BinaryPrimitives.ReadUInt32LittleEndian(header.Slice(12));
+        long indexOffset = BinaryPrimitives.ReadInt64LittleEndian(header.Slice(16));
+        int frameCount = BinaryPrimitives.ReadInt32LittleEndian(header.Slice(24));
+        int telemetryCount = BinaryPrimitives.ReadInt32LittleEndian(header.Slice(28));
+
+        long indexBytes = ((long)frameCount + telemetryCount) * LvdsCaptureFormat.IndexEntrySize;
+        if ((flags & LvdsCaptureFormat.FlagIndexed) != 0 && frameCount >= 0 && telemetryCount >= 0 &&
+            indexOffset >= LvdsCaptureFormat.HeaderSize && indexOffset + indexBytes <= _length)
+        {
+            _frames = ReadIndex(indexOffset, frameCount);
+            _telemetry = ReadIndex(indexOffset + (long)frameCount * LvdsCaptureFormat.IndexEntrySize, telemetryCount);
+            IsComplete = true;
+        }
+        else
+        {
+            (_frames, _telemetry) = ScanRecords();
+        }
+    }
+
+    public static LvdsCaptureReader Open(string path)
+    {
+        var fs = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite);
+        long length = fs.Length;
+        if (length < LvdsCaptureFormat.HeaderSize)
+        {
+            fs.Dispose();
+            throw new InvalidDataException("File too short for an LVDS capture");
+        }
+
+        MemoryMappedFile? mmf = null;
+        MemoryMappedViewAccessor? view = null;
+        bool pointerHeld = false;
+        try
+        {
+            mmf = MemoryMappedFile.CreateFromFile(fs, null, 0, MemoryMappedFileAccess.Read,
+                HandleInheritability.None, leaveOpen: false);
+            view = mmf.CreateViewAccessor(0, length, MemoryMappedFileAccess.Read);
+            byte* p = null;
+            view.SafeMemoryMappedViewHandle.AcquirePointer(ref p);
+            pointerHeld = true;
+            return new LvdsCaptureReader(path, mmf, view, p + view.PointerOffset, length);
+        }
+        catch
+        {
+            if (pointerHeld) view!.SafeMemoryMappedViewHandle.ReleasePointer();
+            view?.Dispose();
+            if (mmf != null) mmf.Dispose(); else fs.Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>Host Stopwatch time (µs) the frame was received.</summary>
+    public long FrameHostUs(int index) => _frames[index].HostUs;
+
+    /// <summary>Pixels of frame <paramref name="index"/> (Width × Height of its meta), without copying.</summary>
+    public ReadOnlySpan<byte> GetPixels(int index)
+        => Body(_frames[index], LvdsCaptureFormat.TagFrame).Slice(LvdsCaptureFormat.FrameMetaSize);
+
+    public LvdsFrameMeta GetMeta(int index)
+    {
+        var entry = _frames[index];
+        return LvdsCaptureFormat.ReadFrameMeta(Body(entry, LvdsCaptureFormat.TagFrame), entry.HostUs);
+    }
+
+    /// <summary>Last frame received at or before <paramref name="hostUs"/> (0 if before the first).</summary>
+    public int FindFrame(long hostUs) => Math.Max(0, FindLast(_frames, hostUs));
+
+    public long TelemetryHostUs(int index) => _telemetry[index].HostUs;
+
+    /// <summary>Telemetry packet <paramref name="index"/>, parsed; null if its version is unknown.</summary>
+    public LvdsFirmwareTelemetry? GetTelemetry(int index)
+    {
+        var body = Body(_telemetry[index], LvdsCaptureFormat.TagTelemetry);
+        return LvdsFirmwareTelemetry.TryParse(body[0], body.Slice(LvdsCaptureFormat.TelemetryPrefixSize));
+    }
+
+    /// <summary>Last telemetry packet at or before <paramref name="hostUs"/>; -1 if none.</summary>
+    public int FindTelemetry(long hostUs) => FindLast(_telemetry, hostUs);
+
+    private static int FindLast(LvdsCaptureFormat.IndexEntry[] entries, long hostUs)
+    {
+        int lo = 0, hi = entries.Length - 1, found = -1;
+        while (lo <= hi)
+        {
+            int mid = (lo + hi) >>> 1;
+            if (entries[mid].HostUs <= hostUs) { found = mid; lo = mid + 1; }
+            else hi = mid - 1;
+        }
+        return found;
+    }
+
+    private ReadOnlySpan<byte> Span(long offset, long length)
+    {
+        ObjectDisposedException.ThrowIf(_disposed, this);
+        if (offset < 0 || length < 0 || offset + length > _length || length > int.MaxValue)
+            throw new InvalidDataException($"Record at offset {offset} runs past the end of the capture file");
+        return new ReadOnlySpan<byte>(_base + offset, (int)length);
+    }
+
+    private ReadOnlySpan<byte> Body(LvdsCaptureFormat.IndexEntry entry, uint tag)
+    {
+        var hdr = Span(entry.Offset, LvdsCaptureFormat.RecordHeaderSize);
+        if (BinaryPrimitives.ReadUInt32LittleEndian(hdr) != tag)
+            throw new InvalidDataException($"Unexpected record at offset {entry.Offset}");
+        int bodyLen = BinaryPrimitives.ReadInt32LittleEndian(hdr.Slice(4));
+        return Span(entry.Offset + LvdsCaptureFormat.RecordHeaderSize, bodyLen);
+    }
+
+    private LvdsCaptureFormat.IndexEntry[] ReadIndex(long offset, int count)
+    {
+        var entries = new LvdsCaptureFormat.IndexEntry[count];
+        var src = Span(offset, (long)count * LvdsCaptureFormat.IndexEntrySize);
+        for (int i = 0; i < count; i++)
+        {
+            var e = src.Slice(i * LvdsCaptureFormat.IndexEntrySize);
+            entries[i] = new LvdsCaptureFormat.IndexEntry(
+                BinaryPrimitives.ReadInt64LittleEndian(e), BinaryPrimitives.ReadInt64LittleEndian(e.Slice(8)));
+        }
+        return entries;
+    }
+
+    /// <summary>
+    /// Index of a file without one: walk the records from the header and
+    /// stop at the first one that is not complete (the preallocated tail
+    /// reads as zeros).
+    /// </summary>
+    private (LvdsCaptureFormat.IndexEntry[], LvdsCaptureFormat.IndexEntry[]) ScanRecords()
+    {
+        var frames = new List<LvdsCaptureFormat.IndexEntry>();
+        var telemetry = new List<LvdsCaptureFormat.IndexEntry>();
+        long off = LvdsCaptureFormat.HeaderSize;
+        while (off + LvdsCaptureFormat.RecordHeaderSize <= _length)
+        {
+            var hdr = Span(off, LvdsCaptureFormat.RecordHeaderSize);
+            uint tag = BinaryPrimitives.ReadUInt32LittleEndian(hdr);
+            int bodyLen = BinaryPrimitives.ReadInt32LittleEndian(hdr.Slice(4));
+            long hostUs = BinaryPrimitives.ReadInt64LittleEndian(hdr.Slice(8));
+            long end = off + LvdsCaptureFormat.RecordHeaderSize + (long)bodyLen;
+            if (bodyLen < 0 || end > _length) break;
+
+            if (tag == LvdsCaptureFormat.TagFrame && bodyLen >= LvdsCaptureFormat.FrameMetaSize)
+                frames.Add(new(off, hostUs));
+            else if (tag == LvdsCaptureFormat.TagTelemetry && bodyLen >= LvdsCaptureFormat.TelemetryPrefixSize)
+                telemetry.Add(new(off, hostUs));
+            else
+                break;
+            off = LvdsCaptureFormat.Align8(end);
+        }
+        return (frames.ToArray(), telemetry.ToArray());
+    }
+
+    public void Dispose()
+    {
+        if (_disposed) return;
+        _disposed = true;
+        _view.SafeMemoryMappedViewHandle.ReleasePointer();
+        _view.Dispose();
+        _mmf.Dispose();
+    }
+}
@@ -0,0 +1,385 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// Records LVDS frames and firmware telemetry into a native capture file
+/// (*.lvdscap), read back by <see cref="LvdsCaptureReader"/>.
+///
+/// Frames are stored as the receiver delivered them: pixels untouched,
+/// with their <see cref="LvdsFrameMeta"/> and host timestamp.  Nothing is
+/// converted, so a frame costs one copy into the file cache on the writer
+/// thread, and pooled frames are queued by reference
+/// (<see cref="LvdsFrameLease.AddRef"/>) rather than copied.  The file
+/// grows in large preallocated steps and the frame index is written at
+/// its end by <see cref="Dispose"/>; a file that was never closed is still
+/// readable up to its last complete record.
+/// If the queue is full the frame is dropped and counted.
+/// </summary>
+public sealed class LvdsCaptureWriter : IDisposable
+{
+    public const string FileExtension = ".lvdscap";
+    public const long DefaultPreallocateBytes = 256L << 20;
+
+    private readonly FileStream _fs;
+    private readonly long _preallocateBytes;
+    private readonly long _startHostUs;
+    private readonly DateTime _startUtc;
+
+    private readonly BlockingCollection<Item> _queue;
+    private readonly Task _worker;
+
+    private static readonly byte[] Padding = new byte[8];
+
+    // Writer thread only
+    private readonly byte[] _scratch = new byte[LvdsCaptureFormat.RecordHeaderSize + LvdsCaptureFormat.FrameMetaSize];
+    private readonly List<LvdsCaptureFormat.IndexEntry> _frameIndex = new(4096);
+    private readonly List<LvdsCaptureFormat.IndexEntry> _telemetryIndex = new(256);
+    private long _pos = LvdsCaptureFormat.HeaderSize;
+    private long _allocated;
+
+    private long _framesWritten;
+    private long _droppedFrames;
+    private volatile Exception? _error;
+    private int _disposed;
+
+    public string Path { get; }
+
+    /// <summary>Frames in the file so far.</summary>
+    public long FramesWritten => Interlocked.Read(ref _framesWritten);
+
+    /// <summary>Frames not recorded because the queue was full or the file failed.</summary>
+    public long DroppedFrames => Interlocked.Read(ref _droppedFrames);
+
+    /// <summary>Bytes of records written so far (without the index).</summary>
+    public long BytesWritten => Interlocked.Read(ref _pos);
+
+    /// <summary>Write error that stopped the recording, if any.</summary>
+    public Exception? Error => _error;
+
+    public LvdsCaptureWriter(string path, long preallocateBytes = DefaultPreallocateBytes, int queueCapacity = 512)
+    {
+        if (string.IsNullOrWhiteSpace(path)) throw new ArgumentException("Path is required", nameof(path));
+
+        string? dir = System.IO.Path.GetDirectoryName(path);
+        if (!string.IsNullOrWhiteSpace(dir) && !Directory.Exists(dir))
+            Directory.CreateDirectory(dir);
+
+        Path = path;
+        _preallocateBytes = Math.Max(1L << 20, preallocateBytes);
+        _startUtc = DateTime.UtcNow;
+        _startHostUs = LvdsCaptureFormat.HostNowUs();
+
+        _fs = new FileStream(path, FileMode.Create, FileAccess.ReadWrite, FileShare.Read,
+            bufferSize: 1 << 20, FileOptions.SequentialScan);
+        _allocated = _preallocateBytes;
+        _fs.SetLength(_allocated);
+        WriteFileHeader(finished: false, indexOffset: 0);
+        _fs.Position = _pos;
+
+        _queue = new BlockingCollection<Item>(new ConcurrentQueue<Item>(), Math.Max(1, queueCapacity));
+        _worker = Task.Run(WorkerLoop);
+    }
+
+    /// <summary>Queue a pooled frame; takes its own reference.</summary>
+    public bool TryAppend(LvdsFrameLease lease)
+    {
+        if (!CanAppend()) { Interlocked.Increment(ref _droppedFrames); return false; }
+        lease.AddRef();
+        if (TryAdd(new Item(lease, null, lease.Meta, null, HostUs(lease.Meta))))
+            return true;
+        lease.Dispose();
+        Interlocked.Increment(ref _droppedFrames);
+        return false;
+    }
+
+    /// <summary>Queue a frame the caller will not modify again (e.g. from <see cref="LvdsLiveManager.OnFrameReady"/>).</summary>
+    public bool TryAppend(byte[] pixels, LvdsFrameMeta meta)
+    {
+        if (CanAppend() && TryAdd(new Item(null, pixels, meta, null, HostUs(meta))))
+            return true;
+        Interlocked.Increment(ref _droppedFrames);
+        return false;
+    }
+
+    /// <summary>Queue a telemetry packet, stamped with the current host time.</summary>
+    public bool TryAppend(LvdsFirmwareTelemetry telemetry)
+    {
+        return CanAppend() && TryAdd(new Item(null, null, null, telemetry, LvdsCaptureFormat.HostNowUs()));
+    }
+
+    private bool CanAppend()
+    {
+        // Dispose on another thread may have disposed the queue already
+        try { return _error == null && !_queue.IsAddingCompleted; }
+        catch (ObjectDisposedException) { return false; }
+    }
+
+    private bool TryAdd(Item item)
+    {
+        // The queue may complete (or be disposed) between the check and the add
+        try { return _queue.TryAdd(item); }
+        catch (ObjectDisposedException) { return false; }
+        catch (InvalidOperationException) { return false; }
+    }
+
+    private static long HostUs(LvdsFrameMeta meta)
+        => meta.HostTimestampUs != 0 ? meta.HostTimestampUs : LvdsCaptureFormat.HostNowUs();
+
+    private readonly record struct Item(LvdsFrameLease? Lease, byte[]? Pixels, LvdsFrameMeta? Meta,
+        LvdsFirmwareTelemetry? Telemetry, long HostUs);
+
+    private void WorkerLoop()
+    {
+        foreach (var item in _queue.GetConsumingEnumerable())
+        {
+            try
+            {
+                if (_error == null)
+                    WriteRecord(item);
+                else if (item.Telemetry == null)
+                    Interlocked.Increment(ref _droppedFrames);
+            }
+            catch (Exception ex)
+            {
+                _error = ex;
+                if (item.Telemetry == null)
+                    Interlocked.Increment(ref _droppedFrames);
+            }
+            finally
+            {
+                item.Lease?.Dispose();
+            }
+        }
+    }
+
+    private void WriteRecord(in Item item)
+    {
+        Span<byte> hdr = _scratch;
+        ReadOnlySpan<byte> payload;
+        int fixedLen;
+        uint tag;
+        if (item.Telemetry != null)
+        {
+            tag = LvdsCaptureFormat.TagTelemetry;
+            payload = item.Telemetry.Body;
+            fixedLen = LvdsCaptureFormat.TelemetryPrefixSize;
+            hdr.Slice(LvdsCaptureFormat.RecordHeaderSize, fixedLen).Clear();
+            hdr[LvdsCaptureFormat.RecordHeaderSize] = (byte)item.Telemetry.Version;
+        }
+        else
+        {
+            tag = LvdsCaptureFormat.TagFrame;
+            payload = item.Lease != null ? item.Lease.Span : (ReadOnlySpan<byte>)item.Pixels;
+            fixedLen = LvdsCaptureFormat.FrameMetaSize;
+            LvdsCaptureFormat.WriteFrameMeta(hdr.Slice(LvdsCaptureFormat.RecordHeaderSize, fixedLen), item.Meta!);
+        }
+
+        int bodyLen = fixedLen + payload.Length;
+        long recordLen = LvdsCaptureFormat.Align8(LvdsCaptureFormat.RecordHeaderSize + bodyLen);
+        using var trace = TraceLog.Scope(TraceEvent.CaptureFileWrite, recordLen);
+        EnsureSpace(_pos + recordLen);
+
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr, tag);
+        BinaryPrimitives.WriteInt32LittleEndian(hdr.Slice(4), bodyLen);
+        BinaryPrimitives.WriteInt64LittleEndian(hdr.Slice(8), item.HostUs);
+
+        _fs.Write(hdr.Slice(0, LvdsCaptureFormat.RecordHeaderSize + fixedLen));
+        _fs.Write(payload);
+        int pad = (int)(recordLen - LvdsCaptureFormat.RecordHeaderSize - bodyLen);
+        if (pad > 0)
+            _fs.Write(Padding, 0, pad);
+
+        var entry = new LvdsCaptureFormat.IndexEntry(_pos, item.HostUs);
+        if (item.Telemetry != null)
+            _telemetryIndex.Add(entry);
+        else
+        {
+            _frameIndex.Add(entry);
+            Interlocked.Increment(ref _framesWritten);
+        }
+        Interlocked.Exchange(ref _pos, _pos + recordLen);
+    }
+
+    private void EnsureSpace(long end)
+    {
+        if (end <= _allocated) return;
+        _allocated = Math.Max(_allocated + _preallocateBytes, end);
+        _fs.SetLength(_allocated);
+    }
+
+    private void WriteFileHeader(bool finished, long indexOffset)
+    {
+        Span<byte> h = stackalloc byte[LvdsCaptureFormat.HeaderSize];
+        h.Clear();
+        LvdsCaptureFormat.Magic.CopyTo(h);
+        BinaryPrimitives.WriteUInt16LittleEndian(h.Slice(8), LvdsCaptureFormat.Version);
+        BinaryPrimitives.WriteUInt16LittleEndian(h.Slice(10), LvdsCaptureFormat.HeaderSize);
+        BinaryPrimitives.WriteUInt32LittleEndian(h.Slice(12), finished ? LvdsCaptureFormat.FlagIndexed : 0u);
+        BinaryPrimitives.WriteInt64LittleEndian(h.Slice(16), indexOffset);
+        BinaryPrimitives.WriteInt32LittleEndian(h.Slice(24), finished ? _frameIndex.Count : 0);
+        BinaryPrimitives.WriteInt32LittleEndian(h.Slice(28), finished ? _telemetryIndex.Count : 0);
+        BinaryPrimitives.WriteInt64LittleEndian(h.Slice(32), _startUtc.Ticks);
+        BinaryPrimitives.WriteInt64LittleEndian(h.Slice(40), _startHostUs);
+        BinaryPrimitives.WriteInt64LittleEndian(h.Slice(48), finished ? indexOffset : 0);
+        _fs.Position = 0;
+        _fs.Write(h);
+    }
+
+    /// <summary>Write the index after the last record and trim the preallocated tail.</summary>
+    private void Finish()
+    {
+        long indexOffset = _pos;
+        _fs.Position = indexOffset;
+        Span<byte> e = stackalloc byte[LvdsCaptureFormat.IndexEntrySize];
+        foreach (var list in new[] { _frameIndex, _telemetryIndex })
+        {
+            foreach (var entry in list)
+            {
+                BinaryPrimitives.WriteInt64LittleEndian(e, entry.Offset);
+                BinaryPrimitives.WriteInt64LittleEndian(e.Slice(8), entry.HostUs);
+                _fs.Write(e);
+            }
+        }
+        long end = _fs.Position;
+        WriteFileHeader(finished: true, indexOffset);
+        _fs.Flush();
+        _fs.SetLength(end);
+    }
+
+    public void Dispose()
+    {
+        if (Interlocked.Exchange(ref _disposed, 1) != 0) return;
+
+        try { _queue.CompleteAdding(); } catch { }
+        try { _worker.Wait(); } catch { }
+
+        try
+        {
+            if (_error == null)
+                Finish();
+            else
+                _fs.SetLength(_pos);   // leave a file the reader can recover by scanning
+        }
+        catch (Exception ex)
+        {
+            _error ??= ex;
+        }
+        _fs.Dispose();
+        _queue.Dispose();
+    }
+}
+
+/// <summary>
+/// Layout of a *.lvdscap file (little-endian, records 8-byte aligned):
+///   header  [magic "LVDSCAP1"] [version:2] [header_size:2] [flags:4]
+///           [index_offset:8] [frame_count:4] [telemetry_count:4]
+///           [start_utc_ticks:8] [start_host_us:8] [data_end:8] [reserved:8]
+///   record  [tag:4] [body_len:4] [host_us:8] [body] [pad to 8]
+///     'FRM0' body: frame meta (<see cref="FrameMetaSize"/> bytes) + Width × Height pixels
+///     'TEL0' body: [version] [reserved:3] + telemetry packet body
+///   index   frame_count × [offset:8] [host_us:8], then telemetry_count × the same
+///
+/// Counts and index are only valid with <see cref="FlagIndexed"/>; without
+/// it the records are found by walking them from the header.  host_us is
+/// Stopwatch time in µs (<see cref="LvdsFrameMeta.HostTimestampUs"/>);
+/// start_host_us taken with start_utc_ticks maps it to wall time.
+/// Firmware frame statistics ('H') are not stored.
+/// </summary>
+internal static class LvdsCaptureFormat
+{
+    public static ReadOnlySpan<byte> Magic => "LVDSCAP1"u8;
+    public const ushort Version = 1;
+    public const int HeaderSize = 64;
+    public const uint FlagIndexed = 0x01;
+
+    public const int RecordHeaderSize = 16;
+    public const uint TagFrame = 0x304D5246;       // "FRM0"
+    public const uint TagTelemetry = 0x304C4554;   // "TEL0"
+    public const int TelemetryPrefixSize = 4;
+    public const int IndexEntrySize = 16;
+
+    // Frame meta: ids and times, geometry, line counts, errors, validity bitmap
+    public const int FrameMetaSize = 80;
+    public const int MaskRows = 128;
+    private const int MaskOffset = 64;
+
+    public readonly record struct IndexEntry(long Offset, long HostUs);
+
+    public static long Align8(long n) => (n + 7) & ~7L;
+
+    public static long HostNowUs() => Stopwatch.GetTimestamp() * 1_000_000 / Stopwatch.Frequency;
+
+    public static void WriteFrameMeta(Span<byte> d, LvdsFrameMeta m)
+    {
+        d.Clear();
+        BinaryPrimitives.WriteUInt32LittleEndian(d, m.FrameId);
+        BinaryPrimitives.WriteUInt32LittleEndian(d.Slice(4), m.FirmwareFrameId);
+        BinaryPrimitives.WriteUInt64LittleEndian(d.Slice(8), m.FirmwareTimestampUs);
+        BinaryPrimitives.WriteUInt16LittleEndian(d.Slice(16), (ushort)m.Width);
+        BinaryPrimitives.WriteUInt16LittleEndian(d.Slice(18), (ushort)m.Height);
+        BinaryPrimitives.WriteUInt16LittleEndian(d.Slice(20), (ushort)m.RoiX);
+        BinaryPrimitives.WriteUInt16LittleEndian(d.Slice(22), (ushort)m.RoiY);
+        BinaryPrimitives.WriteUInt16LittleEndian(d.Slice(24), (ushort)m.RowStep);
+        BinaryPrimitives.WriteUInt16LittleEndian(d.Slice(26), (ushort)m.SourceWidth);
+        BinaryPrimitives.WriteUInt16LittleEndian(d.Slice(28), (ushort)m.SourceHeight);
+        d[30] = (byte)m.Channel;
+        int maskRows = Math.Min(m.LineValidityMask.Length, MaskRows);
+        d[31] = (byte)maskRows;
+        BinaryPrimitives.WriteUInt16LittleEndian(d.Slice(32), (ushort)m.LinesReceived);
+        BinaryPrimitives.WriteUInt16LittleEndian(d.Slice(34), (ushort)m.ValidLines);
+        BinaryPrimitives.WriteUInt16LittleEndian(d.Slice(36), (ushort)m.LinesExpected);
+        BinaryPrimitives.WriteInt16LittleEndian(d.Slice(38), (short)m.ChangedRows);
+        BinaryPrimitives.WriteSingleLittleEndian(d.Slice(40), (float)m.RelativeLatencyUs);
+        BinaryPrimitives.WriteInt32LittleEndian(d.Slice(44), m.SyncLosses);
+        BinaryPrimitives.WriteInt32LittleEndian(d.Slice(48), m.CrcErrors);
+        BinaryPrimitives.WriteInt32LittleEndian(d.Slice(52), m.ParityErrors);
+        BinaryPrimitives.WriteInt64LittleEndian(d.Slice(56), m.TotalBytes);
+        for (int r = 0; r < maskRows; r++)
+        {
+            if (m.LineValidityMask[r])
+                d[MaskOffset + (r >> 3)] |= (byte)(1 << (r & 7));
+        }
+    }
+
+    public static LvdsFrameMeta ReadFrameMeta(ReadOnlySpan<byte> d, long hostUs)
+    {
+        int maskRows = d[31];
+        var mask = new bool[maskRows];
+        for (int r = 0; r < maskRows; r++)
+            mask[r] = (d[MaskOffset + (r >> 3)] & (1 << (r & 7))) != 0;
+
+        return new LvdsFrameMeta
+        {
+            FrameId = BinaryPrimitives.ReadUInt32LittleEndian(d),
+            FirmwareFrameId = BinaryPrimitives.ReadUInt32LittleEndian(d.Slice(4)),
+            FirmwareTimestampUs = BinaryPrimitives.ReadUInt64LittleEndian(d.Slice(8)),
+            HostTimestampUs = hostUs,
+            Width = BinaryPrimitives.ReadUInt16LittleEndian(d.Slice(16)),
+            Height = BinaryPrimitives.ReadUInt16LittleEndian(d.Slice(18)),
+            RoiX = BinaryPrimitives.ReadUInt16LittleEndian(d.Slice(20)),
+            RoiY = BinaryPrimitives.ReadUInt16LittleEndian(d.Slice(22)),
+            RowStep = BinaryPrimitives.ReadUInt16LittleEndian(d.Slice(24)),
+            SourceWidth = BinaryPrimitives.ReadUInt16LittleEndian(d.Slice(26)),
+            SourceHeight = BinaryPrimitives.ReadUInt16LittleEndian(d.Slice(28)),
+            Channel = d[30],
+            LineValidityMask = mask,
+            LinesReceived = BinaryPrimitives.ReadUInt16LittleEndian(d.Slice(32)),
+            ValidLines = BinaryPrimitives.ReadUInt16LittleEndian(d.Slice(34)),
+            LinesExpected = BinaryPrimitives.ReadUInt16LittleEndian(d.Slice(36)),
+            ChangedRows = BinaryPrimitives.ReadInt16LittleEndian(d.Slice(38)),
+            RelativeLatencyUs = BinaryPrimitives.ReadSingleLittleEndian(d.Slice(40)),
+            SyncLosses = BinaryPrimitives.ReadInt32LittleEndian(d.Slice(44)),
+            CrcErrors = BinaryPrimitives.ReadInt32LittleEndian(d.Slice(48)),
+            ParityErrors = BinaryPrimitives.ReadInt32LittleEndian(d.Slice(52)),
+            TotalBytes = BinaryPrimitives.ReadInt64LittleEndian(d.Slice(56)),
+        };
+    }
+}
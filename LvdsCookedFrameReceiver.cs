@@ -1,8 +1,14 @@
 using System;
+using System.Buffers.Binary;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
 using System.Threading;
 
 namespace VilsSharpX;
 
+/// <summary>Row of a row-mode frame: window row index and its pixels.</summary>
+public delegate void LvdsRowHandler(int channel, uint firmwareFrameId, int row, ReadOnlySpan<byte> pixels);
+
 /// <summary>
 /// Receives "cooked frame" packets from the Pico 2 frame-aware firmware.
 ///
@@ -15,9 +21,82 @@ namespace VilsSharpX;
 ///   [height_lo] [height_hi]               — active height in pixels (LE)
 ///   [width × height bytes of pixel data]  — row-major grayscale
 ///
-/// Each frame received is COMPLETE (all rows present, CRC-verified by
-/// firmware).  No reassembly, persistent merging, or CRC checking
-/// needed on the host side.
+/// In delta mode (host command 'D' 1), with compression, or from a
+/// dual-link bridge (every frame) the firmware sends extended packets:
+///
+///   [0xFE] [0xEE]                         — magic bytes
+///   [version] [hdr_len]                   — header version, total header bytes
+///   [flags] [channel]                     — bit0 DELTA, bit1 KEY, bit2 RLE, bit3 NIB4;
+///                                           channel = link of a dual-link bridge (0/1)
+///   [frame_id:2] [width:2] [height:2]     — as above (LE)
+///   [payload_len:4]                       — payload bytes that follow (LE)
+///   version 2 (hdr_len 44) appends:
+///   [frame_id:4]                          — 32-bit frame counter (LE)
+///   [sof_us:8]                            — RP2350 time_us_64() at the first line's sync
+///   [lines_placed:2]                      — active rows the firmware received
+///   [missing_len] [reserved] [missing:12] — missing-row bitmap (bit r&amp;7 of byte r/8)
+///   version 3 (hdr_len 56) appends:
+///   [roi_x:2] [roi_y:2]                   — window origin in the assembled frame
+///   [src_width:2] [src_height:2]          — assembled frame size
+///   [row_step] [reserved:3]               — source rows per sent row
+///   With a region of interest (host command 'W') width/height, lines_placed
+///   and the missing bitmap describe the window: row r is source row
+///   roi_y + r × row_step.
+///   KEY payload:   width × height pixels
+///   DELTA payload: ceil(height/8)-byte row bitmap + the changed rows
+///
+/// With compression enabled (host command 'Z') the pixel rows of the
+/// payload (not the bitmap) may be coded: NIB4 = 16-byte palette followed
+/// by rows packed two pixels per byte (high nibble first), RLE = PackBits
+/// over the (packed) rows.  Both flags may be set together.
+///
+/// In raw line mode (host command 'L') the firmware sends one record per
+/// validated line instead of frames:
+///
+///   [0xFE] [0xEF] [status] [len:2]        — status bit0 = CRC ok, bits 4-7 = channel
+///   [0x5D] [row] [pixels] [crc]           — the line as received on LVDS
+///
+/// Records are raised through <see cref="OnRawLine"/>.
+///
+/// In row mode (host command 'Y') each row is sent as soon as it is
+/// placed, and a frame ends with a record carrying the v2/v3 fields:
+///
+///   [0xFE] [0xEA] [type] [channel]        — type 0 = ROW, 1 = END
+///   [frame_id:4] [index:2] [len:2]        — index = window row (ROW) or row count (END)
+///   ROW body: the row's window pixels
+///   END body: [sof_us:8] [width:2] [height:2] [lines_placed:2]
+///             [missing_len] [reserved] [missing:12]
+///             [roi_x:2] [roi_y:2] [src_width:2] [src_height:2] [row_step] [reserved:3]
+///
+/// Rows are raised through <see cref="OnRowReady"/> as they arrive and the
+/// frame through <see cref="OnFrameReady"/> / <see cref="OnFrameLeased"/>
+/// at its END record; rows lost on the way are zero and flagged invalid.
+///
+/// With telemetry enabled (host command 'T') the firmware interleaves
+/// [0xFE] [0xEC] packets between the others; they are decoded into
+/// <see cref="LvdsFirmwareTelemetry"/> and raised through <see cref="OnTelemetry"/>.
+///
+/// With frame statistics enabled (host command 'H') a [0xFE] [0xEB] packet
+/// precedes each frame; it is decoded into <see cref="LvdsFrameStats"/>,
+/// raised through <see cref="OnFrameStats"/> and attached to the frame's
+/// <see cref="LvdsFrameMeta.Stats"/>.
+///
+/// Frames are raised twice: <see cref="OnFrameReady"/> with a fresh copy
+/// (only made while it has subscribers), and <see cref="OnFrameLeased"/>
+/// with a pooled, reference-counted <see cref="LvdsFrameLease"/>.
+///
+/// A delta is applied to the previous reconstructed frame of its channel.  If no valid
+/// base exists (start-up, lost sync) the delta is discarded and
+/// <see cref="OnKeyframeNeeded"/> asks the owner to request a keyframe ('K').
+///
+/// Each frame received is COMPLETE (CRC-verified by firmware, rows the
+/// firmware did not receive are zero and flagged in the v2 missing-row
+/// bitmap).  No reassembly, persistent merging, or CRC checking needed
+/// on the host side.
+///
+/// Input is parsed a span at a time: the magic scan is a vectorized
+/// IndexOf, headers and bodies are bulk copies, and an uncompressed
+/// payload that arrives whole in one push is decoded straight from it.
 /// </summary>
 public sealed class LvdsCookedFrameReceiver : IDisposable
 {
@@ -27,13 +106,48 @@ public sealed class LvdsCookedFrameReceiver : IDisposable
         ScanMagic1,   // Looking for 0xED (after 0xFE)
         ReadHeader,   // Reading 6 header bytes (frame_id, w, h)
         ReadPixels,   // Reading w×h pixel bytes
+        ReadExtHeader,  // Reading extended header (after 0xFE 0xEE)
+        ReadPayload,    // Reading extended packet payload
+        ReadLineHeader, // Reading raw line record header (after 0xFE 0xEF)
+        ReadLine,       // Reading raw line bytes
+        ReadTelemetryHeader, // Reading telemetry header (after 0xFE 0xEC)
+        ReadTelemetry,       // Reading telemetry body
+        ReadStatsHeader,     // Reading frame statistics header (after 0xFE 0xEB)
+        ReadStats,           // Reading frame statistics body
+        ReadRowHeader,       // Reading row record header (after 0xFE 0xEA)
+        ReadRow,             // Reading row record body
     }
 
     private const byte MAGIC_0 = 0xFE;
     private const byte MAGIC_1 = 0xED;
+    private const byte MAGIC_1_EXT = 0xEE;
+    private const byte MAGIC_1_LINE = 0xEF;
+    private const byte MAGIC_1_ROW = 0xEA;
+    private const int TELEM_HDR_SIZE = LvdsFirmwareTelemetry.HeaderSize - 2;  // after the magic
+    private const int LINE_REC_HDR_SIZE = 3;    // status + len(2), after the magic
+    private const int MAX_LINE_BYTES = 2 + 320 + 4;
+    private const int ROW_REC_HDR_SIZE = 10;    // type, channel, frame_id(4), index(2), len(2)
+    private const byte ROW_REC_ROW = 0;
+    private const byte ROW_REC_END = 1;
+    private const int ROW_REC_END_SIZE = 40;
+    private const int MAX_ROW_REC_BYTES = 320;
+    private const int MAX_ROWS = 84;
     private const int HDR_PAYLOAD_SIZE = 6;  // frame_id(2) + w(2) + h(2)
     private const int MAX_PIXEL_BYTES = 320 * 84; // Osram worst case
 
+    // Extended header: sizes count the two magic bytes
+    private const int EXT_HDR_MIN_SIZE = 16;
+    private const int EXT_HDR_V2_SIZE = 44;
+    private const int EXT_HDR_V3_SIZE = 56;
+    private const int EXT_HDR_MAX_SIZE = 64;
+    private const int MAX_PAYLOAD_BYTES = MAX_PIXEL_BYTES + 64;
+    private const byte EXT_FLAG_DELTA = 0x01;
+    private const byte EXT_FLAG_KEY = 0x02;
+    private const byte EXT_FLAG_RLE = 0x04;
+    private const byte EXT_FLAG_NIB4 = 0x08;
+    private const int NIB4_PALETTE = 16;
+    private const int MAX_CHANNELS = 2;
+
     private State _state = State.ScanMagic0;
     private readonly byte[] _hdrBuf = new byte[HDR_PAYLOAD_SIZE];
     private int _hdrPos;
@@ -42,11 +156,88 @@ public sealed class LvdsCookedFrameReceiver : IDisposable
     private int _frameWidth;
     private int _frameHeight;
     private uint _fwFrameId;   // firmware frame counter from packet
+    private int _channel;      // link the current packet came from
+
+    // Version 2 header fields of the current packet
+    private bool _hasTiming;
+    private ulong _fwTimestampUs;
+    private int _fwLinesPlaced;
+    private readonly byte[] _missingRows = new byte[12];
+    private int _missingLen;
+
+    // Version 3 header fields: window of the assembled frame that was sent
+    private int _roiX, _roiY, _rowStep = 1, _sourceWidth, _sourceHeight;
+
+    // Transit time: minimum (host - firmware) clock offset, allowed to
+    // creep upward so crystal drift between the clocks does not build up.
+    private const double OFFSET_DRIFT_PPM = 100;
+    private double _minOffsetUs = double.NaN;
+    private long _lastOffsetHostUs;
+
+    // Extended packet state
+    private readonly byte[] _extHdrBuf = new byte[EXT_HDR_MAX_SIZE];
+    private int _extHdrPos;
+    private int _extHdrLen;
+    private byte _extFlags;
+    private readonly byte[] _payloadBuf = new byte[MAX_PAYLOAD_BYTES];
+    private int _payloadLen;
+    private int _payloadPos;
+    private readonly byte[] _decodeBuf = new byte[MAX_PIXEL_BYTES];
+    private readonly byte[] _unpackBuf = new byte[MAX_PIXEL_BYTES];
+    private readonly ushort[] _nib4Pairs = new ushort[256];   // packed byte -> its two pixels
+
+    // Raw line record state
+    private readonly byte[] _lineHdrBuf = new byte[LINE_REC_HDR_SIZE];
+    private readonly byte[] _lineBuf = new byte[MAX_LINE_BYTES];
+    private int _lineLen;
+    private int _linePos;
+
+    // Row record state; each channel assembles its own frame
+    private readonly byte[] _rowHdrBuf = new byte[ROW_REC_HDR_SIZE];
+    private readonly byte[] _rowBuf = new byte[MAX_ROW_REC_BYTES];
+    private int _rowLen;
+    private int _rowPos;
+    private readonly byte[][] _rowFrames = { new byte[MAX_PIXEL_BYTES], new byte[MAX_PIXEL_BYTES] };
+    private readonly bool[][] _rowsGot = { new bool[MAX_ROWS], new bool[MAX_ROWS] };
+    private readonly uint[] _rowFrameIds = new uint[MAX_CHANNELS];
+    private readonly int[] _rowWidths = new int[MAX_CHANNELS];
+    private readonly int[] _rowCounts = new int[MAX_CHANNELS];
+
+    // Telemetry packet state
+    private readonly byte[] _telemHdrBuf = new byte[TELEM_HDR_SIZE];
+    private readonly byte[] _telemBuf = new byte[LvdsFirmwareTelemetry.MaxBodySize];
+    private int _telemLen;
+    private int _telemPos;
+
+    // Frame statistics state; the packet describes the frame that follows
+    private readonly byte[] _statsHdrBuf = new byte[LvdsFrameStats.HeaderSize - 2];
+    private readonly byte[] _statsBuf = new byte[LvdsFrameStats.MaxBodySize];
+    private int _statsLen;
+    private int _statsPos;
+    private LvdsFrameStats? _pendingStats;
+
+    // Delta base per channel: last reconstructed frame (what the firmware's reference holds)
+    private readonly byte[][] _refFrames = { Array.Empty<byte>(), Array.Empty<byte>() };
+    private readonly bool[] _refValid = new bool[MAX_CHANNELS];
+    private readonly uint[] _refFrameIds = new uint[MAX_CHANNELS];   // firmware frame id the base is from
+    private bool _keyframeRequested;
+    private int _changedRows;
+    private bool[] _allValid = Array.Empty<bool>();
 
     // Statistics
     private uint _frameCount;
     private long _totalBytes;
     private int _syncLosses;   // magic scan resets
+    private uint _keyframeCount;
+    private uint _deltaFrameCount;
+    private uint _compressedFrameCount;
+    private uint _rawLineCount;
+    private uint _telemetryCount;
+    private uint _statsCount;
+    private uint _rowRecordCount;
+    private int _rowFramesLost;
+    private int _decodeErrors;
+    private int _deltaDiscarded;  // deltas dropped for lack of a valid base
 
     /// <summary>Number of complete frames received.</summary>
     public uint FrameCount => _frameCount;
@@ -57,6 +248,36 @@ public sealed class LvdsCookedFrameReceiver : IDisposable
     /// <summary>Times the magic bytes scanner had to resync.</summary>
     public int SyncLossCount => _syncLosses;
 
+    /// <summary>Keyframes received in delta mode.</summary>
+    public uint KeyframeCount => _keyframeCount;
+
+    /// <summary>Delta frames received and applied.</summary>
+    public uint DeltaFrameCount => _deltaFrameCount;
+
+    /// <summary>Delta frames discarded because no valid base frame was held.</summary>
+    public int DeltaDiscardedCount => _deltaDiscarded;
+
+    /// <summary>Raw line records received (line mode).</summary>
+    public uint RawLineCount => _rawLineCount;
+
+    /// <summary>Firmware telemetry packets received.</summary>
+    public uint TelemetryCount => _telemetryCount;
+
+    /// <summary>Frame statistics packets received.</summary>
+    public uint FrameStatsCount => _statsCount;
+
+    /// <summary>Row records received (row mode).</summary>
+    public uint RowRecordCount => _rowRecordCount;
+
+    /// <summary>Row-mode frames whose END record never arrived; their rows are dropped.</summary>
+    public int RowFramesLostCount => _rowFramesLost;
+
+    /// <summary>Frames received with a compressed (RLE / NIB4) payload.</summary>
+    public uint CompressedFrameCount => _compressedFrameCount;
+
+    /// <summary>Extended packets whose payload did not decode to the expected size.</summary>
+    public int DecodeErrorCount => _decodeErrors;
+
     // These are tracked by firmware, not by this receiver.
     // Return 0 for API compatibility with GetReassemblerStats().
     public int CrcErrorCount => 0;
@@ -68,30 +289,126 @@ public sealed class LvdsCookedFrameReceiver : IDisposable
     /// </summary>
     public event Action<byte[], LvdsFrameMeta>? OnFrameReady;
 
+    /// <summary>
+    /// Fired for each complete frame with a pooled <see cref="LvdsFrameLease"/>
+    /// from <see cref="FramePool"/>; no buffer is allocated per frame.  The
+    /// lease is released when the handlers return: call
+    /// <see cref="LvdsFrameLease.AddRef"/> to keep it longer.
+    /// </summary>
+    public event Action<LvdsFrameLease>? OnFrameLeased;
+
+    /// <summary>
+    /// Fired (on the receive thread) when a delta frame cannot be applied and
+    /// the firmware should send a keyframe.  Raised once until a keyframe arrives.
+    /// </summary>
+    public event Action? OnKeyframeNeeded;
+
+    /// <summary>
+    /// Fired (on the receive thread) for each raw line record in line mode:
+    /// (buffer, length, crcOk, channel).  The buffer holds the line exactly as
+    /// received (sync, row byte, pixels, CRC) and is reused for the next
+    /// record — copy it if it must outlive the callback.
+    /// </summary>
+    public event Action<byte[], int, bool, int>? OnRawLine;
+
+    /// <summary>
+    /// Fired (on the receive thread) for each firmware telemetry packet.
+    /// </summary>
+    public event Action<LvdsFirmwareTelemetry>? OnTelemetry;
+
+    /// <summary>
+    /// Fired for each frame statistics packet, before the frame it describes.
+    /// </summary>
+    public event Action<LvdsFrameStats>? OnFrameStats;
+
+    /// <summary>
+    /// Fired (on the receive thread) for each row in row mode, before its
+    /// frame is complete.  The span is only valid during the callback.
+    /// </summary>
+    public event LvdsRowHandler? OnRowReady;
+
+    /// <summary>Buffers behind <see cref="OnFrameLeased"/>.</summary>
+    public LvdsFramePool FramePool { get; }
+
+    public LvdsCookedFrameReceiver(LvdsFramePool? framePool = null)
+    {
+        FramePool = framePool ?? new LvdsFramePool();
+    }
+
     /// <summary>
     /// Push raw serial bytes from the USB CDC connection.
     /// The receiver parses cooked frame packets from the byte stream.
     /// </summary>
-    public void Push(byte[] data, int count)
+    public void Push(byte[] data, int count) => Push(data.AsSpan(0, count));
+
+    /// <summary>
+    /// Push <paramref name="count"/> bytes of <paramref name="data"/> starting at <paramref name="offset"/>.
+    /// </summary>
+    public void Push(byte[] data, int offset, int count) => Push(data.AsSpan(offset, count));
+
+    /// <summary>
+    /// Push received bytes.  <paramref name="data"/> is not referenced after the call returns.
+    /// </summary>
+    public void Push(ReadOnlySpan<byte> data)
     {
-        Interlocked.Add(ref _totalBytes, count);
+        Interlocked.Add(ref _totalBytes, data.Length);
+        TraceLog.Begin(TraceEvent.ReceiverPush, data.Length);
 
         int i = 0;
-        while (i < count)
+        int end = data.Length;
+        while (i < end)
         {
             switch (_state)
             {
                 case State.ScanMagic0:
-                    if (data[i] == MAGIC_0)
-                        _state = State.ScanMagic1;
-                    i++;
+                {
+                    // Bytes between packets (firmware text replies) are not loss
+                    int skip = data.Slice(i).IndexOf(MAGIC_0);
+                    if (skip < 0)
+                    {
+                        i = end;
+                        break;
+                    }
+                    _state = State.ScanMagic1;
+                    i += skip + 1;
                     break;
+                }
 
                 case State.ScanMagic1:
                     if (data[i] == MAGIC_1)
                     {
                         _state = State.ReadHeader;
                         _hdrPos = 0;
+                        _hasTiming = false;
+                        ResetWindow();
+                    }
+                    else if (data[i] == MAGIC_1_LINE)
+                    {
+                        _state = State.ReadLineHeader;
+                        _hdrPos = 0;
+                    }
+                    else if (data[i] == LvdsFirmwareTelemetry.Magic1)
+                    {
+                        _state = State.ReadTelemetryHeader;
+                        _hdrPos = 0;
+                    }
+                    else if (data[i] == MAGIC_1_ROW)
+                    {
+                        _state = State.ReadRowHeader;
+                        _hdrPos = 0;
+                    }
+                    else if (data[i] == LvdsFrameStats.Magic1)
+                    {
+                        _state = State.ReadStatsHeader;
+                        _hdrPos = 0;
+                    }
+                    else if (data[i] == MAGIC_1_EXT)
+                    {
+                        _state = State.ReadExtHeader;
+                        _extHdrBuf[0] = MAGIC_0;
+                        _extHdrBuf[1] = MAGIC_1_EXT;
+                        _extHdrPos = 2;
+                        _extHdrLen = 4; // until version + hdr_len are known
                     }
                     else if (data[i] == MAGIC_0)
                     {
@@ -99,24 +416,17 @@ public sealed class LvdsCookedFrameReceiver : IDisposable
                     }
                     else
                     {
-                        _syncLosses++;
-                        _state = State.ScanMagic0;
+                        Resync();
                     }
                     i++;
                     break;
 
                 case State.ReadHeader:
                 {
-                    int need = HDR_PAYLOAD_SIZE - _hdrPos;
-                    int avail = count - i;
-                    int take = Math.Min(need, avail);
-                    Buffer.BlockCopy(data, i, _hdrBuf, _hdrPos, take);
-                    _hdrPos += take;
-                    i += take;
-
-                    if (_hdrPos >= HDR_PAYLOAD_SIZE)
+                    if (Fill(data, ref i, _hdrBuf, ref _hdrPos, HDR_PAYLOAD_SIZE))
                     {
                         _fwFrameId = (uint)(_hdrBuf[0] | (_hdrBuf[1] << 8));
+                        _channel = 0;
                         _frameWidth = _hdrBuf[2] | (_hdrBuf[3] << 8);
                         _frameHeight = _hdrBuf[4] | (_hdrBuf[5] << 8);
 
@@ -131,8 +441,7 @@ public sealed class LvdsCookedFrameReceiver : IDisposable
                         else
                         {
                             // Invalid dimensions — resync
-                            _syncLosses++;
-                            _state = State.ScanMagic0;
+                            Resync();
                         }
                     }
                     break;
@@ -140,52 +449,657 @@ public sealed class LvdsCookedFrameReceiver : IDisposable
 
                 case State.ReadPixels:
                 {
-                    int need = _pixelBuf.Length - _pixelPos;
-                    int avail = count - i;
-                    int take = Math.Min(need, avail);
-                    Buffer.BlockCopy(data, i, _pixelBuf, _pixelPos, take);
-                    _pixelPos += take;
-                    i += take;
-
-                    if (_pixelPos >= _pixelBuf.Length)
+                    if (Fill(data, ref i, _pixelBuf, ref _pixelPos, _pixelBuf.Length))
                     {
+                        // Full frame: also a valid base for later deltas
+                        StoreReference(_pixelBuf);
+                        _changedRows = _frameHeight;
                         EmitFrame();
                         _state = State.ScanMagic0;
                     }
                     break;
                 }
+
+                case State.ReadExtHeader:
+                {
+                    if (!Fill(data, ref i, _extHdrBuf, ref _extHdrPos, _extHdrLen))
+                        break;
+
+                    if (_extHdrLen == 4)
+                    {
+                        // version + hdr_len known: read the rest of the header
+                        int hdrLen = _extHdrBuf[3];
+                        if (_extHdrBuf[2] == 0 || hdrLen < EXT_HDR_MIN_SIZE || hdrLen > EXT_HDR_MAX_SIZE)
+                        {
+                            Resync();
+                            break;
+                        }
+                        _extHdrLen = hdrLen;
+                        break;
+                    }
+
+                    if (!ParseExtHeader())
+                    {
+                        Resync();
+                        break;
+                    }
+                    _payloadPos = 0;
+                    _state = State.ReadPayload;
+                    if (_payloadLen == 0)
+                        goto case State.ReadPayload;
+                    break;
+                }
+
+                case State.ReadLineHeader:
+                    if (Fill(data, ref i, _lineHdrBuf, ref _hdrPos, LINE_REC_HDR_SIZE))
+                    {
+                        _lineLen = _lineHdrBuf[1] | (_lineHdrBuf[2] << 8);
+                        if (_lineLen < 3 || _lineLen > MAX_LINE_BYTES)
+                        {
+                            Resync();
+                            break;
+                        }
+                        _linePos = 0;
+                        _state = State.ReadLine;
+                    }
+                    break;
+
+                case State.ReadLine:
+                {
+                    if (Fill(data, ref i, _lineBuf, ref _linePos, _lineLen))
+                    {
+                        _rawLineCount++;
+                        OnRawLine?.Invoke(_lineBuf, _lineLen, (_lineHdrBuf[0] & 0x01) != 0, _lineHdrBuf[0] >> 4);
+                        _state = State.ScanMagic0;
+                    }
+                    break;
+                }
+
+                case State.ReadRowHeader:
+                    if (Fill(data, ref i, _rowHdrBuf, ref _hdrPos, ROW_REC_HDR_SIZE))
+                    {
+                        _rowLen = _rowHdrBuf[8] | (_rowHdrBuf[9] << 8);
+                        int maxLen = _rowHdrBuf[0] == ROW_REC_END ? ROW_REC_END_SIZE : MAX_ROW_REC_BYTES;
+                        if (_rowHdrBuf[0] > ROW_REC_END || _rowHdrBuf[1] >= MAX_CHANNELS || _rowLen > maxLen)
+                        {
+                            Resync();
+                            break;
+                        }
+                        _rowPos = 0;
+                        _state = State.ReadRow;
+                        if (_rowLen == 0)
+                            goto case State.ReadRow;
+                    }
+                    break;
+
+                case State.ReadRow:
+                {
+                    if (Fill(data, ref i, _rowBuf, ref _rowPos, _rowLen))
+                    {
+                        _rowRecordCount++;
+                        HandleRowRecord();
+                        _state = State.ScanMagic0;
+                    }
+                    break;
+                }
+
+                case State.ReadTelemetryHeader:
+                    if (Fill(data, ref i, _telemHdrBuf, ref _hdrPos, TELEM_HDR_SIZE))
+                    {
+                        _telemLen = _telemHdrBuf[2] | (_telemHdrBuf[3] << 8);
+                        if (_telemLen > LvdsFirmwareTelemetry.MaxBodySize)
+                        {
+                            Resync();
+                            break;
+                        }
+                        _telemPos = 0;
+                        _state = State.ReadTelemetry;
+                        if (_telemLen == 0)
+                            goto case State.ReadTelemetry;
+                    }
+                    break;
+
+                case State.ReadTelemetry:
+                {
+                    if (Fill(data, ref i, _telemBuf, ref _telemPos, _telemLen))
+                    {
+                        var t = LvdsFirmwareTelemetry.TryParse(_telemHdrBuf[0], _telemBuf.AsSpan(0, _telemLen));
+                        if (t != null)
+                        {
+                            _telemetryCount++;
+                            OnTelemetry?.Invoke(t);
+                        }
+                        _state = State.ScanMagic0;
+                    }
+                    break;
+                }
+
+                case State.ReadStatsHeader:
+                    if (Fill(data, ref i, _statsHdrBuf, ref _hdrPos, _statsHdrBuf.Length))
+                    {
+                        _statsLen = _statsHdrBuf[2] | (_statsHdrBuf[3] << 8);
+                        if (_statsLen > LvdsFrameStats.MaxBodySize)
+                        {
+                            Resync();
+                            break;
+                        }
+                        _statsPos = 0;
+                        _state = State.ReadStats;
+                        if (_statsLen == 0)
+                            goto case State.ReadStats;
+                    }
+                    break;
+
+                case State.ReadStats:
+                {
+                    if (Fill(data, ref i, _statsBuf, ref _statsPos, _statsLen))
+                    {
+                        _pendingStats = LvdsFrameStats.TryParse(_statsHdrBuf[0], _statsHdrBuf[1],
+                                                                _statsBuf.AsSpan(0, _statsLen));
+                        if (_pendingStats != null)
+                        {
+                            _statsCount++;
+                            OnFrameStats?.Invoke(_pendingStats);
+                        }
+                        _state = State.ScanMagic0;
+                    }
+                    break;
+                }
+
+                case State.ReadPayload:
+                {
+                    if (_payloadPos == 0 && end - i >= _payloadLen)
+                    {
+                        // Whole payload in this push: decode it where it is
+                        DecodeExtPayload(data.Slice(i, _payloadLen));
+                        i += _payloadLen;
+                        _state = State.ScanMagic0;
+                        break;
+                    }
+                    if (Fill(data, ref i, _payloadBuf, ref _payloadPos, _payloadLen))
+                    {
+                        DecodeExtPayload(_payloadBuf.AsSpan(0, _payloadLen));
+                        _state = State.ScanMagic0;
+                    }
+                    break;
+                }
+            }
+        }
+        TraceLog.End(TraceEvent.ReceiverPush);
+    }
+
+    /// <summary>
+    /// Copy input at <paramref name="i"/> into <paramref name="dst"/> until it holds
+    /// <paramref name="len"/> bytes; returns true once it does.
+    /// </summary>
+    private static bool Fill(ReadOnlySpan<byte> data, ref int i, byte[] dst, ref int pos, int len)
+    {
+        int take = Math.Min(len - pos, data.Length - i);
+        data.Slice(i, take).CopyTo(dst.AsSpan(pos));
+        pos += take;
+        i += take;
+        return pos >= len;
+    }
+
+    /// <summary>
+    /// Parse the fixed part of an extended header.  Later header versions
+    /// may append fields; hdr_len lets older hosts skip them.
+    /// </summary>
+    private bool ParseExtHeader()
+    {
+        var h = _extHdrBuf;
+        _extFlags = h[4];
+        _channel = h[5];
+        _fwFrameId = (uint)(h[6] | (h[7] << 8));
+        _frameWidth = h[8] | (h[9] << 8);
+        _frameHeight = h[10] | (h[11] << 8);
+        _payloadLen = h[12] | (h[13] << 8) | (h[14] << 16) | (h[15] << 24);
+
+        _hasTiming = h[2] >= 2 && _extHdrLen >= EXT_HDR_V2_SIZE;
+        if (_hasTiming)
+        {
+            _fwFrameId = BinaryPrimitives.ReadUInt32LittleEndian(h.AsSpan(16));
+            _fwTimestampUs = BinaryPrimitives.ReadUInt64LittleEndian(h.AsSpan(20));
+            _fwLinesPlaced = h[28] | (h[29] << 8);
+            _missingLen = Math.Min((int)h[30], _missingRows.Length);
+            Buffer.BlockCopy(h, 32, _missingRows, 0, _missingRows.Length);
+        }
+
+        if (h[2] >= 3 && _extHdrLen >= EXT_HDR_V3_SIZE)
+        {
+            _roiX = h[44] | (h[45] << 8);
+            _roiY = h[46] | (h[47] << 8);
+            _sourceWidth = h[48] | (h[49] << 8);
+            _sourceHeight = h[50] | (h[51] << 8);
+            _rowStep = Math.Max(1, (int)h[52]);
+        }
+        else
+        {
+            ResetWindow();
+        }
+
+        int pixelBytes = _frameWidth * _frameHeight;
+        return pixelBytes > 0 && pixelBytes <= MAX_PIXEL_BYTES && _channel < MAX_CHANNELS
+            && _payloadLen >= 0 && _payloadLen <= MAX_PAYLOAD_BYTES;
+    }
+
+    private void DecodeExtPayload(ReadOnlySpan<byte> payload)
+    {
+        int w = _frameWidth, h = _frameHeight;
+        int pixelBytes = w * h;
+
+        if ((_extFlags & EXT_FLAG_KEY) != 0)
+        {
+            EnsurePixelBuf(pixelBytes);
+            if (!DecodePixels(payload, 0, h, w, _pixelBuf))
+            {
+                _decodeErrors++;
+                _refValid[_channel] = false;
+                return;
+            }
+            StoreReference(_pixelBuf);
+            _keyframeRequested = false;
+            _keyframeCount++;
+            _changedRows = h;
+            EmitFrame();
+            return;
+        }
+
+        if ((_extFlags & EXT_FLAG_DELTA) != 0)
+        {
+            byte[] refFrame = _refFrames[_channel];
+            if (_refValid[_channel] && !FollowsReference())
+                _refValid[_channel] = false;   // frames of this channel went missing
+            if (!_refValid[_channel] || refFrame.Length != pixelBytes)
+            {
+                _deltaDiscarded++;
+                RequestKeyframe();
+                return;
+            }
+
+            int bitmapLen = (h + 7) / 8;
+            if (payload.Length < bitmapLen)
+            {
+                _decodeErrors++;
+                _refValid[_channel] = false;
+                RequestKeyframe();
+                return;
+            }
+            int changed = 0;
+            for (int r = 0; r < h; r++)
+                if ((payload[r >> 3] & (1 << (r & 7))) != 0) changed++;
+            if (!DecodePixels(payload, bitmapLen, changed, w, _decodeBuf))
+            {
+                _decodeErrors++;
+                _refValid[_channel] = false;
+                RequestKeyframe();
+                return;
             }
+
+            int src = 0;
+            for (int r = 0; r < h; r++)
+            {
+                if ((payload[r >> 3] & (1 << (r & 7))) == 0) continue;
+                _decodeBuf.AsSpan(src, w).CopyTo(refFrame.AsSpan(r * w));
+                src += w;
+            }
+
+            _refFrameIds[_channel] = _fwFrameId;
+            EnsurePixelBuf(pixelBytes);
+            refFrame.AsSpan(0, pixelBytes).CopyTo(_pixelBuf);
+            _deltaFrameCount++;
+            _changedRows = changed;
+            EmitFrame();
         }
+        // Unknown payload type: skipped (payload_len already consumed)
+    }
+
+    /// <summary>
+    /// Decode <paramref name="rows"/> rows of pixels starting at
+    /// <paramref name="offset"/> in <paramref name="payload"/> into <paramref name="dst"/>.
+    /// Returns false if the coded data does not match the expected size.
+    /// </summary>
+    private bool DecodePixels(ReadOnlySpan<byte> payload, int offset, int rows, int w, byte[] dst)
+    {
+        int src = offset;
+        int end = payload.Length;
+        bool nib4 = (_extFlags & EXT_FLAG_NIB4) != 0;
+        bool rle = (_extFlags & EXT_FLAG_RLE) != 0;
+
+        int paletteAt = src;
+        if (nib4)
+        {
+            if (end - src < NIB4_PALETTE) return false;
+            src += NIB4_PALETTE;
+        }
+
+        int rowBytes = nib4 ? (w + 1) / 2 : w;
+        int need = rowBytes * rows;
+
+        // Stage 1: undo RLE into a contiguous buffer of (packed) rows
+        ReadOnlySpan<byte> packed;
+        if (rle)
+        {
+            int o = 0;
+            while (src < end && o < need)
+            {
+                int n = (sbyte)payload[src++];
+                if (n >= 0)
+                {
+                    int lit = n + 1;
+                    if (lit > end - src || lit > need - o) return false;
+                    payload.Slice(src, lit).CopyTo(_unpackBuf.AsSpan(o));
+                    src += lit;
+                    o += lit;
+                }
+                else if (n != -128)
+                {
+                    int run = 1 - n;
+                    if (src >= end || run > need - o) return false;
+                    _unpackBuf.AsSpan(o, run).Fill(payload[src++]);
+                    o += run;
+                }
+            }
+            if (o != need || src != end) return false;
+            packed = _unpackBuf.AsSpan(0, need);
+        }
+        else if (end - src != need)
+        {
+            return false;
+        }
+        else
+        {
+            packed = payload.Slice(src, need);
+        }
+
+        // Stage 2: expand nibbles through the palette, two pixels per
+        // packed byte from a pair table, or copy as-is
+        if (nib4)
+        {
+            var palette = payload.Slice(paletteAt, NIB4_PALETTE);
+            var pairs = _nib4Pairs;
+            for (int b = 0; b < 256; b++)
+                pairs[b] = (ushort)(palette[b >> 4] | (palette[b & 0x0F] << 8));
+            for (int r = 0; r < rows; r++)
+            {
+                var inRow = packed.Slice(r * rowBytes, rowBytes);
+                var outRow = dst.AsSpan(r * w, w);
+                var outPairs = MemoryMarshal.Cast<byte, ushort>(outRow.Slice(0, w & ~1));
+                for (int x = 0; x < outPairs.Length; x++)
+                    outPairs[x] = pairs[inRow[x]];
+                if ((w & 1) != 0)
+                    outRow[w - 1] = palette[inRow[rowBytes - 1] >> 4];
+            }
+        }
+        else
+        {
+            packed.CopyTo(dst);
+        }
+
+        if (nib4 || rle) _compressedFrameCount++;
+        return true;
+    }
+
+    /// <summary>
+    /// Place a ROW record in its channel's frame, or complete the frame on
+    /// END.  A frame id change without END drops the rows gathered so far.
+    /// </summary>
+    private void HandleRowRecord()
+    {
+        int ch = _rowHdrBuf[1];
+        uint id = BinaryPrimitives.ReadUInt32LittleEndian(_rowHdrBuf.AsSpan(2));
+        int index = _rowHdrBuf[6] | (_rowHdrBuf[7] << 8);
+        bool[] got = _rowsGot[ch];
+
+        if (id != _rowFrameIds[ch])
+        {
+            if (_rowCounts[ch] > 0) _rowFramesLost++;
+            Array.Clear(got);
+            _rowFrameIds[ch] = id;
+            _rowWidths[ch] = 0;
+            _rowCounts[ch] = 0;
+        }
+
+        if (_rowHdrBuf[0] == ROW_REC_ROW)
+        {
+            int w = _rowLen;
+            if (w == 0 || index >= MAX_ROWS || (index + 1) * w > MAX_PIXEL_BYTES ||
+                (_rowWidths[ch] != 0 && _rowWidths[ch] != w))
+            {
+                _decodeErrors++;
+                return;
+            }
+            _rowWidths[ch] = w;
+            Buffer.BlockCopy(_rowBuf, 0, _rowFrames[ch], index * w, w);
+            if (!got[index]) _rowCounts[ch]++;
+            got[index] = true;
+            OnRowReady?.Invoke(ch, id, index, _rowBuf.AsSpan(0, w));
+            return;
+        }
+
+        // END: header fields of the frame, as in a v3 extended header
+        var b = _rowBuf.AsSpan(0, _rowLen);
+        if (_rowLen < ROW_REC_END_SIZE)
+        {
+            _decodeErrors++;
+            return;
+        }
+        int width = b[8] | (b[9] << 8);
+        int height = b[10] | (b[11] << 8);
+        if (width == 0 || height == 0 || height > MAX_ROWS || width * height > MAX_PIXEL_BYTES ||
+            (_rowWidths[ch] != 0 && _rowWidths[ch] != width))
+        {
+            _decodeErrors++;
+            _rowCounts[ch] = 0;
+            return;
+        }
+
+        _channel = ch;
+        _fwFrameId = id;
+        _frameWidth = width;
+        _frameHeight = height;
+        _hasTiming = true;
+        _fwTimestampUs = BinaryPrimitives.ReadUInt64LittleEndian(b);
+        _fwLinesPlaced = b[12] | (b[13] << 8);
+        _missingLen = Math.Min((int)b[14], _missingRows.Length);
+        b.Slice(16, _missingRows.Length).CopyTo(_missingRows);
+        _roiX = b[28] | (b[29] << 8);
+        _roiY = b[30] | (b[31] << 8);
+        _sourceWidth = b[32] | (b[33] << 8);
+        _sourceHeight = b[34] | (b[35] << 8);
+        _rowStep = Math.Max(1, (int)b[36]);
+
+        // Rows the firmware sent but that never arrived count as missing too
+        int pixelBytes = width * height;
+        EnsurePixelBuf(pixelBytes);
+        Buffer.BlockCopy(_rowFrames[ch], 0, _pixelBuf, 0, pixelBytes);
+        for (int r = 0; r < height; r++)
+        {
+            if (got[r]) continue;
+            bool flagged = (r >> 3) < _missingLen && (_missingRows[r >> 3] & (1 << (r & 7))) != 0;
+            Array.Clear(_pixelBuf, r * width, width);
+            if (flagged) continue;
+            _missingRows[r >> 3] |= (byte)(1 << (r & 7));
+            _missingLen = Math.Max(_missingLen, (r >> 3) + 1);
+            _fwLinesPlaced = Math.Max(0, _fwLinesPlaced - 1);
+        }
+
+        _changedRows = _rowCounts[ch];
+        _rowCounts[ch] = 0;
+        Array.Clear(got);
+        EmitFrame();
+    }
+
+    private void EnsurePixelBuf(int pixelBytes)
+    {
+        if (_pixelBuf.Length != pixelBytes)
+            _pixelBuf = new byte[pixelBytes];
+    }
+
+    private void StoreReference(byte[] frame)
+    {
+        if (_refFrames[_channel].Length != frame.Length)
+            _refFrames[_channel] = new byte[frame.Length];
+        Buffer.BlockCopy(frame, 0, _refFrames[_channel], 0, frame.Length);
+        _refValid[_channel] = true;
+        _refFrameIds[_channel] = _fwFrameId;
+    }
+
+    /// <summary>
+    /// True if the current packet is the frame after its channel's delta
+    /// base.  The firmware numbers only frames it hands to the sender, so
+    /// a gap means packets were lost on the way.
+    /// </summary>
+    private bool FollowsReference()
+    {
+        uint next = _refFrameIds[_channel] + 1;
+        return _hasTiming ? _fwFrameId == next : (ushort)_fwFrameId == (ushort)next;
+    }
+
+    private void InvalidateReferences() => Array.Clear(_refValid);
+
+    /// <summary>
+    /// Abandon the packet being read: a bad header or a mid-packet resync
+    /// means bytes were lost, so a delta may have been too.
+    /// </summary>
+    private void Resync()
+    {
+        _syncLosses++;
+        InvalidateReferences();
+        _state = State.ScanMagic0;
+    }
+
+    private void RequestKeyframe()
+    {
+        if (_keyframeRequested) return;
+        _keyframeRequested = true;
+        OnKeyframeNeeded?.Invoke();
+    }
+
+    /// <summary>
+    /// Transit time of the current frame above the fastest one seen:
+    /// the host and RP2350 clocks are not synchronised, so the smallest
+    /// (host − firmware) offset stands in for the fixed part of the path.
+    /// </summary>
+    private double UpdateLatency(long hostUs)
+    {
+        double offset = hostUs - (double)_fwTimestampUs;
+        if (double.IsNaN(_minOffsetUs))
+        {
+            _minOffsetUs = offset;
+        }
+        else
+        {
+            _minOffsetUs += (hostUs - _lastOffsetHostUs) * OFFSET_DRIFT_PPM * 1e-6;
+            if (offset < _minOffsetUs) _minOffsetUs = offset;
+        }
+        _lastOffsetHostUs = hostUs;
+        return offset - _minOffsetUs;
     }
 
     private void EmitFrame()
     {
         _frameCount++;
 
-        // Copy pixel data to a new buffer for the subscriber
-        var frame = new byte[_pixelBuf.Length];
-        Buffer.BlockCopy(_pixelBuf, 0, frame, 0, frame.Length);
+        // Line mask: v2 headers flag rows the firmware did not receive,
+        // otherwise every row counts as valid (firmware CRC-verified them)
+        var lineValid = AllLinesValid(_frameHeight);
+        int linesReceived = _frameHeight;
+        if (_hasTiming)
+        {
+            for (int r = 0; r < _frameHeight && (r >> 3) < _missingLen; r++)
+                if ((_missingRows[r >> 3] & (1 << (r & 7))) != 0)
+                {
+                    if (ReferenceEquals(lineValid, _allValid))
+                        lineValid = (bool[])lineValid.Clone();
+                    lineValid[r] = false;
+                }
+            linesReceived = _fwLinesPlaced;
+        }
+
+        long hostUs = Stopwatch.GetTimestamp() * 1_000_000 / Stopwatch.Frequency;
 
-        // Build all-valid line mask (firmware already CRC-verified everything)
-        var lineValid = new bool[_frameHeight];
-        Array.Fill(lineValid, true);
+        // Statistics belong to this frame if sent for it (legacy headers carry 16 id bits)
+        var stats = _pendingStats;
+        _pendingStats = null;
+        if (stats != null && (stats.Channel != _channel ||
+            (_hasTiming ? stats.FirmwareFrameId != _fwFrameId : (ushort)stats.FirmwareFrameId != _fwFrameId)))
+            stats = null;
 
         var meta = new LvdsFrameMeta
         {
             FrameId = _frameCount,
+            Channel = _channel,
             Width = _frameWidth,
             Height = _frameHeight,
-            LinesReceived = _frameHeight,  // firmware sends complete frames
-            ValidLines = _frameHeight,
+            LinesReceived = linesReceived,
+            ValidLines = linesReceived,
             LinesExpected = _frameHeight,
             LineValidityMask = lineValid,
+            ChangedRows = _changedRows,
+            FirmwareFrameId = _fwFrameId,
+            FirmwareTimestampUs = _hasTiming ? _fwTimestampUs : 0,
+            HostTimestampUs = hostUs,
+            RelativeLatencyUs = _hasTiming ? UpdateLatency(hostUs) : -1,
+            RoiX = _roiX,
+            RoiY = _roiY,
+            RowStep = _rowStep,
+            SourceWidth = _sourceWidth > 0 ? _sourceWidth : _frameWidth,
+            SourceHeight = _sourceWidth > 0 ? _sourceHeight : _frameHeight,
             SyncLosses = _syncLosses,
             CrcErrors = 0,        // CRC is checked on firmware side
             ParityErrors = 0,
             TotalBytes = _totalBytes,
+            Stats = stats,
         };
+        TraceLog.Instant(TraceEvent.ReceiverFrame, _frameCount, _channel);
 
-        OnFrameReady?.Invoke(frame, meta);
+        var onFrame = OnFrameReady;
+        if (onFrame != null)
+        {
+            // Copy pixel data to a new buffer for the subscriber
+            var frame = new byte[_pixelBuf.Length];
+            Buffer.BlockCopy(_pixelBuf, 0, frame, 0, frame.Length);
+            onFrame(frame, meta);
+        }
+
+        var onLease = OnFrameLeased;
+        if (onLease != null)
+        {
+            var lease = FramePool.Rent(_pixelBuf, meta);
+            try
+            {
+                onLease(lease);
+            }
+            finally
+            {
+                lease.Dispose();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Mask of a frame with every row received, shared by all such frames
+    /// of the same height instead of allocating one per frame.
+    /// </summary>
+    private bool[] AllLinesValid(int height)
+    {
+        if (_allValid.Length != height)
+        {
+            _allValid = new bool[height];
+            Array.Fill(_allValid, true);
+        }
+        return _allValid;
+    }
+
+    /// <summary>Packets without a v3 header are whole frames.</summary>
+    private void ResetWindow()
+    {
+        _roiX = 0;
+        _roiY = 0;
+        _rowStep = 1;
+        _sourceWidth = 0;
+        _sourceHeight = 0;
     }
 
     public void Dispose() { }
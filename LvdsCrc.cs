@@ -1,4 +1,10 @@
 using System;
+using System.Buffers.Binary;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Runtime.Intrinsics;
+using System.Runtime.Intrinsics.X86;
+using ArmCrc32 = System.Runtime.Intrinsics.Arm.Crc32;
 
 namespace VilsSharpX;
 
@@ -12,6 +18,12 @@ namespace VilsSharpX;
 /// Osram: CRC-32 (ISO-HDLC / Ethernet / ZIP, poly 0x04C11DB7, init 0xFFFFFFFF, reflected)
 ///   — matches TriCore __crc32lw intrinsic with __shuffle bit-reflection
 ///   — seed = UART_APPL_2_CRC32_SEED_VALUE (0xFFFFFFFF)
+///
+/// ComputeCrc16/ComputeCrc32 use slicing-by-8 tables (8 bytes per step);
+/// CRC-32 uses PCLMULQDQ folding on x86 or the CRC32 instructions on ARM
+/// when the CPU has them (<see cref="Crc32Hardware"/>).  The byte-at-a-time
+/// *Bytewise versions are the reference the self-test holds them to.
+/// VerifyLinesCrc16/VerifyLinesCrc32 check every line of a frame in one call.
 /// </summary>
 public static class LvdsCrc
 {
@@ -23,13 +35,15 @@ public static class LvdsCrc
     // XorOut:  0x0000
     // Used by: Nichia (ioHwAbsTLD816K_Crc16)
     //
-    // Uses a 256-entry lookup table for performance.
+    // Slicing-by-8: table k holds the CRC of a byte followed by k zero
+    // bytes, so 8 input bytes are folded with 8 independent lookups.
+    // Crc16Table[0..255] is the classic single-byte table.
 
     private static readonly ushort[] Crc16Table = BuildCrc16Table(0x1021);
 
     private static ushort[] BuildCrc16Table(ushort poly)
     {
-        var table = new ushort[256];
+        var table = new ushort[8 * 256];
         for (int i = 0; i < 256; i++)
         {
             ushort crc = (ushort)(i << 8);
@@ -37,6 +51,14 @@ public static class LvdsCrc
                 crc = (ushort)((crc & 0x8000) != 0 ? (crc << 1) ^ poly : crc << 1);
             table[i] = crc;
         }
+        for (int k = 1; k < 8; k++)
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                ushort prev = table[(k - 1) * 256 + i];
+                table[k * 256 + i] = (ushort)((prev << 8) ^ table[prev >> 8]);
+            }
+        }
         return table;
     }
 
@@ -44,6 +66,37 @@ public static class LvdsCrc
     /// Compute CRC-16/CCITT-FALSE over the given data span.
     /// </summary>
     public static ushort ComputeCrc16(ReadOnlySpan<byte> data)
+    {
+        uint crc = 0xFFFF;
+        ref ushort t = ref MemoryMarshal.GetArrayDataReference(Crc16Table);
+        ref byte p = ref MemoryMarshal.GetReference(data);
+        int n = data.Length;
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            // The CRC register lines up with the first two bytes of the block
+            ulong v = Unsafe.ReadUnaligned<ulong>(ref Unsafe.Add(ref p, i));
+            if (!BitConverter.IsLittleEndian) v = BinaryPrimitives.ReverseEndianness(v);
+            uint b0 = (uint)(v & 0xFF) ^ (crc >> 8);
+            uint b1 = (uint)((v >> 8) & 0xFF) ^ (crc & 0xFF);
+            crc = (uint)(Unsafe.Add(ref t, 7 * 256 + (int)b0) ^
+                         Unsafe.Add(ref t, 6 * 256 + (int)b1) ^
+                         Unsafe.Add(ref t, 5 * 256 + (int)((v >> 16) & 0xFF)) ^
+                         Unsafe.Add(ref t, 4 * 256 + (int)((v >> 24) & 0xFF)) ^
+                         Unsafe.Add(ref t, 3 * 256 + (int)((v >> 32) & 0xFF)) ^
+                         Unsafe.Add(ref t, 2 * 256 + (int)((v >> 40) & 0xFF)) ^
+                         Unsafe.Add(ref t, 1 * 256 + (int)((v >> 48) & 0xFF)) ^
+                         Unsafe.Add(ref t, (int)(v >> 56)));
+        }
+        for (; i < n; i++)
+            crc = ((crc << 8) ^ Unsafe.Add(ref t, (int)(((crc >> 8) ^ Unsafe.Add(ref p, i)) & 0xFF))) & 0xFFFF;
+        return (ushort)crc;
+    }
+
+    /// <summary>
+    /// Reference CRC-16/CCITT-FALSE, one table lookup per byte.
+    /// </summary>
+    public static ushort ComputeCrc16Bytewise(ReadOnlySpan<byte> data)
     {
         ushort crc = 0xFFFF;
         for (int i = 0; i < data.Length; i++)
@@ -82,12 +135,16 @@ public static class LvdsCrc
     // RefOut:  true
     // XorOut:  0xFFFFFFFF
     // Used by: Osram (TriCore __crc32lw + __shuffle)
+    //
+    // Slicing-by-8 as for CRC-16, reflected.  This is the polynomial of the
+    // ARM CRC32 instructions; on x86 (whose crc32 instruction is CRC-32C)
+    // 64-byte blocks are folded with carry-less multiplies instead.
 
     private static readonly uint[] Crc32Table = BuildCrc32Table(0xEDB88320u);
 
     private static uint[] BuildCrc32Table(uint poly)
     {
-        var table = new uint[256];
+        var table = new uint[8 * 256];
         for (uint i = 0; i < 256; i++)
         {
             uint crc = i;
@@ -95,13 +152,52 @@ public static class LvdsCrc
                 crc = (crc & 1) != 0 ? (crc >> 1) ^ poly : crc >> 1;
             table[i] = crc;
         }
+        for (int k = 1; k < 8; k++)
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                uint prev = table[(k - 1) * 256 + i];
+                table[k * 256 + i] = (prev >> 8) ^ table[prev & 0xFF];
+            }
+        }
         return table;
     }
 
+    /// <summary>
+    /// CRC-32 instruction set used by <see cref="ComputeCrc32(ReadOnlySpan{byte})"/>,
+    /// or null if it runs on the slicing-by-8 tables.
+    /// </summary>
+    public static string? Crc32Hardware { get; } =
+        ArmCrc32.Arm64.IsSupported ? "ARM CRC32" :
+        Pclmulqdq.IsSupported && Sse41.IsSupported ? "PCLMULQDQ" : null;
+
     /// <summary>
     /// Compute CRC-32 (ISO-HDLC) over the given data span.
     /// </summary>
     public static uint ComputeCrc32(ReadOnlySpan<byte> data)
+    {
+        uint crc = 0xFFFFFFFF;
+        if (ArmCrc32.Arm64.IsSupported)
+            crc = UpdateCrc32Arm(crc, data);
+        else if (Pclmulqdq.IsSupported && Sse41.IsSupported && data.Length >= 64)
+            crc = UpdateCrc32Pclmul(crc, data);
+        else
+            crc = UpdateCrc32Slicing(crc, data);
+        return crc ^ 0xFFFFFFFF;
+    }
+
+    /// <summary>
+    /// CRC-32 (ISO-HDLC) on the slicing-by-8 tables only, whatever the CPU.
+    /// </summary>
+    public static uint ComputeCrc32Slicing8(ReadOnlySpan<byte> data)
+    {
+        return UpdateCrc32Slicing(0xFFFFFFFF, data) ^ 0xFFFFFFFF;
+    }
+
+    /// <summary>
+    /// Reference CRC-32 (ISO-HDLC), one table lookup per byte.
+    /// </summary>
+    public static uint ComputeCrc32Bytewise(ReadOnlySpan<byte> data)
     {
         uint crc = 0xFFFFFFFF;
         for (int i = 0; i < data.Length; i++)
@@ -112,6 +208,109 @@ public static class LvdsCrc
         return crc ^ 0xFFFFFFFF;
     }
 
+    private static uint UpdateCrc32Slicing(uint crc, ReadOnlySpan<byte> data)
+    {
+        ref uint t = ref MemoryMarshal.GetArrayDataReference(Crc32Table);
+        ref byte p = ref MemoryMarshal.GetReference(data);
+        int n = data.Length;
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            uint lo = BinaryPrimitives.ReadUInt32LittleEndian(data.Slice(i)) ^ crc;
+            uint hi = BinaryPrimitives.ReadUInt32LittleEndian(data.Slice(i + 4));
+            crc = Unsafe.Add(ref t, 7 * 256 + (int)(lo & 0xFF)) ^
+                  Unsafe.Add(ref t, 6 * 256 + (int)((lo >> 8) & 0xFF)) ^
+                  Unsafe.Add(ref t, 5 * 256 + (int)((lo >> 16) & 0xFF)) ^
+                  Unsafe.Add(ref t, 4 * 256 + (int)(lo >> 24)) ^
+                  Unsafe.Add(ref t, 3 * 256 + (int)(hi & 0xFF)) ^
+                  Unsafe.Add(ref t, 2 * 256 + (int)((hi >> 8) & 0xFF)) ^
+                  Unsafe.Add(ref t, 1 * 256 + (int)((hi >> 16) & 0xFF)) ^
+                  Unsafe.Add(ref t, (int)(hi >> 24));
+        }
+        for (; i < n; i++)
+            crc = (crc >> 8) ^ Unsafe.Add(ref t, (int)((crc ^ Unsafe.Add(ref p, i)) & 0xFF));
+        return crc;
+    }
+
+    private static uint UpdateCrc32Arm(uint crc, ReadOnlySpan<byte> data)
+    {
+        int i = 0;
+        for (; i + 8 <= data.Length; i += 8)
+            crc = ArmCrc32.Arm64.ComputeCrc32(crc, BinaryPrimitives.ReadUInt64LittleEndian(data.Slice(i)));
+        for (; i < data.Length; i++)
+            crc = ArmCrc32.ComputeCrc32(crc, data[i]);
+        return crc;
+    }
+
+    // Folding constants for the reflected polynomial (x^n mod P, bit-reversed),
+    // as in "Fast CRC Computation Using PCLMULQDQ" (Intel, 2009)
+    private const ulong FoldK1 = 0x154442bd4;     // x^(4*128+32), fold 4 × 128 bits
+    private const ulong FoldK2 = 0x1c6e41596;     // x^(4*128-32)
+    private const ulong FoldK3 = 0x1751997d0;     // x^(128+32),   fold 1 × 128 bits
+    private const ulong FoldK4 = 0x0ccaa009e;     // x^(128-32)
+    private const ulong FoldK5 = 0x163cd6124;     // x^64,         128 -> 64 bits
+    private const ulong BarrettP = 0x1db710641;   // P
+    private const ulong BarrettU = 0x1f7011641;   // x^64 / P
+
+    /// <summary>
+    /// Running CRC-32 over <paramref name="data"/> (at least 64 bytes): whole 16-byte
+    /// blocks are folded with PCLMULQDQ and reduced, the rest goes through the tables.
+    /// </summary>
+    private static uint UpdateCrc32Pclmul(uint crc, ReadOnlySpan<byte> data)
+    {
+        ref byte p = ref MemoryMarshal.GetReference(data);
+        int blocks = data.Length & ~15;
+
+        var x1 = Load(ref p, 0) ^ Vector128.CreateScalar(crc).AsUInt64();
+        var x2 = Load(ref p, 16);
+        var x3 = Load(ref p, 32);
+        var x4 = Load(ref p, 48);
+        int i = 64;
+
+        var k = Vector128.Create(FoldK1, FoldK2);
+        for (; i + 64 <= blocks; i += 64)
+        {
+            x1 = Fold(x1, k, Load(ref p, i));
+            x2 = Fold(x2, k, Load(ref p, i + 16));
+            x3 = Fold(x3, k, Load(ref p, i + 32));
+            x4 = Fold(x4, k, Load(ref p, i + 48));
+        }
+
+        k = Vector128.Create(FoldK3, FoldK4);
+        x1 = Fold(x1, k, x2);
+        x1 = Fold(x1, k, x3);
+        x1 = Fold(x1, k, x4);
+        for (; i < blocks; i += 16)
+            x1 = Fold(x1, k, Load(ref p, i));
+
+        // 128 -> 64 bits (appending the 32 zero bits of the CRC)
+        var mask32 = Vector128.Create(0xFFFFFFFFul, 0);
+        var t = Pclmulqdq.CarrylessMultiply(k, x1, 0x01);
+        x1 = Sse2.ShiftRightLogical128BitLane(x1, 8) ^ t;
+        t = Pclmulqdq.CarrylessMultiply(x1 & mask32, Vector128.CreateScalar(FoldK5), 0x00);
+        x1 = Sse2.ShiftRightLogical128BitLane(x1, 4) ^ t;
+
+        // Barrett reduction 64 -> 32 bits
+        var pu = Vector128.Create(BarrettP, BarrettU);
+        t = Pclmulqdq.CarrylessMultiply(x1 & mask32, pu, 0x10);
+        t = Pclmulqdq.CarrylessMultiply(t & mask32, pu, 0x00);
+        crc = Sse41.Extract((x1 ^ t).AsUInt32(), 1);
+
+        return UpdateCrc32Slicing(crc, data.Slice(blocks));
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static Vector128<ulong> Load(ref byte p, int offset)
+    {
+        return Unsafe.ReadUnaligned<Vector128<ulong>>(ref Unsafe.Add(ref p, offset));
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static Vector128<ulong> Fold(Vector128<ulong> x, Vector128<ulong> k, Vector128<ulong> next)
+    {
+        return Pclmulqdq.CarrylessMultiply(x, k, 0x00) ^ Pclmulqdq.CarrylessMultiply(x, k, 0x11) ^ next;
+    }
+
     /// <summary>
     /// Compute CRC-32 over a byte array with offset and length.
     /// </summary>
@@ -133,6 +332,54 @@ public static class LvdsCrc
     }
 
 
+    // ── Per-frame batch verification ───────────────────────────────────
+    // Line r of a frame is lineLen bytes at r × stride in `pixels`.  It is
+    // checked only if check[r], against expected[r]; ok[r] gets the result
+    // (false for lines not checked).  Both return the number of failures.
+
+    /// <summary>
+    /// Verify the CRC-16 of every received line of a Nichia frame in one call.
+    /// </summary>
+    public static int VerifyLinesCrc16(ReadOnlySpan<byte> pixels, int stride, int lineLen,
+                                       ReadOnlySpan<uint> expected, ReadOnlySpan<bool> check, Span<bool> ok)
+    {
+        int failed = 0;
+        for (int r = 0; r < check.Length; r++)
+        {
+            if (!check[r])
+            {
+                ok[r] = false;
+                continue;
+            }
+            bool good = ComputeCrc16(pixels.Slice(r * stride, lineLen)) == expected[r];
+            ok[r] = good;
+            if (!good) failed++;
+        }
+        return failed;
+    }
+
+    /// <summary>
+    /// Verify the CRC-32 of every received line of an Osram frame in one call.
+    /// </summary>
+    public static int VerifyLinesCrc32(ReadOnlySpan<byte> pixels, int stride, int lineLen,
+                                       ReadOnlySpan<uint> expected, ReadOnlySpan<bool> check, Span<bool> ok)
+    {
+        int failed = 0;
+        for (int r = 0; r < check.Length; r++)
+        {
+            if (!check[r])
+            {
+                ok[r] = false;
+                continue;
+            }
+            bool good = ComputeCrc32(pixels.Slice(r * stride, lineLen)) == expected[r];
+            ok[r] = good;
+            if (!good) failed++;
+        }
+        return failed;
+    }
+
+
     // ── Self-test ───────────────────────────────────────────────────────
 
     /// <summary>
@@ -247,6 +494,65 @@ public static class LvdsCrc
                 $"verify={shouldBeFalse} (expect false)"));
         }
 
+        // ── Fast paths against the bytewise reference ───────────────
+        // Every length up to two Osram lines and every alignment of the
+        // 8-byte / 64-byte blocks, over pseudo-random data
+        {
+            var rng = new Random(0x5D);
+            byte[] buf = new byte[2 * LvdsProtocol.OsramW + 16];
+            rng.NextBytes(buf);
+            string fail16 = "", fail32 = "", failSl = "";
+            for (int off = 0; off < 16; off += 5)
+            {
+                for (int len = 0; len + off <= buf.Length && len <= 2 * LvdsProtocol.OsramW; len++)
+                {
+                    var d = buf.AsSpan(off, len);
+                    if (fail16.Length == 0 && ComputeCrc16(d) != ComputeCrc16Bytewise(d))
+                        fail16 = $"off={off} len={len}: 0x{ComputeCrc16(d):X4} vs 0x{ComputeCrc16Bytewise(d):X4}";
+                    if (fail32.Length == 0 && ComputeCrc32(d) != ComputeCrc32Bytewise(d))
+                        fail32 = $"off={off} len={len}: 0x{ComputeCrc32(d):X8} vs 0x{ComputeCrc32Bytewise(d):X8}";
+                    if (failSl.Length == 0 && ComputeCrc32Slicing8(d) != ComputeCrc32Bytewise(d))
+                        failSl = $"off={off} len={len}: 0x{ComputeCrc32Slicing8(d):X8} vs 0x{ComputeCrc32Bytewise(d):X8}";
+                }
+            }
+            results.Add(("CRC16 slicing-by-8 = bytewise", fail16.Length == 0,
+                fail16.Length == 0 ? "lengths 0..640, 4 alignments" : fail16));
+            results.Add(("CRC32 slicing-by-8 = bytewise", failSl.Length == 0,
+                failSl.Length == 0 ? "lengths 0..640, 4 alignments" : failSl));
+            results.Add(($"CRC32 {Crc32Hardware ?? "(no hardware path)"} = bytewise", fail32.Length == 0,
+                fail32.Length == 0 ? "lengths 0..640, 4 alignments" : fail32));
+        }
+
+        // ── Batch verification of a whole frame ─────────────────────
+        // Lines 3 and 40 corrupted, line 7 not received
+        foreach (bool crc32 in new[] { false, true })
+        {
+            int w = crc32 ? LvdsProtocol.OsramW : LvdsProtocol.NichiaW;
+            int h = crc32 ? LvdsProtocol.OsramH_Lvds : LvdsProtocol.NichiaH_Lvds;
+            var rng = new Random(w);
+            byte[] frame = new byte[w * h];
+            rng.NextBytes(frame);
+            var expected = new uint[h];
+            var check = new bool[h];
+            var ok = new bool[h];
+            for (int r = 0; r < h; r++)
+            {
+                var line = frame.AsSpan(r * w, w);
+                expected[r] = crc32 ? ComputeCrc32Bytewise(line) : ComputeCrc16Bytewise(line);
+                check[r] = r != 7;
+            }
+            frame[3 * w + 17] ^= 0x01;
+            frame[40 * w] ^= 0x80;
+            int failed = crc32
+                ? VerifyLinesCrc32(frame, w, w, expected, check, ok)
+                : VerifyLinesCrc16(frame, w, w, expected, check, ok);
+            int okCount = 0;
+            foreach (bool o in ok) if (o) okCount++;
+            bool pass = failed == 2 && !ok[3] && !ok[40] && !ok[7] && okCount == h - 3;
+            results.Add(($"{(crc32 ? "CRC32" : "CRC16")} batch verify {h} lines", pass,
+                $"failed={failed} (expect 2), ok={okCount} (expect {h - 3})"));
+        }
+
         // ── Nichia row parity round-trip ────────────────────────────
         {
             bool allOk = true;
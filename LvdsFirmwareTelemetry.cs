@@ -0,0 +1,236 @@
+using System;
+using System.Buffers.Binary;
+using System.Text;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// One telemetry packet from the Pico 2 firmware (host command 'T').
+///
+///   [0xFE] [0xEC] [version] [reserved] [len:2]   — len = body bytes that follow
+///   body (version 1, little-endian):
+///   [uptime_us:8] [mode] [flags] [comp_mode] [pace_div] [baud:4]
+///   [counters: 20 × uint32]                      — FramesSent … LineRecordDrops below
+///   [hist_buckets] [reserved:3]
+///   [parse / send / usb histograms: 3 × hist_buckets × uint32]
+///   [ring_overruns:4] [parse_ps_per_byte:4]      — later counters, may be absent
+///   [gen_frames:4] [gen_late:4]
+///
+/// The firmware never stops capture to send it.  Counters and histograms
+/// are cumulative; <see cref="LatencySince"/> gives the per-interval view.
+/// Histogram bucket 0 counts 0 µs, bucket b counts [2^(b-1), 2^b) µs and
+/// the last bucket everything above.
+/// </summary>
+public sealed record LvdsFirmwareTelemetry
+{
+    public const byte Magic1 = 0xEC;
+    public const int HeaderSize = 6;   // FE EC ver rsvd len16
+    public const int MaxBodySize = 1024;
+
+    private const int FixedSize = 16;
+    private const int CounterCount = 20;
+
+    public int Version { get; init; }
+    /// <summary>RP2350 time_us_64() when the packet was built.</summary>
+    public ulong UptimeUs { get; init; }
+    public bool IsNichia { get; init; }
+    /// <summary>Line format uploaded ('U') or detected ('A') rather than a built-in one.</summary>
+    public bool IsCustomFormat { get; init; }
+    public bool CrcReject { get; init; }
+    public bool DeltaEnabled { get; init; }
+    public bool LineMode { get; init; }
+    /// <summary>Links captured by the bridge (2 for dual-link firmware).</summary>
+    public int LinkCount { get; init; } = 1;
+    /// <summary>Synthetic line generator ('G') running.</summary>
+    public bool GeneratorOn { get; init; }
+    /// <summary>USB sender in packed mode ('X' 1): whole-packet transfers, one flush per frame.</summary>
+    public bool UsbTxPacked { get; init; }
+    public LvdsCompressionMode Compression { get; init; }
+    public int PaceDivider { get; init; }
+    public uint Baud { get; init; }
+
+    public uint FramesSent { get; init; }
+    public uint FramesDropped { get; init; }
+    public uint CrcOkLines { get; init; }
+    public uint CrcErrors { get; init; }
+    public uint RowSequenceSkips { get; init; }
+    public uint GapBytes { get; init; }
+    public uint GapResyncs { get; init; }
+    public uint MaxRingFill { get; init; }
+    public uint UsbBytes { get; init; }
+    public uint LinkBytesPerSec { get; init; }
+    /// <summary>Achieved output FPS × 10.</summary>
+    public uint LinkFpsX10 { get; init; }
+    public uint QueueHighWater { get; init; }
+    public uint KeyFrames { get; init; }
+    public uint DeltaFrames { get; init; }
+    public uint DeltaRows { get; init; }
+    public uint CompressedFrames { get; init; }
+    public uint CompressedInBytes { get; init; }
+    public uint CompressedOutBytes { get; init; }
+    public uint LineRecords { get; init; }
+    public uint LineRecordDrops { get; init; }
+    /// <summary>Times the capture DMA lapped the parser (0 from firmware that does not report it).</summary>
+    public uint RingOverruns { get; init; }
+    /// <summary>Measured parser cost in picoseconds per ring byte (0 if not reported).</summary>
+    public uint ParsePsPerByte { get; init; }
+    /// <summary>Frames sent by the firmware line generator.</summary>
+    public uint GeneratorFrames { get; init; }
+    /// <summary>Generator frames that started over a frame period late (rate above the line rate).</summary>
+    public uint GeneratorLate { get; init; }
+    /// <summary>Bulk IN transfers completed by the firmware.</summary>
+    public uint UsbTransfers { get; init; }
+    /// <summary>USB packets in those transfers, zero-length packets included.</summary>
+    public uint UsbPackets { get; init; }
+    public uint UsbZeroLengthPackets { get; init; }
+    /// <summary>Packets per second against the FS bulk ceiling (19 per ms), per mille.</summary>
+    public uint UsbBusPermille { get; init; }
+    /// <summary>Frame statistics ('H') are on.</summary>
+    public bool FrameStatsOn { get; init; }
+    /// <summary>Frame statistics packets sent.</summary>
+    public uint FrameStatsPackets { get; init; }
+
+    /// <summary>Parser pass durations (passes that consumed ring data).</summary>
+    public uint[] ParseHistogram { get; init; } = Array.Empty<uint>();
+    /// <summary>send_frame_chunk() call durations.</summary>
+    public uint[] SendHistogram { get; init; } = Array.Empty<uint>();
+    /// <summary>tud_task() call durations.</summary>
+    public uint[] UsbHistogram { get; init; } = Array.Empty<uint>();
+
+    /// <summary>Packet body as received, for <see cref="LvdsCaptureWriter"/> (parse again with <see cref="TryParse"/>).</summary>
+    public byte[] Body { get; init; } = Array.Empty<byte>();
+
+    /// <summary>
+    /// Parse a packet body (the bytes after the 6-byte header).
+    /// Returns null if the version is unknown or the body is too short;
+    /// longer bodies from newer firmware are accepted.
+    /// </summary>
+    public static LvdsFirmwareTelemetry? TryParse(int version, ReadOnlySpan<byte> body)
+    {
+        if (version != 1 || body.Length < FixedSize + CounterCount * 4 + 4)
+            return null;
+
+        var c = new uint[CounterCount];
+        for (int i = 0; i < CounterCount; i++)
+            c[i] = BinaryPrimitives.ReadUInt32LittleEndian(body.Slice(FixedSize + i * 4));
+
+        int histOff = FixedSize + CounterCount * 4;
+        int buckets = body[histOff];
+        histOff += 4;
+        if (body.Length < histOff + 3 * buckets * 4)
+            return null;
+
+        int extOff = histOff + 3 * buckets * 4;
+
+        byte flags = body[9];
+        return new LvdsFirmwareTelemetry
+        {
+            Version = version,
+            UptimeUs = BinaryPrimitives.ReadUInt64LittleEndian(body),
+            IsNichia = body[8] == 0,
+            IsCustomFormat = body[8] == 2,
+            CrcReject = (flags & 0x01) != 0,
+            DeltaEnabled = (flags & 0x02) != 0,
+            LineMode = (flags & 0x04) != 0,
+            LinkCount = (flags & 0x10) != 0 ? 2 : 1,
+            GeneratorOn = (flags & 0x20) != 0,
+            UsbTxPacked = (flags & 0x40) != 0,
+            FrameStatsOn = (flags & 0x80) != 0,
+            Compression = (LvdsCompressionMode)body[10],
+            PaceDivider = body[11],
+            Baud = BinaryPrimitives.ReadUInt32LittleEndian(body.Slice(12)),
+            FramesSent = c[0], FramesDropped = c[1], CrcOkLines = c[2], CrcErrors = c[3],
+            RowSequenceSkips = c[4], GapBytes = c[5], GapResyncs = c[6], MaxRingFill = c[7],
+            UsbBytes = c[8], LinkBytesPerSec = c[9], LinkFpsX10 = c[10], QueueHighWater = c[11],
+            KeyFrames = c[12], DeltaFrames = c[13], DeltaRows = c[14], CompressedFrames = c[15],
+            CompressedInBytes = c[16], CompressedOutBytes = c[17], LineRecords = c[18],
+            LineRecordDrops = c[19],
+            RingOverruns = ReadExtCounter(body, extOff, 0),
+            ParsePsPerByte = ReadExtCounter(body, extOff, 1),
+            GeneratorFrames = ReadExtCounter(body, extOff, 2),
+            GeneratorLate = ReadExtCounter(body, extOff, 3),
+            UsbTransfers = ReadExtCounter(body, extOff, 4),
+            UsbPackets = ReadExtCounter(body, extOff, 5),
+            UsbZeroLengthPackets = ReadExtCounter(body, extOff, 6),
+            UsbBusPermille = ReadExtCounter(body, extOff, 7),
+            FrameStatsPackets = ReadExtCounter(body, extOff, 8),
+            ParseHistogram = ReadHistogram(body, histOff, buckets),
+            SendHistogram = ReadHistogram(body, histOff + buckets * 4, buckets),
+            UsbHistogram = ReadHistogram(body, histOff + 2 * buckets * 4, buckets),
+            Body = body.ToArray(),
+        };
+    }
+
+    private static uint ReadExtCounter(ReadOnlySpan<byte> body, int extOff, int index)
+    {
+        int off = extOff + index * 4;
+        return body.Length >= off + 4 ? BinaryPrimitives.ReadUInt32LittleEndian(body.Slice(off)) : 0;
+    }
+
+    private static uint[] ReadHistogram(ReadOnlySpan<byte> body, int offset, int buckets)
+    {
+        var h = new uint[buckets];
+        for (int i = 0; i < buckets; i++)
+            h[i] = BinaryPrimitives.ReadUInt32LittleEndian(body.Slice(offset + i * 4));
+        return h;
+    }
+
+    /// <summary>
+    /// Histogram counts accumulated since an earlier packet (bucket-wise difference).
+    /// Counts that went backwards (firmware reboot) are reported as-is.
+    /// </summary>
+    public static uint[] LatencySince(uint[] now, uint[] earlier)
+    {
+        var d = new uint[now.Length];
+        for (int i = 0; i < now.Length; i++)
+        {
+            uint e = i < earlier.Length ? earlier[i] : 0;
+            d[i] = now[i] >= e ? now[i] - e : now[i];
+        }
+        return d;
+    }
+
+    /// <summary>
+    /// Upper bound (µs) of the bucket that holds the <paramref name="fraction"/>
+    /// percentile.  The open last bucket reports its lower bound doubled.
+    /// </summary>
+    public static int PercentileUs(uint[] histogram, double fraction)
+    {
+        long total = 0;
+        foreach (var n in histogram) total += n;
+        if (total == 0) return 0;
+
+        long target = (long)Math.Ceiling(total * fraction), seen = 0;
+        for (int b = 0; b < histogram.Length; b++)
+        {
+            seen += histogram[b];
+            if (seen >= target) return 1 << b;
+        }
+        return 1 << (histogram.Length - 1);
+    }
+
+    /// <summary>Single-line summary in the style of the firmware 'S' response.</summary>
+    public override string ToString()
+    {
+        var sb = new StringBuilder(256);
+        sb.Append($"MODE={(IsNichia ? "NICHIA" : IsCustomFormat ? "CUSTOM" : "OSRAM")} BAUD={Baud} CRC={(CrcReject ? "REJECT" : "COUNT")} ");
+        sb.Append($"PACE={(PaceDivider > 1 ? PaceDivider : 0)} FPS={LinkFpsX10 / 10}.{LinkFpsX10 % 10} ");
+        sb.Append($"LINK={LinkBytesPerSec / 1024}KB/s USB={UsbBytes} SENT={FramesSent} DROP={FramesDropped} ");
+        sb.Append($"QUEUE={QueueHighWater} LINES={(LineMode ? "ON:" : "")}{LineRecords}/{LineRecordDrops} ");
+        sb.Append($"KEY={KeyFrames} DELTA={DeltaFrames}/{DeltaRows} ");
+        sb.Append($"COMP={(int)Compression}:{CompressedFrames}/{CompressedOutBytes}/{CompressedInBytes} ");
+        sb.Append($"CRC_OK={CrcOkLines} CRC_ERR={CrcErrors} ROW_SKIP={RowSequenceSkips} ");
+        sb.Append($"GAP={GapBytes} RESYNC={GapResyncs} MAXFILL={MaxRingFill} OVERRUN={RingOverruns} LINKS={LinkCount} ");
+        if (GeneratorOn || GeneratorFrames > 0)
+            sb.Append($"GEN={(GeneratorOn ? "ON" : "OFF")}:{GeneratorFrames}/{GeneratorLate} ");
+        if (UsbTransfers > 0)
+            sb.Append($"USBTX={(UsbTxPacked ? "PACKED" : "FLUSH")}:{UsbTransfers}/{UsbPackets}/{UsbZeroLengthPackets} " +
+                      $"BUS={UsbBusPermille / 10}.{UsbBusPermille % 10}% ");
+        if (FrameStatsOn || FrameStatsPackets > 0)
+            sb.Append($"STATS={(FrameStatsOn ? "ON" : "OFF")}:{FrameStatsPackets} ");
+        sb.Append($"PARSE_NS_B={ParsePsPerByte / 1000}.{ParsePsPerByte % 1000 / 100} ");
+        sb.Append($"PARSE_P99<{PercentileUs(ParseHistogram, 0.99)}us SEND_P99<{PercentileUs(SendHistogram, 0.99)}us ");
+        sb.Append($"USB_P99<{PercentileUs(UsbHistogram, 0.99)}us UPTIME={UptimeUs / 1000000}s");
+        return sb.ToString();
+    }
+}
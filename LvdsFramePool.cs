@@ -0,0 +1,137 @@
+using System;
+using System.Collections.Generic;
+using System.Threading;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// Fixed set of reusable frame buffers for <see cref="LvdsFrameLease"/>.
+///
+/// A receiver rents one lease per frame, fills it and raises it; every
+/// holder releases it with <see cref="LvdsFrameLease.Dispose"/> and the
+/// last release puts the buffer back.  Once the pool has warmed up,
+/// frame delivery allocates no pixel buffers.  If every lease is still
+/// held a new one is allocated (<see cref="Misses"/>); at most
+/// <see cref="Capacity"/> are kept when they come back.
+/// Thread-safe: leases may be released on any thread.
+/// </summary>
+public sealed class LvdsFramePool
+{
+    public const int DefaultCapacity = 8;
+
+    private readonly Stack<LvdsFrameLease> _free;
+    private readonly int _bufferSize;
+    private long _misses;
+
+    public LvdsFramePool(int capacity = DefaultCapacity, int bufferSize = 320 * 84)
+    {
+        if (capacity < 1) throw new ArgumentOutOfRangeException(nameof(capacity));
+        Capacity = capacity;
+        _bufferSize = bufferSize;
+        _free = new Stack<LvdsFrameLease>(capacity);
+        for (int i = 0; i < capacity; i++)
+            _free.Push(new LvdsFrameLease(this, bufferSize));
+    }
+
+    /// <summary>Leases kept for reuse.</summary>
+    public int Capacity { get; }
+
+    /// <summary>Rents that found the pool empty and allocated a lease.</summary>
+    public long Misses => Interlocked.Read(ref _misses);
+
+    /// <summary>Leases currently in the pool.</summary>
+    public int Available
+    {
+        get { lock (_free) return _free.Count; }
+    }
+
+    /// <summary>
+    /// Rent a lease holding a copy of <paramref name="pixels"/> and
+    /// <paramref name="meta"/>, with one reference owned by the caller.
+    /// </summary>
+    public LvdsFrameLease Rent(ReadOnlySpan<byte> pixels, LvdsFrameMeta meta)
+    {
+        LvdsFrameLease? lease = null;
+        lock (_free)
+        {
+            if (_free.Count > 0)
+                lease = _free.Pop();
+        }
+        if (lease == null || lease.Capacity < pixels.Length)
+        {
+            Interlocked.Increment(ref _misses);
+            lease = new LvdsFrameLease(this, Math.Max(_bufferSize, pixels.Length));
+        }
+        lease.Fill(pixels, meta);
+        return lease;
+    }
+
+    internal void Return(LvdsFrameLease lease)
+    {
+        lock (_free)
+        {
+            if (_free.Count < Capacity)
+                _free.Push(lease);
+        }
+    }
+}
+
+/// <summary>
+/// One pooled, reference-counted frame: pixels (active area, row-major)
+/// and their <see cref="LvdsFrameMeta"/>.
+///
+/// The code that raises a lease holds one reference for the duration of
+/// the event.  A subscriber that keeps the frame past its handler (e.g.
+/// to render it on the UI thread) calls <see cref="AddRef"/> first and
+/// <see cref="Dispose"/> when done; the pixels must not be touched after
+/// its last reference is released.
+/// </summary>
+public sealed class LvdsFrameLease : IDisposable
+{
+    private readonly LvdsFramePool _pool;
+    private readonly byte[] _buffer;
+    private int _length;
+    private int _refCount;
+
+    internal LvdsFrameLease(LvdsFramePool pool, int capacity)
+    {
+        _pool = pool;
+        _buffer = new byte[capacity];
+    }
+
+    public LvdsFrameMeta Meta { get; private set; } = new();
+
+    /// <summary>Pixel bytes of this frame (Width × Height of <see cref="Meta"/>).</summary>
+    public int Length => _length;
+
+    public ReadOnlyMemory<byte> Memory => new(_buffer, 0, _length);
+    public ReadOnlySpan<byte> Span => new(_buffer, 0, _length);
+
+    internal int Capacity => _buffer.Length;
+
+    /// <summary>Take another reference; returns this lease.</summary>
+    public LvdsFrameLease AddRef()
+    {
+        if (Interlocked.Increment(ref _refCount) <= 1)
+            throw new ObjectDisposedException(nameof(LvdsFrameLease), "Lease already returned to its pool");
+        return this;
+    }
+
+    /// <summary>Release one reference; the last one returns the buffer to the pool.</summary>
+    public void Dispose()
+    {
+        int left = Interlocked.Decrement(ref _refCount);
+        if (left == 0)
+            _pool.Return(this);
+        else if (left < 0)
+            throw new InvalidOperationException("LvdsFrameLease released more often than referenced");
+    }
+
+    internal void Fill(ReadOnlySpan<byte> pixels, LvdsFrameMeta meta)
+    {
+        pixels.CopyTo(_buffer);
+        _length = pixels.Length;
+        Meta = meta;
+        Volatile.Write(ref _refCount, 1);
+    }
+}
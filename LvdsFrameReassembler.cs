@@ -21,6 +21,12 @@ namespace VilsSharpX;
 ///
 /// State machine (per-line):
 ///   WaitSync → ReadRowByte → ReadPixels → ReadCrc → PlaceLine → (repeat)
+///
+/// Line CRCs are kept with their rows and verified together when the
+/// frame is emitted (LvdsCrc.VerifyLines*), off the per-line path.
+/// Push works on spans: sync bytes are found with a vectorized IndexOf
+/// and pixel and CRC runs are bulk copies, so only the row byte is
+/// handled one byte at a time.
 /// </summary>
 public sealed class LvdsFrameReassembler
 {
@@ -47,6 +53,7 @@ public sealed class LvdsFrameReassembler
     private readonly byte[] _frameBuf;        // W × H_LVDS pixel buffer
     private readonly bool[] _lineReceived;    // which lines have been placed
     private readonly bool[] _lineCrcOk;       // which lines passed CRC
+    private readonly uint[] _lineCrcExp;      // CRC received with each placed line
     private int _linesReceived;
 
     // Frame counter
@@ -89,6 +96,7 @@ public sealed class LvdsFrameReassembler
         _frameBuf = new byte[width * lvdsHeight];
         _lineReceived = new bool[lvdsHeight];
         _lineCrcOk = new bool[lvdsHeight];
+        _lineCrcExp = new uint[lvdsHeight];
     }
 
     // ── Public API ──────────────────────────────────────────────────────
@@ -107,25 +115,40 @@ public sealed class LvdsFrameReassembler
     /// Push a chunk of received bytes into the reassembler.
     /// Called from the serial receive thread — must be fast.
     /// </summary>
-    public void Push(byte[] data, int offset, int count)
+    public void Push(byte[] data, int offset, int count) => Push(data.AsSpan(offset, count));
+
+    /// <summary>Convenience overload — push entire buffer.</summary>
+    public void Push(byte[] data, int count) => Push(data.AsSpan(0, count));
+
+    /// <summary>
+    /// Push received bytes.  <paramref name="data"/> is not referenced after the call returns.
+    /// </summary>
+    public void Push(ReadOnlySpan<byte> data)
     {
-        _totalBytesReceived += count;
+        _totalBytesReceived += data.Length;
 
-        for (int i = offset; i < offset + count; i++)
+        int i = 0;
+        while (i < data.Length)
         {
-            byte b = data[i];
-
             switch (_state)
             {
                 case State.WaitSync:
-                    if (b == LvdsProtocol.SyncByte)
+                {
+                    // Discard everything up to the next sync byte
+                    int skip = data.Slice(i).IndexOf(LvdsProtocol.SyncByte);
+                    if (skip < 0)
                     {
-                        _state = State.ReadRowByte;
+                        i = data.Length;
+                        break;
                     }
-                    // else: discard byte, stay in WaitSync
+                    i += skip + 1;
+                    _state = State.ReadRowByte;
                     break;
+                }
 
                 case State.ReadRowByte:
+                {
+                    byte b = data[i++];
                     if (b == LvdsProtocol.SyncByte)
                     {
                         // Consecutive sync bytes — previous sync was noise; stay here
@@ -137,31 +160,39 @@ public sealed class LvdsFrameReassembler
                     _pixelPos = 0;
                     _state = State.ReadPixels;
                     break;
+                }
 
                 case State.ReadPixels:
-                    _linePixels[_pixelPos++] = b;
+                {
+                    int take = Math.Min(_frameWidth - _pixelPos, data.Length - i);
+                    data.Slice(i, take).CopyTo(_linePixels.AsSpan(_pixelPos));
+                    _pixelPos += take;
+                    i += take;
                     if (_pixelPos >= _frameWidth)
                     {
                         _crcPos = 0;
                         _state = State.ReadCrc;
                     }
                     break;
+                }
 
                 case State.ReadCrc:
-                    _crcBuf[_crcPos++] = b;
+                {
+                    int take = Math.Min(_crcLen - _crcPos, data.Length - i);
+                    data.Slice(i, take).CopyTo(_crcBuf.AsSpan(_crcPos));
+                    _crcPos += take;
+                    i += take;
                     if (_crcPos >= _crcLen)
                     {
                         PlaceLine();
                         _state = State.WaitSync;
                     }
                     break;
+                }
             }
         }
     }
 
-    /// <summary>Convenience overload — push entire buffer.</summary>
-    public void Push(byte[] data, int count) => Push(data, 0, count);
-
     /// <summary>Reset reassembler state (e.g. on device type change or reconnect).</summary>
     public void Reset()
     {
@@ -202,51 +233,18 @@ public sealed class LvdsFrameReassembler
             return;
         }
 
-        // TODO: CRC verification (diagnostic only — don't discard data)
-        // Nichia: CRC16 = _crcBuf[0]<<8 | _crcBuf[1], computed over _linePixels[0..W-1]
-        // Osram:  CRC32 from _crcBuf[0..3], computed over _linePixels with seed
-        // For now, we accept all lines regardless of CRC.
-
-        // CRC verification (diagnostic — count errors but don't discard data)
-        bool crcOk = true;
-        if (_isNichia && _crcLen >= 2)
-        {
-            if (!LvdsCrc.VerifyNichiaCrc(_linePixels, 0, _frameWidth,
-                                          _crcBuf[0], _crcBuf[1]))
-            {
-                _crcErrorCount++;
-                crcOk = false;
-                // Log first 5 CRC mismatches with detail
-                if (_crcErrorCount <= 5 && _log != null)
-                {
-                    ushort computed = LvdsCrc.ComputeCrc16(_linePixels, 0, _frameWidth);
-                    ushort received = (ushort)((_crcBuf[0] << 8) | _crcBuf[1]);
-                    _log($"[lvds-crc] CRC16 MISMATCH row={row}: computed=0x{computed:X4} received=0x{received:X4} " +
-                         $"px[0..3]=[{_linePixels[0]:X2} {_linePixels[1]:X2} {_linePixels[2]:X2} {_linePixels[3]:X2}]");
-                }
-            }
-        }
-        else if (!_isNichia && _crcLen >= 4)
-        {
-            if (!LvdsCrc.VerifyOsramCrc(_linePixels, 0, _frameWidth,
-                                         _crcBuf[0], _crcBuf[1], _crcBuf[2], _crcBuf[3]))
-            {
-                _crcErrorCount++;
-                crcOk = false;
-                if (_crcErrorCount <= 5 && _log != null)
-                {
-                    uint computed = LvdsCrc.ComputeCrc32(_linePixels, 0, _frameWidth);
-                    uint received = (uint)(_crcBuf[0] | (_crcBuf[1] << 8) | (_crcBuf[2] << 16) | (_crcBuf[3] << 24));
-                    _log($"[lvds-crc] CRC32 MISMATCH row={row}: computed=0x{computed:X8} received=0x{received:X8} " +
-                         $"px[0..3]=[{_linePixels[0]:X2} {_linePixels[1]:X2} {_linePixels[2]:X2} {_linePixels[3]:X2}]");
-                }
-            }
-        }
+        // CRC as received: Nichia CRC16 big-endian, Osram CRC32 little-endian.
+        // Verified with the rest of the frame in EmitFrame (diagnostic —
+        // count errors but don't discard data).
+        uint crcExp = _isNichia
+            ? (uint)((_crcBuf[0] << 8) | _crcBuf[1])
+            : (uint)(_crcBuf[0] | (_crcBuf[1] << 8) | (_crcBuf[2] << 16) | (_crcBuf[3] << 24));
 
         // ── Diagnostic hex log (first N lines of capture session) ───
         if (_diagLogLinesRemaining > 0 && _log != null)
         {
             _diagLogLinesRemaining--;
+            bool crcOk = !HasCrc || LineCrc(_linePixels) == crcExp;
             string crcHex = _isNichia
                 ? $"{_crcBuf[0]:X2} {_crcBuf[1]:X2}"
                 : $"{_crcBuf[0]:X2} {_crcBuf[1]:X2} {_crcBuf[2]:X2} {_crcBuf[3]:X2}";
@@ -271,8 +269,7 @@ public sealed class LvdsFrameReassembler
             _lineReceived[row] = true;
             _linesReceived++;
         }
-        if (crcOk)
-            _lineCrcOk[row] = true;
+        _lineCrcExp[row] = crcExp;
 
         // Also emit when all lines have been received (normal completion)
         if (_linesReceived >= _frameHeightLvds)
@@ -281,9 +278,50 @@ public sealed class LvdsFrameReassembler
         }
     }
 
+    private bool HasCrc => _isNichia ? _crcLen >= 2 : _crcLen >= 4;
+
+    private uint LineCrc(ReadOnlySpan<byte> pixels)
+    {
+        return _isNichia ? LvdsCrc.ComputeCrc16(pixels) : LvdsCrc.ComputeCrc32(pixels);
+    }
+
+    /// <summary>
+    /// Verify the CRC of every line placed in this frame and count the failures.
+    /// Lines without a CRC in this format pass.
+    /// </summary>
+    private void VerifyFrameCrcs()
+    {
+        if (!HasCrc)
+        {
+            Array.Copy(_lineReceived, _lineCrcOk, _lineReceived.Length);
+            return;
+        }
+        int failed = _isNichia
+            ? LvdsCrc.VerifyLinesCrc16(_frameBuf, _frameWidth, _frameWidth, _lineCrcExp, _lineReceived, _lineCrcOk)
+            : LvdsCrc.VerifyLinesCrc32(_frameBuf, _frameWidth, _frameWidth, _lineCrcExp, _lineReceived, _lineCrcOk);
+        if (failed == 0)
+            return;
+
+        // Log first 5 CRC mismatches with detail
+        for (int row = 0; row < _frameHeightLvds && _crcErrorCount < 5 && _log != null; row++)
+        {
+            if (!_lineReceived[row] || _lineCrcOk[row])
+                continue;
+            _crcErrorCount++;
+            failed--;
+            var px = _frameBuf.AsSpan(row * _frameWidth, _frameWidth);
+            string bits = _isNichia ? "CRC16" : "CRC32";
+            string fmt = _isNichia ? "X4" : "X8";
+            _log($"[lvds-crc] {bits} MISMATCH row={row}: computed=0x{LineCrc(px).ToString(fmt)} " +
+                 $"received=0x{_lineCrcExp[row].ToString(fmt)} px[0..3]=[{px[0]:X2} {px[1]:X2} {px[2]:X2} {px[3]:X2}]");
+        }
+        _crcErrorCount += failed;
+    }
+
     private void EmitFrame()
     {
         _frameCount++;
+        VerifyFrameCrcs();
 
         // Copy active area to a new buffer (top activeHeight lines, crop metadata)
         int activeBytes = _frameWidth * _activeHeight;
@@ -336,8 +374,20 @@ public sealed class LvdsFrameReassembler
 public sealed record LvdsFrameMeta
 {
     public uint FrameId { get; init; }
+    /// <summary>Link of a dual-link bridge the frame came from (0 for single-link sources).</summary>
+    public int Channel { get; init; }
+    /// <summary>Pixels per row sent; the window width with a firmware ROI ('W').</summary>
     public int Width { get; init; }
+    /// <summary>Rows sent; the window's row count with a firmware ROI ('W').</summary>
     public int Height { get; init; }
+    /// <summary>Window origin in the assembled frame (0, 0 for whole frames).</summary>
+    public int RoiX { get; init; }
+    public int RoiY { get; init; }
+    /// <summary>Source rows per sent row: row r of the frame is source row RoiY + r × RowStep.</summary>
+    public int RowStep { get; init; } = 1;
+    /// <summary>Size of the frame the window was cut from (Width × Height for whole frames).</summary>
+    public int SourceWidth { get; init; }
+    public int SourceHeight { get; init; }
     /// <summary>Lines actually received before this frame was emitted.</summary>
     public int LinesReceived { get; init; }
     /// <summary>Lines that were received (placed at correct row) in this frame.</summary>
@@ -345,8 +395,23 @@ public sealed record LvdsFrameMeta
     /// <summary>Expected total lines per frame (H_LVDS).</summary>
     public int LinesExpected { get; init; }
     /// <summary>Per-line received mask (length = ActiveHeight).
-    /// true = line was received and placed at correct row position.</summary>
+    /// true = line was received and placed at correct row position.  May be
+    /// shared between frames: do not modify.</summary>
     public bool[] LineValidityMask { get; init; } = Array.Empty<bool>();
+    /// <summary>Rows that changed versus the previous frame (firmware delta mode).
+    /// Full frames report Height; -1 = unknown (raw reassembly).</summary>
+    public int ChangedRows { get; init; } = -1;
+    /// <summary>Firmware frame counter (32-bit with v2 headers, 16-bit otherwise).</summary>
+    public uint FirmwareFrameId { get; init; }
+    /// <summary>RP2350 time_us_64() at the sync byte of the frame's first line; 0 = not sent.</summary>
+    public ulong FirmwareTimestampUs { get; init; }
+    /// <summary>Host Stopwatch time (µs) when the frame was complete; 0 = not recorded.</summary>
+    public long HostTimestampUs { get; init; }
+    /// <summary>LVDS-sync-to-host transit time above the fastest frame seen (µs);
+    /// shows latency variation per frame.  -1 = no firmware timestamp.</summary>
+    public double RelativeLatencyUs { get; init; } = -1;
+    /// <summary>Firmware frame statistics ('H') sent with this frame; null = not enabled.</summary>
+    public LvdsFrameStats? Stats { get; init; }
     public int SyncLosses { get; init; }
     public int CrcErrors { get; init; }
     public int ParityErrors { get; init; }
@@ -0,0 +1,211 @@
+using System;
+using System.Buffers.Binary;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// Per-frame statistics from the Pico 2 firmware (host command 'H'), sent
+/// immediately before the frame packet they describe:
+///
+///   [0xFE] [0xEB] [version] [channel] [len:2]    — len = body bytes that follow
+///   body (version 1, little-endian):
+///   [frame_id:4] [width:2] [rows:2] [content] [reserved:3]
+///   content bit0: rows × [checksum:4] [min] [max] [mean] [reserved]
+///   content bit1: [histogram: 256 × uint16]      — pixels per gray level
+///
+/// Everything covers the pixels that are sent, i.e. the ROI window ('W').
+/// The row checksum is the firmware's line CRC of the whole source row
+/// (CRC-16 for Nichia, CRC-32 for Osram), 0 for a row it did not receive.
+/// Equal checksums mean the row did not change, so a frame whose rows all
+/// match the previous one can be skipped without looking at its pixels.
+/// </summary>
+public sealed record LvdsFrameStats
+{
+    public const byte Magic1 = 0xEB;
+    public const int HeaderSize = 6;   // FE EB ver channel len16
+    public const int HistogramBins = 256;
+    public const int MaxBodySize = FixedSize + 84 * RowSize + HistogramBins * 2;
+
+    private const int FixedSize = 12;
+    private const int RowSize = 8;
+
+    public int Version { get; init; }
+    public int Channel { get; init; }
+    /// <summary>Firmware frame counter of the frame described (32-bit).</summary>
+    public uint FirmwareFrameId { get; init; }
+    public int Width { get; init; }
+    public int Rows { get; init; }
+    public LvdsFrameStatsContent Content { get; init; }
+
+    /// <summary>Line CRC per sent row, 0 = row missing (empty without a row summary).</summary>
+    public uint[] RowChecksums { get; init; } = Array.Empty<uint>();
+    public byte[] RowMin { get; init; } = Array.Empty<byte>();
+    public byte[] RowMax { get; init; } = Array.Empty<byte>();
+    /// <summary>Rounded mean gray level per row.</summary>
+    public byte[] RowMean { get; init; } = Array.Empty<byte>();
+    /// <summary>Pixels per gray level over the window (empty without a histogram).</summary>
+    public int[] Histogram { get; init; } = Array.Empty<int>();
+
+    public bool HasRowSummary => RowChecksums.Length > 0;
+    public bool HasHistogram => Histogram.Length > 0;
+
+    /// <summary>
+    /// Parse a packet body (the bytes after the 6-byte header).
+    /// Returns null if the version is unknown or the body is too short.
+    /// </summary>
+    public static LvdsFrameStats? TryParse(int version, int channel, ReadOnlySpan<byte> body)
+    {
+        if (version != 1 || body.Length < FixedSize)
+            return null;
+
+        int width = BinaryPrimitives.ReadUInt16LittleEndian(body.Slice(4));
+        int rows = BinaryPrimitives.ReadUInt16LittleEndian(body.Slice(6));
+        var content = (LvdsFrameStatsContent)(body[8] & 0x03);
+        bool hasRows = (content & LvdsFrameStatsContent.RowSummary) != 0;
+        bool hasHist = (content & LvdsFrameStatsContent.Histogram) != 0;
+        int rowBytes = hasRows ? rows * RowSize : 0;
+        if (width == 0 || body.Length < FixedSize + rowBytes + (hasHist ? HistogramBins * 2 : 0))
+            return null;
+
+        var checks = new uint[hasRows ? rows : 0];
+        var min = new byte[checks.Length];
+        var max = new byte[checks.Length];
+        var mean = new byte[checks.Length];
+        for (int r = 0; r < checks.Length; r++)
+        {
+            var e = body.Slice(FixedSize + r * RowSize);
+            checks[r] = BinaryPrimitives.ReadUInt32LittleEndian(e);
+            min[r] = e[4];
+            max[r] = e[5];
+            mean[r] = e[6];
+        }
+
+        var hist = new int[hasHist ? HistogramBins : 0];
+        var h = body.Slice(FixedSize + rowBytes);
+        for (int i = 0; i < hist.Length; i++)
+            hist[i] = BinaryPrimitives.ReadUInt16LittleEndian(h.Slice(i * 2));
+
+        return new LvdsFrameStats
+        {
+            Version = version,
+            Channel = channel,
+            FirmwareFrameId = BinaryPrimitives.ReadUInt32LittleEndian(body),
+            Width = width,
+            Rows = rows,
+            Content = content,
+            RowChecksums = checks,
+            RowMin = min,
+            RowMax = max,
+            RowMean = mean,
+            Histogram = hist,
+        };
+    }
+
+    /// <summary>
+    /// Rows whose checksum differs from <paramref name="previous"/> (missing
+    /// rows count as changed); -1 if the two cannot be compared (no row
+    /// summary, other channel or window size).
+    /// </summary>
+    public int ChangedRows(LvdsFrameStats? previous)
+    {
+        if (previous == null || !HasRowSummary || !previous.HasRowSummary ||
+            previous.Channel != Channel || previous.Width != Width || previous.Rows != Rows)
+            return -1;
+
+        int changed = 0;
+        for (int r = 0; r < Rows; r++)
+            if (RowChecksums[r] == 0 || RowChecksums[r] != previous.RowChecksums[r])
+                changed++;
+        return changed;
+    }
+
+    /// <summary>True if every row matches <paramref name="previous"/>: the frame can be skipped.</summary>
+    public bool SameRowsAs(LvdsFrameStats? previous) => ChangedRows(previous) == 0;
+
+    /// <summary>Pixels at gray level <paramref name="level"/> or brighter (needs the histogram).</summary>
+    public int PixelsAtOrAbove(int level)
+    {
+        int n = 0;
+        for (int i = Math.Max(level, 0); i < Histogram.Length; i++)
+            n += Histogram[i];
+        return n;
+    }
+
+    /// <summary>Pixels at gray level <paramref name="level"/> or darker (needs the histogram).</summary>
+    public int PixelsAtOrBelow(int level)
+    {
+        int n = 0;
+        for (int i = 0; i <= level && i < Histogram.Length; i++)
+            n += Histogram[i];
+        return n;
+    }
+
+    /// <summary>Darkest pixel of the window; -1 without a row summary or histogram.</summary>
+    public int Min
+    {
+        get
+        {
+            if (HasRowSummary)
+            {
+                int m = 255;
+                foreach (var v in RowMin) m = Math.Min(m, v);
+                return m;
+            }
+            for (int i = 0; i < Histogram.Length; i++)
+                if (Histogram[i] != 0) return i;
+            return -1;
+        }
+    }
+
+    /// <summary>Brightest pixel of the window; -1 without a row summary or histogram.</summary>
+    public int Max
+    {
+        get
+        {
+            if (HasRowSummary)
+            {
+                int m = 0;
+                foreach (var v in RowMax) m = Math.Max(m, v);
+                return m;
+            }
+            for (int i = Histogram.Length - 1; i >= 0; i--)
+                if (Histogram[i] != 0) return i;
+            return -1;
+        }
+    }
+
+    /// <summary>Mean gray level of the window (exact from the histogram, else from the row means).</summary>
+    public double Mean
+    {
+        get
+        {
+            if (HasHistogram)
+            {
+                long sum = 0, n = 0;
+                for (int i = 0; i < Histogram.Length; i++)
+                {
+                    sum += (long)i * Histogram[i];
+                    n += Histogram[i];
+                }
+                return n > 0 ? (double)sum / n : 0;
+            }
+            if (!HasRowSummary) return 0;
+            long rowSum = 0;
+            foreach (var v in RowMean) rowSum += v;
+            return (double)rowSum / RowMean.Length;
+        }
+    }
+}
+
+/// <summary>
+/// What the firmware puts in its frame statistics ('H' command).
+/// </summary>
+[Flags]
+public enum LvdsFrameStatsContent : byte
+{
+    None = 0,
+    /// <summary>Per-row checksum, min, max and mean.</summary>
+    RowSummary = 0x01,
+    /// <summary>256-bin gray level histogram of the window.</summary>
+    Histogram = 0x02,
+}
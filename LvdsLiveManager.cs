@@ -13,9 +13,10 @@ namespace VilsSharpX;
 ///     → firmware parses LVDS lines, assembles complete frames on-chip
 ///     → sends "cooked" frame packets over USB CDC:
 ///       [0xFE][0xED][frame_id:2B][width:2B][height:2B][pixels:W×H]
+///       or, in delta / compression mode, [0xFE][0xEE] keyframe / changed-row packets
 ///     → LvdsUartCapture reads COM port
 ///     → LvdsCookedFrameReceiver parses cooked frame packets
-///     → OnFrameReady event fires with complete frame
+///     → OnFrameLeased event fires with the pooled frame
 ///     → MainWindow renders on Pane B
 ///
 /// The firmware handles frame skipping to match USB bandwidth,
@@ -31,8 +32,13 @@ public sealed class LvdsLiveManager : IDisposable
     // Serial capture
     private LvdsUartCapture? _capture;
 
-    // Cooked frame receiver (firmware sends complete frame packets)
+    // Cooked frame receiver (firmware sends complete frame packets);
+    // its frames come out of one pool that outlives receiver rebuilds
     private LvdsCookedFrameReceiver _receiver;
+    private readonly LvdsFramePool _framePool = new();
+
+    // Raw line mode: lines are reassembled on the host (CRC / parity checked there)
+    private LvdsFrameReassembler? _lineReassembler;
 
     // Current configuration
     private LvdsUartConfig _config;
@@ -55,6 +61,21 @@ public sealed class LvdsLiveManager : IDisposable
     private volatile bool _interceptStatus;
     private Action<string>? _statusCallback;
 
+    // Firmware telemetry ('T'), sent between frames while capturing
+    private const int TelemetryRateHz = 2;
+    private volatile LvdsFirmwareTelemetry? _telemetry;
+
+    // Unchanged-frame skipping ('H' row checksums)
+    private volatile bool _skipUnchanged;
+    private LvdsFrameStats? _lastStats;
+    private long _skippedFrames;
+
+    // Row streaming ('Y'): lower latency, no delta/compression
+    private volatile bool _rowStreaming;
+
+    // Native capture file (*.lvdscap) being written, if any
+    private LvdsCaptureWriter? _captureFile;
+
     // FPS estimation (EMA-based, matching app convention)
     private readonly double _fpsWindowSec;
     private readonly double _fpsAlpha;
@@ -70,6 +91,20 @@ public sealed class LvdsLiveManager : IDisposable
     /// </summary>
     public event Action<byte[], LvdsFrameMeta>? OnFrameReady;
 
+    /// <summary>
+    /// Fired for the same frames as <see cref="OnFrameReady"/>, with a pooled
+    /// buffer instead of a fresh copy (no allocation per frame).  Released
+    /// when the handlers return; call <see cref="LvdsFrameLease.AddRef"/> to
+    /// keep it, then dispose it.  Raw line mode frames are rented from the
+    /// same pool while this event has subscribers.
+    /// </summary>
+    public event Action<LvdsFrameLease>? OnFrameLeased;
+
+    /// <summary>
+    /// Fired (on the serial thread) for each firmware telemetry packet.
+    /// </summary>
+    public event Action<LvdsFirmwareTelemetry>? OnTelemetry;
+
     // ── Properties ──────────────────────────────────────────────────────
 
     public bool HasFrame => _hasFrame;
@@ -87,10 +122,57 @@ public sealed class LvdsLiveManager : IDisposable
     /// <summary>Total raw bytes received from the serial port (atomically read).</summary>
     public long BytesReceived => Interlocked.Read(ref _bytesReceived);
 
+    /// <summary>
+    /// Link shown by this manager when the bridge captures two (dual-link
+    /// firmware).  Frames and raw lines of the other channel are ignored.
+    /// </summary>
+    public int DisplayChannel { get; set; }
+
+    /// <summary>
+    /// Ask the firmware for per-row checksums ('H') and do not raise
+    /// <see cref="OnFrameReady"/> for frames whose rows all match the last
+    /// frame raised.  Such frames still count for FPS and signal presence.
+    /// Takes effect immediately while capturing.
+    /// </summary>
+    public bool SkipUnchangedFrames
+    {
+        get => _skipUnchanged;
+        set
+        {
+            _skipUnchanged = value;
+            _lastStats = null;
+            if (_capture?.IsOpen == true)
+                _capture.SendFrameStatsCommand(value ? LvdsFrameStatsContent.RowSummary : LvdsFrameStatsContent.None);
+        }
+    }
+
+    /// <summary>
+    /// Stream frames row by row ('Y'): a frame is raised as soon as its last
+    /// active row arrives rather than after the next frame starts, at the
+    /// cost of sending every row uncompressed.  Takes effect immediately
+    /// while capturing.
+    /// </summary>
+    public bool RowStreaming
+    {
+        get => _rowStreaming;
+        set
+        {
+            _rowStreaming = value;
+            if (_capture?.IsOpen == true)
+                _capture.SendRowModeCommand(value);
+        }
+    }
+
+    /// <summary>Frames not raised because <see cref="SkipUnchangedFrames"/> found them unchanged.</summary>
+    public long SkippedUnchangedFrames => Interlocked.Read(ref _skippedFrames);
+
+    /// <summary>Most recent firmware telemetry of this capture session (null until one arrives).</summary>
+    public LvdsFirmwareTelemetry? LatestTelemetry => _telemetry;
+
     /// <summary>
     /// Send 'S' command to the Pico 2 firmware through the active capture connection
     /// and intercept the status response from the data stream.
-    /// The firmware stops PIO, sends "MODE=...\n", then restarts capture.
+    /// The firmware sends "MODE=...\n" between two frames without pausing capture.
     /// </summary>
     public void QueryFirmwareStatusDuringCapture(Action<string> onResponse)
     {
@@ -128,14 +210,18 @@ public sealed class LvdsLiveManager : IDisposable
         _fpsAlpha = fpsAlpha;
 
         _lvdsFrame = new byte[_config.ActiveBytes];
-        _receiver = new LvdsCookedFrameReceiver();
-        _receiver.OnFrameReady += OnReceivedFrame;
+        _receiver = new LvdsCookedFrameReceiver(_framePool);
+        _receiver.OnFrameLeased += OnReceivedLease;
+        _receiver.OnKeyframeNeeded += OnKeyframeNeeded;
+        _receiver.OnRawLine += OnRawLineReceived;
+        _receiver.OnTelemetry += OnTelemetryReceived;
     }
 
     // ── Public API ──────────────────────────────────────────────────────
 
     /// <summary>
-    /// Start capturing from the specified COM port.
+    /// Start capturing from the specified COM port, or from a USB bridge
+    /// named "USB:" + serial number (see <see cref="ListPorts"/>).
     /// </summary>
     public void StartCapture(string portName)
     {
@@ -146,21 +232,39 @@ public sealed class LvdsLiveManager : IDisposable
             try
             {
                 _receiver.Dispose();
-                _receiver = new LvdsCookedFrameReceiver();
-                _receiver.OnFrameReady += OnReceivedFrame;
+                _receiver = new LvdsCookedFrameReceiver(_framePool);
+                _receiver.OnFrameLeased += OnReceivedLease;
+                _receiver.OnKeyframeNeeded += OnKeyframeNeeded;
+                _receiver.OnRawLine += OnRawLineReceived;
+                _receiver.OnTelemetry += OnTelemetryReceived;
+                _lineReassembler = null;
                 _hasFrame = false;
                 _lastFrameUtc = DateTime.MinValue;
                 _bytesReceived = 0;
                 _hexDumpDone = false;
+                _telemetry = null;
                 _fpsEma = 0;
                 _fpsFrameCount = 0;
                 _fpsSw.Restart();
 
-                _capture = LvdsUartCapture.Start(portName, _config, OnSerialData, _log);
+                _capture = LvdsUartCapture.IsUsbPort(portName)
+                    ? LvdsUartCapture.StartUsb(portName.Substring(LvdsUartCapture.UsbPortPrefix.Length), OnSerialData, _log)
+                    : LvdsUartCapture.Start(portName, _config, OnSerialData, _log);
 
                 // Tell Pico 2 firmware which UART mode to use
                 _capture.SendModeCommand(_config.IsNichia);
 
+                // Only changed rows are sent for static scenes, compressed where it pays;
+                // older firmware ignores 'D' / 'Z'
+                _capture.SendDeltaCommand(true);
+                _capture.SendCompressionCommand(LvdsCompressionMode.Auto);
+                _capture.SendLineModeCommand(false);   // firmware keeps line mode across sessions
+                _capture.SendRowModeCommand(_rowStreaming);
+                _capture.SendTelemetryCommand(TelemetryRateHz);
+                _capture.SendFrameStatsCommand(_skipUnchanged ? LvdsFrameStatsContent.RowSummary
+                                                              : LvdsFrameStatsContent.None);
+                _lastStats = null;
+
                 _log($"[lvds] capture started on {portName} for {_deviceType.GetDisplayName()}");
             }
             catch (Exception ex)
@@ -202,10 +306,17 @@ public sealed class LvdsLiveManager : IDisposable
             _config = LvdsProtocol.GetUartConfig(deviceType);
 
             // Rebuild receiver and frame buffer for new dimensions
-            _receiver.OnFrameReady -= OnReceivedFrame;
+            _receiver.OnFrameLeased -= OnReceivedLease;
+            _receiver.OnKeyframeNeeded -= OnKeyframeNeeded;
+            _receiver.OnRawLine -= OnRawLineReceived;
+            _receiver.OnTelemetry -= OnTelemetryReceived;
             _receiver.Dispose();
-            _receiver = new LvdsCookedFrameReceiver();
-            _receiver.OnFrameReady += OnReceivedFrame;
+            _receiver = new LvdsCookedFrameReceiver(_framePool);
+            _receiver.OnFrameLeased += OnReceivedLease;
+            _receiver.OnKeyframeNeeded += OnKeyframeNeeded;
+            _receiver.OnRawLine += OnRawLineReceived;
+            _receiver.OnTelemetry += OnTelemetryReceived;
+            _lineReassembler = null;
 
             _lvdsFrame = new byte[_config.ActiveBytes];
             _hasFrame = false;
@@ -219,6 +330,50 @@ public sealed class LvdsLiveManager : IDisposable
         }
     }
 
+    /// <summary>
+    /// Fired (on the serial thread) for each raw line in line mode:
+    /// (buffer, length, crcOk).  The buffer is reused; copy to keep it.
+    /// </summary>
+    public event Action<byte[], int, bool>? OnRawLine;
+
+    /// <summary>
+    /// Switch the firmware between cooked frames and raw line records for
+    /// protocol debugging.  Lines in [rowLo, rowHi] are streamed; when the
+    /// range covers the active rows they are also reassembled on the host
+    /// (<see cref="LvdsFrameReassembler"/>) so Pane B keeps updating.
+    /// </summary>
+    public void SetRawLineMode(bool enable, int rowLo = 0, int rowHi = 255)
+    {
+        lock (_lock)
+        {
+            if (_capture == null)
+            {
+                _log("[lvds] raw line mode needs an active capture");
+                return;
+            }
+
+            if (_lineReassembler != null)
+            {
+                _lineReassembler.OnFrameReady -= OnReceivedFrame;
+                _lineReassembler = null;
+            }
+
+            if (enable && rowLo <= 0 && rowHi >= _config.ActiveHeight - 1)
+            {
+                var r = new LvdsFrameReassembler(_config.FrameWidth, _config.FrameHeight,
+                                                 _config.ActiveHeight, _config.CrcLen,
+                                                 _config.IsNichia, _log);
+                r.OnFrameReady += OnReceivedFrame;
+                _lineReassembler = r;
+            }
+
+            _capture.SendLineModeCommand(enable, rowLo, rowHi);
+            if (!enable && _rowStreaming)
+                _capture.SendRowModeCommand(true);   // line mode cleared it
+            _log($"[lvds] raw line mode {(enable ? $"on (rows {rowLo}..{rowHi})" : "off")}");
+        }
+    }
+
     /// <summary>
     /// Check if signal has been lost (no frame for timeout period).
     /// </summary>
@@ -261,10 +416,52 @@ public sealed class LvdsLiveManager : IDisposable
                $"bytes={r.TotalBytesReceived:N0}";
     }
 
+    /// <summary>Capture file being written by <see cref="StartCaptureFile"/>, if any.</summary>
+    public LvdsCaptureWriter? CaptureFile => Volatile.Read(ref _captureFile);
+
+    /// <summary>
+    /// Write every frame received (both links, unchanged frames included)
+    /// and every telemetry packet to an LVDS capture file at
+    /// <paramref name="path"/>, until <see cref="StopCaptureFile"/>.
+    /// Replaces a capture file already being written.
+    /// </summary>
+    public void StartCaptureFile(string path)
+    {
+        var writer = new LvdsCaptureWriter(path);
+        Interlocked.Exchange(ref _captureFile, writer)?.Dispose();
+        _log($"[lvds] capture file started: {path}");
+    }
+
     /// <summary>
-    /// List available COM ports.
+    /// Finish the capture file (frame index, trimmed length).
+    /// Returns a summary line, or null if none was being written.
     /// </summary>
-    public static string[] ListPorts() => LvdsUartCapture.ListPorts();
+    public string? StopCaptureFile()
+    {
+        var writer = Interlocked.Exchange(ref _captureFile, null);
+        if (writer == null) return null;
+        writer.Dispose();
+        string summary = $"LVDS capture: {writer.FramesWritten} frames, {writer.BytesWritten / (1024.0 * 1024.0):F1} MiB, " +
+                         $"dropped={writer.DroppedFrames}" + (writer.Error != null ? $", error: {writer.Error.Message}" : "");
+        _log($"[lvds] capture file closed: {writer.Path} ({summary})");
+        return summary;
+    }
+
+    /// <summary>
+    /// List available COM ports, then the bridges on the USB vendor
+    /// interface as "USB:" + serial number.
+    /// </summary>
+    public static string[] ListPorts()
+    {
+        var com = LvdsUartCapture.ListPorts();
+        var usb = PicoUsbVendor.ListSerialNumbers();
+        if (usb.Length == 0) return com;
+        var ports = new string[com.Length + usb.Length];
+        com.CopyTo(ports, 0);
+        for (int i = 0; i < usb.Length; i++)
+            ports[com.Length + i] = LvdsUartCapture.UsbPortPrefix + usb[i];
+        return ports;
+    }
 
     /// <summary>
     /// Send 'B' command to reboot the Pico 2 into USB bootloader (BOOTSEL mode).
@@ -330,8 +527,8 @@ public sealed class LvdsLiveManager : IDisposable
         }
 
         // Intercept firmware status response if a query is pending.
-        // The firmware stops PIO data flow before sending "MODE=...\n",
-        // so the status string arrives as a clean burst in the data stream.
+        // The firmware sends "MODE=...\n" between packets, so the bytes on
+        // either side of it are still packet data for the receiver.
         if (_interceptStatus)
         {
             for (int i = 0; i <= count - 5; i++)
@@ -349,8 +546,9 @@ public sealed class LvdsLiveManager : IDisposable
                     var cb = _statusCallback;
                     _statusCallback = null;
                     cb?.Invoke(response);
-                    // Don't push status text through receiver
-                    // (PIO was paused anyway, so no real pixel data is mixed in)
+                    if (end < count) end++;   // the newline
+                    if (i > 0) _receiver.Push(buffer, 0, i);
+                    if (end < count) _receiver.Push(buffer, end, count - end);
                     return;
                 }
             }
@@ -359,8 +557,62 @@ public sealed class LvdsLiveManager : IDisposable
         _receiver.Push(buffer, count);
     }
 
+    private void OnRawLineReceived(byte[] line, int length, bool crcOk, int channel)
+    {
+        if (channel != DisplayChannel) return;
+        _lineReassembler?.Push(line, 0, length);
+        OnRawLine?.Invoke(line, length, crcOk);
+    }
+
+    private void OnTelemetryReceived(LvdsFirmwareTelemetry telemetry)
+    {
+        _telemetry = telemetry;
+        _captureFile?.TryAppend(telemetry);
+        OnTelemetry?.Invoke(telemetry);
+    }
+
+    private void OnKeyframeNeeded()
+    {
+        // Called on the serial read thread; a missed request is retried on the next delta
+        _capture?.SendKeyframeRequest();
+    }
+
     private void OnReceivedFrame(byte[] frame, LvdsFrameMeta meta)
     {
+        _captureFile?.TryAppend(frame, meta);
+        if (!AcceptFrame(frame, meta)) return;
+
+        TraceLog.Instant(TraceEvent.FrameReady, meta.FrameId, meta.Channel);
+        var onLease = OnFrameLeased;
+        if (onLease != null)
+        {
+            using var lease = _framePool.Rent(frame, meta);
+            onLease(lease);
+        }
+        OnFrameReady?.Invoke(frame, meta);
+    }
+
+    private void OnReceivedLease(LvdsFrameLease lease)
+    {
+        _captureFile?.TryAppend(lease);
+        if (!AcceptFrame(lease.Span, lease.Meta)) return;
+
+        TraceLog.Instant(TraceEvent.FrameReady, lease.Meta.FrameId, lease.Meta.Channel);
+        OnFrameLeased?.Invoke(lease);
+        // Subscribers of the byte[] event may hold on to the frame: give them a copy
+        var onFrame = OnFrameReady;
+        if (onFrame != null)
+            onFrame(lease.Span.ToArray(), lease.Meta);
+    }
+
+    /// <summary>
+    /// Count the frame and keep it as <see cref="LvdsFrame"/>; false if it is
+    /// not raised (other channel, unchanged with <see cref="SkipUnchangedFrames"/>).
+    /// </summary>
+    private bool AcceptFrame(ReadOnlySpan<byte> frame, LvdsFrameMeta meta)
+    {
+        if (meta.Channel != DisplayChannel) return false;
+
         // Update FPS estimate
         Interlocked.Increment(ref _fpsFrameCount);
         if (_fpsSw.Elapsed.TotalSeconds >= _fpsWindowSec)
@@ -372,16 +624,27 @@ public sealed class LvdsLiveManager : IDisposable
                 : _fpsEma * (1.0 - _fpsAlpha) + instantFps * _fpsAlpha;
         }
 
+        if (_skipUnchanged && meta.Stats != null)
+        {
+            bool same = meta.Stats.SameRowsAs(_lastStats);
+            _lastStats = meta.Stats;
+            if (same && _hasFrame)
+            {
+                _lastFrameUtc = DateTime.UtcNow;
+                Interlocked.Increment(ref _skippedFrames);
+                return false;
+            }
+        }
+
         // Firmware sends complete, CRC-verified frames.
         // No persistent merging needed — just copy and forward.
         int needed = frame.Length;
         if (_lvdsFrame.Length != needed)
             _lvdsFrame = new byte[needed];
-        Buffer.BlockCopy(frame, 0, _lvdsFrame, 0, needed);
+        frame.CopyTo(_lvdsFrame);
         _hasFrame = true;
         _lastFrameUtc = DateTime.UtcNow;
-
-        OnFrameReady?.Invoke(frame, meta);
+        return true;
     }
 
     // ── IDisposable ─────────────────────────────────────────────────────
@@ -389,6 +652,7 @@ public sealed class LvdsLiveManager : IDisposable
     public void Dispose()
     {
         StopCapture();
-        _receiver.OnFrameReady -= OnReceivedFrame;
+        StopCaptureFile();
+        _receiver.OnFrameLeased -= OnReceivedLease;
     }
 }
@@ -55,6 +55,9 @@ public static class LvdsProtocol
     public const int NichiaH_Lvds = 68;
     public const int NichiaH_Active = 64;
 
+    /// <summary>Widest line the bridge firmware accepts (MAX_LINE_WIDTH, its row buffers).</summary>
+    public const int MaxLineWidth = 320;
+
     /// <summary>Metadata lines at bottom of LVDS frame to be cropped.</summary>
     public const int MetadataLines = 4;
 
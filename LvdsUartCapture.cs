@@ -1,4 +1,5 @@
 using System;
+using System.Buffers.Binary;
 using System.IO.Ports;
 using System.Threading;
 
@@ -15,10 +16,13 @@ namespace VilsSharpX;
 ///
 /// This class handles the PC-side serial port I/O and pumps received bytes
 /// into an <see cref="LvdsFrameReassembler"/> for frame reconstruction.
+/// A bridge on the vendor bulk interface (<see cref="PicoUsbVendor"/>)
+/// is opened with <see cref="StartUsb"/> instead; the commands are the same.
 /// </summary>
 public sealed class LvdsUartCapture : IDisposable
 {
     private SerialPort? _port;
+    private PicoUsbVendor? _usb;
     private readonly Action<byte[], int> _onDataReceived;
     private readonly Action<string>? _log;
     private volatile bool _disposed;
@@ -28,8 +32,12 @@ public sealed class LvdsUartCapture : IDisposable
     private const int ReadBufferSize = 65536;
     private readonly byte[] _readBuf = new byte[ReadBufferSize];
 
+    /// <summary>COM port name, or "USB:" and the bridge serial for <see cref="StartUsb"/>.</summary>
     public string PortName { get; }
-    public bool IsOpen => _port?.IsOpen == true;
+    public bool IsOpen => _port?.IsOpen == true || _usb?.IsConnected == true;
+
+    /// <summary>Prefix of <see cref="PortName"/> for bridges opened over USB.</summary>
+    public const string UsbPortPrefix = "USB:";
 
     /// <summary>
     /// Creates a new LVDS UART capture instance.
@@ -60,6 +68,14 @@ public sealed class LvdsUartCapture : IDisposable
         };
     }
 
+    private LvdsUartCapture(PicoUsbVendor usb, Action<byte[], int> onDataReceived, Action<string>? log)
+    {
+        PortName = UsbPortPrefix + usb.SerialNumber;
+        _usb = usb;
+        _onDataReceived = onDataReceived;
+        _log = log;
+    }
+
     /// <summary>
     /// Opens the serial port and starts a dedicated read thread.
     /// Using a blocking read loop (instead of DataReceived event) ensures the Windows
@@ -96,6 +112,37 @@ public sealed class LvdsUartCapture : IDisposable
         return capture;
     }
 
+    /// <summary>
+    /// Opens the bridge with USB serial <paramref name="serialNumber"/> on its
+    /// vendor bulk interface and streams it with queued transfers on the
+    /// device's own read thread (<see cref="PicoUsbVendor.StartReading"/>),
+    /// so several bridges read side by side without waiting on each other.
+    /// The line is set up by commands only; there is no baud rate on this side.
+    /// </summary>
+    public static LvdsUartCapture StartUsb(string serialNumber, Action<byte[], int> onDataReceived, Action<string>? log)
+    {
+        var usb = new PicoUsbVendor();
+        var capture = new LvdsUartCapture(usb, onDataReceived, log);
+        try
+        {
+            if (!usb.Connect(serialNumber))
+                throw new InvalidOperationException("bridge not found or interface not available");
+            usb.StartReading(capture.OnUsbData);
+            log?.Invoke($"[lvds-uart] opened USB bridge {serialNumber} ({PicoUsbVendor.ReadQueueDepth} bulk reads queued)");
+        }
+        catch (Exception ex)
+        {
+            capture.Dispose();
+            throw new InvalidOperationException($"Failed to open USB bridge {serialNumber}: {ex.Message}", ex);
+        }
+        return capture;
+    }
+
+    private void OnUsbData(byte[] buffer, int count)
+    {
+        if (!_disposed) _onDataReceived(buffer, count);
+    }
+
     /// <summary>
     /// Lists available serial (COM) ports on the system.
     /// </summary>
@@ -136,7 +183,10 @@ public sealed class LvdsUartCapture : IDisposable
             {
                 int read = stream.Read(_readBuf, 0, _readBuf.Length);
                 if (read > 0)
+                {
+                    TraceLog.Instant(TraceEvent.SerialRead, read);
                     _onDataReceived(_readBuf, read);
+                }
                 else if (read == 0)
                     Thread.Sleep(1); // EOF-like condition, avoid tight spin
             }
@@ -165,9 +215,15 @@ public sealed class LvdsUartCapture : IDisposable
     /// </summary>
     public void Send(byte[] data)
     {
-        if (_disposed || _port == null || !_port.IsOpen) return;
+        if (_disposed) return;
         try
         {
+            if (_usb != null)
+            {
+                if (_usb.IsConnected) _usb.Write(data);
+                return;
+            }
+            if (_port == null || !_port.IsOpen) return;
             _port.Write(data, 0, data.Length);
         }
         catch (Exception ex)
@@ -187,6 +243,203 @@ public sealed class LvdsUartCapture : IDisposable
         _log?.Invoke($"[lvds-uart] sent mode command: {(char)cmd}");
     }
 
+    /// <summary>
+    /// Send 'U' command: make <paramref name="config"/> the firmware's line
+    /// format, for panels without a built-in mode.  The firmware ignores a
+    /// format it cannot receive (PROTO_REJ in the status line); lines wider
+    /// than <see cref="LvdsProtocol.MaxLineWidth"/> are refused here.
+    /// </summary>
+    public void SendProtocolCommand(LvdsUartConfig config, byte syncByte = LvdsProtocol.SyncByte)
+    {
+        if (config.FrameWidth <= 0 || config.FrameWidth > LvdsProtocol.MaxLineWidth)
+            throw new ArgumentOutOfRangeException(nameof(config),
+                $"Frame width {config.FrameWidth} outside 1..{LvdsProtocol.MaxLineWidth} supported by the bridge");
+        int lineSize = LvdsProtocol.LineHeaderLen + config.FrameWidth + config.CrcLen;
+        var cmd = new byte[17];
+        cmd[0] = (byte)'U';
+        BinaryPrimitives.WriteUInt16LittleEndian(cmd.AsSpan(1), (ushort)config.FrameWidth);
+        BinaryPrimitives.WriteUInt16LittleEndian(cmd.AsSpan(3), (ushort)config.ActiveHeight);
+        BinaryPrimitives.WriteUInt16LittleEndian(cmd.AsSpan(5), (ushort)config.FrameHeight);
+        BinaryPrimitives.WriteUInt16LittleEndian(cmd.AsSpan(7), (ushort)lineSize);
+        BinaryPrimitives.WriteUInt32LittleEndian(cmd.AsSpan(9), (uint)config.BaudRate);
+        cmd[13] = (byte)(config.CrcLen == 4 ? 1 : 0);
+        cmd[14] = config.Parity switch
+        {
+            System.IO.Ports.Parity.Odd => 1,
+            System.IO.Ports.Parity.Even => 2,
+            _ => 0,
+        };
+        cmd[15] = syncByte;
+        cmd[16] = (byte)(config.IsNichia ? 0x7F : 0xFF);   // Nichia: parity bit above the row address
+        Send(cmd);
+        _log?.Invoke($"[lvds-uart] sent protocol command: {config.FrameWidth}x{config.ActiveHeight}/{config.FrameHeight} " +
+                     $"{config.BaudRate} baud CRC{config.CrcLen * 8}");
+    }
+
+    /// <summary>
+    /// Send 'A' command: the firmware measures the input bit rate, tries its
+    /// known line formats on it and keeps the best one.  It answers with a
+    /// status line (DETECT=result:measured_baud:lines).
+    /// </summary>
+    public void SendAutoDetectCommand()
+    {
+        Send(new[] { (byte)'A' });
+        _log?.Invoke("[lvds-uart] sent auto-detect command");
+    }
+
+    /// <summary>
+    /// Send CRC policy command to Pico 2 firmware.
+    /// 'C' 0 = count CRC errors only (default), 'C' 1 = drop lines with bad CRC
+    /// before they are placed in the frame (missing rows stay black).
+    /// </summary>
+    public void SendCrcPolicyCommand(bool rejectBadLines)
+    {
+        Send(new[] { (byte)'C', (byte)(rejectBadLines ? 1 : 0) });
+        _log?.Invoke($"[lvds-uart] sent CRC policy command: {(rejectBadLines ? "reject" : "count")}");
+    }
+
+    /// <summary>
+    /// Send frame pacing command to Pico 2 firmware.
+    /// 'P' 0 = adaptive (send every frame the USB link can carry, default),
+    /// 'P' n = fixed 1-in-n decimation (e.g. 2 for the old 24 FPS behaviour).
+    /// </summary>
+    public void SendPacingCommand(int decimation)
+    {
+        byte div = (byte)Math.Clamp(decimation, 0, 255);
+        Send(new[] { (byte)'P', div });
+        _log?.Invoke($"[lvds-uart] sent pacing command: {(div > 1 ? $"1-in-{div}" : "adaptive")}");
+    }
+
+    /// <summary>
+    /// Send 'D' command to enable/disable delta encoding.  When enabled the
+    /// firmware sends a keyframe followed by packets carrying only changed rows.
+    /// </summary>
+    public void SendDeltaCommand(bool enable)
+    {
+        Send(new[] { (byte)'D', (byte)(enable ? 1 : 0) });
+        _log?.Invoke($"[lvds-uart] sent delta command: {(enable ? "on" : "off")}");
+    }
+
+    /// <summary>
+    /// Send 'K' command: the next frame is sent as a full keyframe.
+    /// Used to resynchronise the delta base after a lost packet.
+    /// </summary>
+    public void SendKeyframeRequest()
+    {
+        Send(new[] { (byte)'K' });
+        _log?.Invoke("[lvds-uart] sent keyframe request");
+    }
+
+    /// <summary>
+    /// Send 'L' command to switch between cooked frames and raw line records.
+    /// In line mode the firmware sends every validated line whose row lies in
+    /// [rowLo, rowHi] (LVDS row numbers, metadata rows included) and no frames.
+    /// </summary>
+    public void SendLineModeCommand(bool enable, int rowLo = 0, int rowHi = 255)
+    {
+        byte lo = (byte)Math.Clamp(rowLo, 0, 255);
+        byte hi = (byte)Math.Clamp(rowHi, 0, 255);
+        Send(new[] { (byte)'L', (byte)(enable ? 1 : 0), lo, hi });
+        _log?.Invoke($"[lvds-uart] sent line mode command: {(enable ? $"rows {lo}..{hi}" : "off")}");
+    }
+
+    /// <summary>
+    /// Send 'Y' command: row mode.  Each row goes out as soon as it is
+    /// placed and the frame ends with its last active row, instead of the
+    /// whole frame waiting for the next frame's first line.  Row mode sends
+    /// whole rows only (no delta or compression); line mode ('L' on) replaces it.
+    /// </summary>
+    public void SendRowModeCommand(bool enable)
+    {
+        Send(new[] { (byte)'Y', (byte)(enable ? 1 : 0) });
+        _log?.Invoke($"[lvds-uart] sent row mode command: {(enable ? "on" : "off")}");
+    }
+
+    /// <summary>
+    /// Send 'Z' command to select payload compression for extended packets.
+    /// The firmware sends any frame that does not get smaller uncompressed.
+    /// </summary>
+    public void SendCompressionCommand(LvdsCompressionMode mode)
+    {
+        Send(new[] { (byte)'Z', (byte)mode });
+        _log?.Invoke($"[lvds-uart] sent compression command: {mode}");
+    }
+
+    /// <summary>
+    /// Send 'T' command: periodic telemetry packets at <paramref name="rateHz"/>
+    /// (1..100, 0 = off).  The firmware sends them between frames without
+    /// pausing capture.
+    /// </summary>
+    public void SendTelemetryCommand(int rateHz)
+    {
+        byte rate = (byte)Math.Clamp(rateHz, 0, 100);
+        Send(new[] { (byte)'T', rate });
+        _log?.Invoke($"[lvds-uart] sent telemetry command: {(rate == 0 ? "off" : $"{rate} Hz")}");
+    }
+
+    /// <summary>
+    /// Send 'W' command: stream only a window of each frame, columns
+    /// <paramref name="x"/>.. and every <paramref name="rowStep"/>-th row from
+    /// <paramref name="y"/>.  <paramref name="width"/>/<paramref name="height"/>
+    /// 0 = to the right/bottom edge; all zero (see <see cref="SendRoiOffCommand"/>)
+    /// restores full frames.  The window comes back in <see cref="LvdsFrameMeta"/>.
+    /// </summary>
+    public void SendRoiCommand(int x, int y, int width, int height, int rowStep = 1)
+    {
+        ushort rx = (ushort)Math.Clamp(x, 0, ushort.MaxValue);
+        ushort rw = (ushort)Math.Clamp(width, 0, ushort.MaxValue);
+        byte ry = (byte)Math.Clamp(y, 0, 255);
+        byte rh = (byte)Math.Clamp(height, 0, 255);
+        byte step = (byte)Math.Clamp(rowStep, 0, 255);
+        Send(new[] { (byte)'W', (byte)rx, (byte)(rx >> 8), ry, (byte)rw, (byte)(rw >> 8), rh, step });
+        _log?.Invoke($"[lvds-uart] sent ROI command: x={rx} y={ry} {rw}x{rh} step {step}");
+    }
+
+    /// <summary>Send 'W' with an empty window: full frames again.</summary>
+    public void SendRoiOffCommand() => SendRoiCommand(0, 0, 0, 0, 1);
+
+    /// <summary>
+    /// Send 'X' command: USB transmit mode.  Packed (default) keeps the
+    /// bulk transfers at whole packets and flushes once per frame, so large
+    /// host reads complete per frame; off flushes after every sender pass.
+    /// </summary>
+    public void SendUsbTxModeCommand(bool packed)
+    {
+        Send(new[] { (byte)'X', (byte)(packed ? 1 : 0) });
+        _log?.Invoke($"[lvds-uart] sent USB TX mode command: {(packed ? "packed" : "flush every pass")}");
+    }
+
+    /// <summary>
+    /// Send 'H' command: a <see cref="LvdsFrameStats"/> packet ahead of every
+    /// frame with the selected <paramref name="content"/> (None = off).
+    /// </summary>
+    public void SendFrameStatsCommand(LvdsFrameStatsContent content)
+    {
+        Send(new[] { (byte)'H', (byte)content });
+        _log?.Invoke($"[lvds-uart] sent frame statistics command: {content}");
+    }
+
+    /// <summary>
+    /// Send 'G' command: the firmware's synthetic line generator sends
+    /// <paramref name="fps"/> frames per second (0 = off) in the current
+    /// protocol on its generator pin, which must be wired to Channel 1.
+    /// <paramref name="errorsPerThousand"/> lines get a bad CRC.  Row 0 of
+    /// every generated frame starts with its frame number, see
+    /// <see cref="GeneratorFrameNumber"/>.
+    /// </summary>
+    public void SendGeneratorCommand(int fps, LvdsGeneratorPattern pattern = LvdsGeneratorPattern.Scroll,
+                                     int errorsPerThousand = 0)
+    {
+        byte rate = (byte)Math.Clamp(fps, 0, 255);
+        byte errors = (byte)Math.Clamp(errorsPerThousand, 0, 255);
+        Send(new[] { (byte)'G', rate, (byte)pattern, errors });
+        _log?.Invoke($"[lvds-uart] sent generator command: {(rate == 0 ? "off" : $"{rate} FPS {pattern}, {errors}/1000 bad lines")}");
+    }
+
+    /// <summary>Frame number the firmware generator wrote into the first 4 pixels (LE).</summary>
+    public static uint GeneratorFrameNumber(ReadOnlySpan<byte> pixels) =>
+        BinaryPrimitives.ReadUInt32LittleEndian(pixels);
+
     /// <summary>
     /// Send 'B' command to reboot Pico 2 into USB bootloader (BOOTSEL mode).
     /// After this, the COM port will disconnect and the Pico 2 will appear
@@ -205,6 +458,16 @@ public sealed class LvdsUartCapture : IDisposable
     /// </summary>
     public static void SendBootloaderCommandTo(string portName, Action<string>? log = null)
     {
+        if (IsUsbPort(portName))
+        {
+            using var usb = new PicoUsbVendor();
+            if (!usb.Connect(portName.Substring(UsbPortPrefix.Length)))
+                throw new InvalidOperationException($"USB bridge {portName} not found");
+            usb.Write(new[] { (byte)'B' });
+            log?.Invoke($"[lvds-uart] sent bootloader command 'B' to {portName}");
+            return;
+        }
+
         using var port = new SerialPort(portName)
         {
             BaudRate = 115200,
@@ -224,13 +487,16 @@ public sealed class LvdsUartCapture : IDisposable
     }
 
     /// <summary>
-    /// Query firmware status by sending 'S' command to Pico 2 on the specified COM port.
-    /// Opens the port briefly, sends 'S', waits for a response, and returns it.
-    /// Expected response: "MODE=NICHIA BAUD=12500000 BYTES=nnn\n"
+    /// Query firmware status on the specified COM port.
+    /// Opens the port briefly, asks for a one-shot telemetry packet ('T' 0xFF)
+    /// and the 'S' text line, and returns the telemetry summary — or the
+    /// "MODE=..." text from firmware without telemetry.
     /// Returns null if no response within timeout.
     /// </summary>
     public static string? QueryFirmwareStatus(string portName, Action<string>? log = null, int waitMs = 500)
     {
+        if (IsUsbPort(portName))
+            return QueryUsbFirmwareStatus(portName, log, waitMs);
         try
         {
             using var port = new SerialPort(portName)
@@ -250,8 +516,9 @@ public sealed class LvdsUartCapture : IDisposable
             Thread.Sleep(100);
             port.DiscardInBuffer();
 
-            port.Write(new byte[] { (byte)'S' }, 0, 1);
-            log?.Invoke($"[lvds-uart] sent status query 'S' to {portName}");
+            // Older firmware ignores 'T' and its argument and answers 'S' only
+            port.Write(new byte[] { (byte)'T', 0xFF, (byte)'S' }, 0, 3);
+            log?.Invoke($"[lvds-uart] sent status query 'T'/'S' to {portName}");
 
             // Wait for firmware to respond
             Thread.Sleep(waitMs);
@@ -263,40 +530,64 @@ public sealed class LvdsUartCapture : IDisposable
                 return null;
             }
 
-            var buf = new byte[Math.Min(available, 1024)];
+            // Capture keeps running, so the reply sits among frame packets
+            var buf = new byte[Math.Min(available, 256 * 1024)];
             int read = port.Read(buf, 0, buf.Length);
+            return ParseStatusReply(buf, read, portName, log);
+        }
+        catch (Exception ex)
+        {
+            log?.Invoke($"[lvds-uart] status query failed on {portName}: {ex.Message}");
+            return null;
+        }
+    }
 
-            // The response may be interleaved with PIO data bytes.
-            // Extract only printable ASCII characters and look for the "MODE=" pattern.
-            var sb = new System.Text.StringBuilder();
-            for (int i = 0; i < read; i++)
+    /// <summary>
+    /// <see cref="QueryFirmwareStatus"/> for a bridge on the vendor bulk
+    /// interface: reads until the telemetry packet or a complete
+    /// "MODE=" line has arrived, for at most <paramref name="waitMs"/>
+    /// (at least one bulk read).
+    /// </summary>
+    private static string? QueryUsbFirmwareStatus(string portName, Action<string>? log, int waitMs)
+    {
+        try
+        {
+            using var usb = new PicoUsbVendor();
+            if (!usb.Connect(portName.Substring(UsbPortPrefix.Length)))
             {
-                char c = (char)buf[i];
-                if (c >= ' ' && c <= '~') sb.Append(c);  // printable ASCII
-                else if (c == '\n' || c == '\r') sb.Append(' ');
+                log?.Invoke($"[lvds-uart] USB bridge {portName} not found");
+                return null;
             }
+            usb.Write(new byte[] { (byte)'T', 0xFF, (byte)'S' });
+            log?.Invoke($"[lvds-uart] sent status query 'T'/'S' to {portName}");
 
-            string rawText = sb.ToString().Trim();
-            log?.Invoke($"[lvds-uart] raw response ({read} bytes, {rawText.Length} printable): {rawText}");
-
-            // Try to extract the "MODE=..." status line from the response
-            int modeIdx = rawText.IndexOf("MODE=", StringComparison.OrdinalIgnoreCase);
-            if (modeIdx >= 0)
+            var buf = new byte[256 * 1024];
+            int read = 0;
+            bool replied = false;
+            var rx = new LvdsCookedFrameReceiver();
+            rx.OnTelemetry += _ => replied = true;
+            var sw = System.Diagnostics.Stopwatch.StartNew();
+            do
             {
-                string response = rawText[modeIdx..].Trim();
-                log?.Invoke($"[lvds-uart] firmware status from {portName}: {response}");
-                return response;
+                int n = usb.ReadAsync(buf.AsMemory(read, Math.Min(PicoUsbVendor.DefaultReadSize, buf.Length - read)))
+                           .GetAwaiter().GetResult();
+                if (n == 0) break;
+                rx.Push(buf, read, n);
+                read += n;
+
+                // Firmware without telemetry answers with the text line only
+                int textIdx = buf.AsSpan(0, read).IndexOf("MODE="u8);
+                if (textIdx >= 0 && buf.AsSpan(textIdx, read - textIdx).IndexOf((byte)'\n') >= 0)
+                    replied = true;
             }
+            while (!replied && sw.ElapsedMilliseconds < waitMs && buf.Length - read >= PicoUsbVendor.MaxPacketSize);
 
-            // No "MODE=" found — return whatever printable text we got (or null if empty)
-            if (rawText.Length > 0)
+            if (read == 0)
             {
-                log?.Invoke($"[lvds-uart] unexpected response from {portName}: {rawText}");
-                return rawText;
+                log?.Invoke($"[lvds-uart] no status response from {portName}");
+                return null;
             }
-
-            log?.Invoke($"[lvds-uart] no printable response from {portName} ({read} raw bytes)");
-            return null;
+            return ParseStatusReply(buf, read, portName, log);
         }
         catch (Exception ex)
         {
@@ -305,6 +596,61 @@ public sealed class LvdsUartCapture : IDisposable
         }
     }
 
+    /// <summary>
+    /// Telemetry summary, "MODE=..." line or printable text found in the
+    /// first <paramref name="read"/> bytes of a status query reply.
+    /// </summary>
+    private static string? ParseStatusReply(byte[] buf, int read, string portName, Action<string>? log)
+    {
+        LvdsFirmwareTelemetry? telemetry = null;
+        var rx = new LvdsCookedFrameReceiver();
+        rx.OnTelemetry += t => telemetry = t;
+        rx.Push(buf, read);
+        if (telemetry != null)
+        {
+            string summary = telemetry.ToString();
+            log?.Invoke($"[lvds-uart] firmware telemetry from {portName}: {summary}");
+            return summary;
+        }
+
+        // Status text line from firmware without telemetry
+        int textIdx = buf.AsSpan(0, read).IndexOf("MODE="u8);
+        if (textIdx >= 0)
+        {
+            int end = Array.IndexOf(buf, (byte)'\n', textIdx, read - textIdx);
+            if (end < 0) end = read;
+            string response = System.Text.Encoding.ASCII.GetString(buf, textIdx, end - textIdx).Trim();
+            log?.Invoke($"[lvds-uart] firmware status from {portName}: {response}");
+            return response;
+        }
+
+        // Unknown reply: keep the printable ASCII characters of its start
+        var sb = new System.Text.StringBuilder();
+        for (int i = 0; i < Math.Min(read, 1024); i++)
+        {
+            char c = (char)buf[i];
+            if (c >= ' ' && c <= '~') sb.Append(c);  // printable ASCII
+            else if (c == '\n' || c == '\r') sb.Append(' ');
+        }
+
+        string rawText = sb.ToString().Trim();
+        log?.Invoke($"[lvds-uart] raw response ({read} bytes, {rawText.Length} printable): {rawText}");
+
+        // No "MODE=" found — return whatever printable text we got (or null if empty)
+        if (rawText.Length > 0)
+        {
+            log?.Invoke($"[lvds-uart] unexpected response from {portName}: {rawText}");
+            return rawText;
+        }
+
+        log?.Invoke($"[lvds-uart] no printable response from {portName} ({read} raw bytes)");
+        return null;
+    }
+
+    /// <summary>True for a <see cref="PortName"/> naming a USB bridge (<see cref="UsbPortPrefix"/>).</summary>
+    public static bool IsUsbPort(string portName) =>
+        portName.StartsWith(UsbPortPrefix, StringComparison.OrdinalIgnoreCase);
+
     public void Dispose()
     {
         if (_disposed) return;
@@ -312,6 +658,12 @@ public sealed class LvdsUartCapture : IDisposable
 
         try
         {
+            if (_usb != null)
+            {
+                _usb.Dispose();   // stops the read thread and cancels its transfers
+                _usb = null;
+            }
+
             if (_port != null)
             {
                 if (_port.IsOpen)
@@ -333,3 +685,28 @@ public sealed class LvdsUartCapture : IDisposable
         }
     }
 }
+
+/// <summary>
+/// Test patterns of the firmware line generator ('G' command).
+/// </summary>
+public enum LvdsGeneratorPattern : byte
+{
+    /// <summary>Gradient scrolling by one gray level per frame; every row changes.</summary>
+    Scroll = 0,
+    /// <summary>4-row bar moving down one row per frame; few rows change (delta, RLE).</summary>
+    Bar = 1,
+}
+
+/// <summary>
+/// Payload compression modes of the Pico 2 firmware ('Z' command).
+/// </summary>
+public enum LvdsCompressionMode : byte
+{
+    Off = 0,
+    /// <summary>PackBits run-length coding (black areas, beam cut-offs).</summary>
+    Rle = 1,
+    /// <summary>4-bit palette packing when the frame uses at most 16 gray levels.</summary>
+    Nibble = 2,
+    /// <summary>Nibble + RLE when possible, RLE otherwise.</summary>
+    Auto = 3,
+}
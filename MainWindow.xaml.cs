@@ -34,6 +34,7 @@ namespace VilsSharpX
             Image,
             Pcap,
             Avi,
+            LvdsCapture,
             Sequence,
             Scene
         }
@@ -82,7 +83,6 @@ namespace VilsSharpX
         private volatile int _bValueDelta;
 
         private volatile byte _diffThreshold;
-        private byte[] _diffBgr = null!;
 
         // If >0, forces B[pixel_ID] to 0 (simulated dead pixel). pixel_ID is 1..(W*H_ACTIVE).
         private int _forcedDeadPixelId;
@@ -106,6 +106,10 @@ namespace VilsSharpX
         private string _avtpEtherType = "0x22F0";
         private string _streamIdLastByte = "0x50";
 
+        // PCAP TX: inject the capture as recorded, at this speed (0 = as fast as possible)
+        private bool _pcapTxAsCaptured = true;
+        private double _pcapReplaySpeed = 1.0;
+
         private ModeOfOperation _modeOfOperation = ModeOfOperation.AvtpLiveMonitor;
 
         // Fallback image / generator base
@@ -128,6 +132,7 @@ namespace VilsSharpX
         private SequencePlayer _sequencePlayer = null!;
         private ScenePlayer _scenePlayer = null!;
         private AviSourcePlayer _aviPlayer = null!;
+        private LvdsCapturePlayer _capturePlayer = null!;
         private SourceLoaderHelper _sourceLoader = null!;
 
         // Frame snapshot/report saver
@@ -179,6 +184,17 @@ namespace VilsSharpX
         private WriteableBitmap _wbB = null!;
         private WriteableBitmap _wbD = null!;
 
+        // Render pipeline: sources post their newest frame, panes are composed on the
+        // compositor thread and copied into the bitmaps once per display frame
+        private const double RenderIntervalMs = 16;
+        private readonly FrameCompositor _compositor = new();
+        private readonly FrameMailbox<LvdsFrameLease> _lvdsMailbox = new();   // holds a reference
+        private readonly FrameMailbox<FrameMeta> _liveMailbox = new();
+        private readonly Stopwatch _renderClock = Stopwatch.StartNew();
+        private TimeSpan _lastRenderingTime;
+        private TimeSpan _lastRenderAllTime;
+        private DispatcherTimer? _minimizedRenderTimer;
+
         // --- AVTP Transmitter (managed by AvtpTransmitManager) ---
         private AvtpTransmitManager _txManager = null!;
 
@@ -239,7 +255,6 @@ namespace VilsSharpX
             int h = _currentHeight;
 
             // Frame buffers
-            _diffBgr = new byte[w * h * 3];
             _pgmFrame = new byte[w * h];
             _idleGradientFrame = new byte[w * h];
             _noSignalGrayFrame = new byte[w * h];
@@ -256,6 +271,7 @@ namespace VilsSharpX
             _sequencePlayer = new SequencePlayer(w, h);
             _scenePlayer = new ScenePlayer(w, h);
             _aviPlayer = new AviSourcePlayer(w, h, FpsEstimationWindowSec, FpsEmaAlpha);
+            _capturePlayer = new LvdsCapturePlayer(w, h);
             _sourceLoader = new SourceLoaderHelper(w, h, H_LVDS);
             _snapshotSaver = new FrameSnapshotSaver(w, h);
             _pixelInspector = new PixelInspector(w, h);
@@ -284,13 +300,17 @@ namespace VilsSharpX
             InitializeResolutionDependentObjects();
             InitializeDefaultPatterns();
 
+            // Frames of the old managers / resolution still waiting for display
+            _lvdsMailbox.Take()?.Dispose();
+            _liveMailbox.Clear();
+
             // Re-subscribe to LiveCaptureManager events (since we recreated the instance)
             if (_liveCapture != null)
-                _liveCapture.OnFrameReady += (frame, meta) => Dispatcher.Invoke(() => HandleLiveFrameReady(meta));
+                _liveCapture.OnFrameReady += (frame, meta) => OnLiveFrameArrived(meta);
 
             // Re-subscribe to LVDS manager events
             if (_lvdsManager != null)
-                _lvdsManager.OnFrameReady += (frame, meta) => Dispatcher.BeginInvoke(() => HandleLvdsFrameReady(frame, meta));
+                _lvdsManager.OnFrameLeased += OnLvdsFrameArrived;
 
             // Update LVDS protocol info label
             UpdateLvdsProtocolLabel();
@@ -412,6 +432,8 @@ namespace VilsSharpX
 
         private void RenderNoSignalFrames()
         {
+            // Composed frames still on their way would paint over the no-signal panes
+            _compositor.Invalidate();
             BitmapUtils.Blit(_wbA, _noSignalGrayFrame, _currentWidth);
             BitmapUtils.Blit(_wbB, _noSignalGrayFrame, _currentWidth);
             BitmapUtils.Blit(_wbD, _noSignalGrayBgr, _currentWidth * 3);
@@ -715,7 +737,25 @@ namespace VilsSharpX
         private void Window_Loaded(object sender, RoutedEventArgs e)
         {
             // Hook LiveCaptureManager -> update UI with frame info (frame storage is already done in the manager)
-            _liveCapture.OnFrameReady += (frame, meta) => Dispatcher.Invoke(() => HandleLiveFrameReady(meta));
+            _liveCapture.OnFrameReady += (frame, meta) => OnLiveFrameArrived(meta);
+
+            // Sources post frames to mailboxes; the UI picks up the newest once per display frame.
+            // Rendering is not raised while minimized: a timer keeps playback and recording going then.
+            CompositionTarget.Rendering += OnCompositionRendering;
+            var minimizedTimer = new DispatcherTimer(DispatcherPriority.Render)
+            {
+                Interval = TimeSpan.FromMilliseconds(RenderIntervalMs)
+            };
+            minimizedTimer.Tick += (_, __) => RenderDisplayFrame();
+            StateChanged += (_, __) =>
+            {
+                if (WindowState == WindowState.Minimized) minimizedTimer.Start();
+                else minimizedTimer.Stop();
+            };
+            _minimizedRenderTimer = minimizedTimer;
+
+            // Recorded submits reach the AVI recorder on the compositor thread, shown or not
+            _compositor.Recorder = (a, b, d) => _recordingManager.TryEnqueueFrame(a, b, d);
 
             ShowIdleGradient();
             int w = GetCurrentWidth();
@@ -728,7 +768,7 @@ namespace VilsSharpX
             ApplyNoSignalUiState(noSignal: true);
 
             // Wire up LVDS manager frame ready event
-            _lvdsManager.OnFrameReady += (frame, meta) => Dispatcher.BeginInvoke(() => HandleLvdsFrameReady(frame, meta));
+            _lvdsManager.OnFrameLeased += OnLvdsFrameArrived;
 
             // Populate COM port list and LVDS protocol info
             RefreshLvdsPortList();
@@ -741,7 +781,11 @@ namespace VilsSharpX
             ApplyButtonStates(false);
         }
 
-        private void HandleLiveFrameReady(FrameMeta meta)
+        /// <summary>
+        /// AVTP frame complete (capture thread): count it, then leave its meta
+        /// for the next display frame.  The capture thread never waits for the UI.
+        /// </summary>
+        private void OnLiveFrameArrived(FrameMeta meta)
         {
             // Keep status stable when stopped; ignore late frames during shutdown races.
             if (!_playback.IsRunning)
@@ -752,7 +796,6 @@ namespace VilsSharpX
             // AVTP/RVF always sends RvfProtocol.H lines (80) regardless of device active height.
             // Compare against that, not the device's active crop height.
             int rvfHeight = RvfProtocol.H;
-            int displayHeight = GetCurrentHeight();
             bool incomplete = meta.linesWritten < rvfHeight;
             bool gap = meta.seqGaps > 0;
             if (incomplete) _playback.IncrementCountAvtpIncomplete();
@@ -767,6 +810,15 @@ namespace VilsSharpX
             if (_modeOfOperation == ModeOfOperation.AvtpLiveMonitor)
                 _playback.IncrementCountB();
 
+            _liveMailbox.Post(meta);
+        }
+
+        private void HandleLiveFrameReady(FrameMeta meta)
+        {
+            if (!_playback.IsRunning)
+                return;
+
+            int displayHeight = GetCurrentHeight();
             string src = GetActiveAvtpFeed() switch
             {
                 LiveCaptureManager.Feed.EthernetAvtp => "Ethernet/AVTP",
@@ -806,6 +858,8 @@ namespace VilsSharpX
                 _vlanPriority = Math.Clamp(s.VlanPriority, 0, 7);
                 _avtpEtherType = s.AvtpEtherType ?? "0x22F0";
                 _streamIdLastByte = s.StreamIdLastByte ?? "0x50";
+                _pcapTxAsCaptured = s.PcapTxAsCaptured;
+                _pcapReplaySpeed = s.PcapReplaySpeed >= 0 ? s.PcapReplaySpeed : 1.0;
 
                 _modeOfOperation = s.ModeOfOperation == (int)ModeOfOperation.AvtpLiveMonitor
                     ? ModeOfOperation.AvtpLiveMonitor
@@ -886,7 +940,7 @@ namespace VilsSharpX
                 _avtpLiveEnabled, _avtpLiveDeviceHint, (int)_modeOfOperation,
                 _srcMac, _dstMac, (int)_currentDeviceType,
                 _ecuVariant, _vlanId, _vlanPriority, _avtpEtherType, _streamIdLastByte,
-                _lvdsPortHint);
+                _lvdsPortHint, _pcapTxAsCaptured, _pcapReplaySpeed);
             _settingsManager.TrySave(s);
         }
 
@@ -1077,14 +1131,29 @@ namespace VilsSharpX
             ClearLvdsPanes();
         }
 
-        private void HandleLvdsFrameReady(byte[] frame, LvdsFrameMeta meta)
+        /// <summary>
+        /// LVDS frame complete (serial / USB thread): replaces any frame still
+        /// waiting for display, so a busy UI shows the newest frame instead of
+        /// working through a backlog.  The mailbox keeps a reference to the
+        /// pooled frame; the one it replaces goes straight back to the pool,
+        /// so frames that are never shown are never copied.
+        /// </summary>
+        private void OnLvdsFrameArrived(LvdsFrameLease lease) =>
+            _lvdsMailbox.Post(lease.AddRef())?.Dispose();
+
+        private void HandleLvdsFrameReady(LvdsFrameLease lease)
         {
-            // Guard: reject stale callbacks that arrive via Dispatcher.BeginInvoke
+            // Guard: reject a frame still in the mailbox
             // after Stop Test / Stop LVDS has already been pressed.
-            // Without this, queued callbacks re-render the last frame over "No Signal".
+            // Without this, it re-renders the last frame over "No Signal".
             if (!_lvdsManager.IsCapturing && (_lvdsSimSource == null || !_lvdsSimSource.IsRunning))
                 return;
 
+            // Pane B, the compositor and recording keep the frame past this call;
+            // copy it once per displayed frame and let the lease go back to the pool
+            var meta = lease.Meta;
+            byte[] frame = lease.Span.ToArray();
+
             // Update LVDS stats labels
             LblLvdsFrameCount.Text = $"Frames: {meta.FrameId} ({meta.ValidLines}/{meta.LinesExpected} lines)";
             LblLvdsBytesReceived.Text = $"Bytes: {meta.TotalBytes:N0}";
@@ -1119,33 +1188,21 @@ namespace VilsSharpX
             int h = _currentHeight;
 
             // Pane B: LVDS frame
-            if (frame.Length == w * h)
+            var bData = frame;
+            if (frame.Length == 0)
             {
-                BitmapUtils.Blit(_wbB, frame, w);
+                bData = _noSignalGrayFrame;
             }
-            else if (frame.Length > 0)
+            else if (frame.Length != w * h)
             {
                 // Dimension mismatch — create a padded/cropped buffer
-                var safeFrame = new byte[w * h];
-                int copyLen = Math.Min(frame.Length, safeFrame.Length);
-                Buffer.BlockCopy(frame, 0, safeFrame, 0, copyLen);
-                BitmapUtils.Blit(_wbB, safeFrame, w);
+                bData = new byte[w * h];
+                Buffer.BlockCopy(frame, 0, bData, 0, Math.Min(frame.Length, bData.Length));
             }
 
-            // Pane A: show the loaded/generated source frame (gradient if nothing loaded)
-            var aData = GetASourceBytes();
-            BitmapUtils.Blit(_wbA, aData, w);
-
-            // Pane D: |A − B| diff
-            DiffRenderer.RenderCompareToBgr(_diffBgr, aData, frame.Length == w * h ? frame : _noSignalGrayFrame,
-                w, h, _diffThreshold, _zeroZeroIsWhite,
-                out var minDiff, out var maxDiff, out var meanDiff,
-                out var maxAbsDiff, out var meanAbsDiff, out var aboveDeadband,
-                out var totalDarkPixels);
-            BitmapUtils.Blit(_wbD, _diffBgr, w * 3);
-
-            if (LblDiffStats != null)
-                LblDiffStats.Text = StatusFormatter.FormatDiffStats(maxDiff, minDiff, meanAbsDiff, aboveDeadband, totalDarkPixels);
+            // Pane A: the loaded/generated source frame (gradient if nothing loaded);
+            // pane D: |A − B| diff.  Composed off the UI thread, shown at the next display frame.
+            _compositor.Submit(GetASourceBytes(), bData, w, h, _diffThreshold, _zeroZeroIsWhite);
 
             ApplyNoSignalUiState(noSignal: false);
         }
@@ -1187,7 +1244,7 @@ namespace VilsSharpX
 
             // Reset reassembler and manager state, then start sim.
             // NOTE: ReconfigureForDevice rebuilds the internal reassembler, but the
-            // OnFrameReady event on the manager itself persists (subscribed in Window_Loaded
+            // OnFrameLeased event on the manager itself persists (subscribed in Window_Loaded
             // and ReinitializeForNewResolution), so we do NOT re-add the handler here.
             _lvdsManager.ReconfigureForDevice(_currentDeviceType);
             _lvdsSimSource.Start();
@@ -1227,6 +1284,7 @@ namespace VilsSharpX
         /// </summary>
         private void ClearLvdsPanes()
         {
+            _lvdsMailbox.Take()?.Dispose();
             lock (_frameLock)
             {
                 _latestB = null;
@@ -1567,7 +1625,10 @@ namespace VilsSharpX
             if (_recordingManager.IsRecording) StopRecording();
             StopAll();
             StopLvdsStatsTimer();
+            CompositionTarget.Rendering -= OnCompositionRendering;
+            _minimizedRenderTimer?.Stop();
             try { _lvdsManager?.Dispose(); } catch { /* ignore */ }
+            _compositor.Dispose();
         }
 
         private void BtnStart_Click(object sender, RoutedEventArgs e)
@@ -1618,6 +1679,7 @@ namespace VilsSharpX
         {
             _loopPlayingEnabled = ChkLoopPlaying?.IsChecked == true;
             _aviPlayer.LoopEnabled = _loopPlayingEnabled;
+            _capturePlayer.LoopEnabled = _loopPlayingEnabled;
         }
 
         private void BtnRecord_Click(object sender, RoutedEventArgs e)
@@ -1687,6 +1749,7 @@ namespace VilsSharpX
             return _lastLoaded switch
             {
                 LoadedSource.Avi => _aviPlayer.CurrentIndex + 1,
+                LoadedSource.LvdsCapture => _capturePlayer.CurrentIndex + 1,
                 LoadedSource.Scene => _scenePlayer.CurrentIndex + 1,
                 LoadedSource.Sequence => _sequencePlayer.CurrentIndex + 1,
                 _ => 1
@@ -1702,7 +1765,7 @@ namespace VilsSharpX
             }
 
             int fps = (int)Math.Clamp(_playback.TargetFps > 0 ? _playback.TargetFps : 30, 1, 1000);
-            var (success, error, statusMessage) = _recordingManager.StartRecording(fps, _diffThreshold);
+            var (success, error, statusMessage) = _recordingManager.StartRecording(fps, _diffThreshold, _lvdsManager);
 
             if (success)
             {
@@ -1792,7 +1855,7 @@ namespace VilsSharpX
             var dlg = new OpenFileDialog
             {
                 Title = "Load Files",
-                Filter = "All supported (*.pgm;*.bmp;*.png;*.avi;*.pcap;*.pcapng;*.scene)|*.pgm;*.bmp;*.png;*.avi;*.pcap;*.pcapng;*.scene|Images (*.pgm;*.bmp;*.png)|*.pgm;*.bmp;*.png|AVI (*.avi)|*.avi|Captures (*.pcap;*.pcapng)|*.pcap;*.pcapng|Scenes (*.scene)|*.scene|All files (*.*)|*.*",
+                Filter = "All supported (*.pgm;*.bmp;*.png;*.avi;*.lvdscap;*.pcap;*.pcapng;*.scene)|*.pgm;*.bmp;*.png;*.avi;*.lvdscap;*.pcap;*.pcapng;*.scene|Images (*.pgm;*.bmp;*.png)|*.pgm;*.bmp;*.png|AVI (*.avi)|*.avi|LVDS captures (*.lvdscap)|*.lvdscap|Captures (*.pcap;*.pcapng)|*.pcap;*.pcapng|Scenes (*.scene)|*.scene|All files (*.*)|*.*",
                 CheckFileExists = true,
                 Multiselect = false
             };
@@ -1816,6 +1879,10 @@ namespace VilsSharpX
                         LoadAvi(path);
                         break;
 
+                    case LvdsCaptureWriter.FileExtension:
+                        LoadLvdsCapture(path);
+                        break;
+
                     case ".scene":
                         LoadScene(path);
                         break;
@@ -1906,6 +1973,19 @@ namespace VilsSharpX
             if (_playback.Cts == null || _playback.IsPaused) RenderOneFrameNow();
         }
 
+        private void LoadLvdsCapture(string path)
+        {
+            PrepareForNewSource(clearAvtpFrame: true);
+            _capturePlayer.LoopEnabled = _loopPlayingEnabled;
+            _capturePlayer.Load(path);
+            _lastLoaded = LoadedSource.LvdsCapture;
+            LblStatus.Text = _capturePlayer.BuildStatusMessage();
+
+            if (ChkLoopPlaying != null) ChkLoopPlaying.Visibility = Visibility.Visible;
+
+            if (_playback.Cts == null || _playback.IsPaused) RenderOneFrameNow();
+        }
+
         private void PrepareForNewSource(bool clearAvtpFrame)
         {
             ClearAvi();
@@ -1919,6 +1999,7 @@ namespace VilsSharpX
         private void ClearAvi()
         {
             _aviPlayer.Close();
+            _capturePlayer.Close();
         }
 
         private void Start(int fps)
@@ -1968,18 +2049,15 @@ namespace VilsSharpX
             // -------------------------------------------------
             if (_modeOfOperation == ModeOfOperation.PlayerFromFiles)
             {
-                // Generator/Player:
+                // Generator/Player: panes are rendered once per display frame (OnCompositionRendering)
                 _ = Task.Run(() => GeneratorLoopAsync(fps, ct));
-                _ = Task.Run(() => UiRefreshLoop(ct));
 
                 LblStatus.Text = StatusFormatter.FormatPlayerRunning(fps, avtpEnabled: true);
                 _playback.RunningStatusText = LblStatus.Text;
             }
             else
             {
-                // AVTP Live Monitor:
-                _ = Task.Run(() => UiRefreshLoop(ct));
-
+                // AVTP Live Monitor: panes are rendered once per display frame (OnCompositionRendering).
                 // Until the first frame arrives, show explicit waiting message.
                 LblStatus.Text = StatusFormatter.FormatWaitingForSignal(GetDiagLogPath());
 
@@ -2022,6 +2100,21 @@ namespace VilsSharpX
 
         private void StartPcapReplay(string path)
         {
+            double speed = _pcapReplaySpeed > 0 ? _pcapReplaySpeed : PcapReplayTransmitter.Unpaced;
+
+            // Player TX: send the capture's own packets at their recorded timing instead of
+            // re-encoding the decoded frames. Loops inside the transmitter, so a restart of
+            // the display replay below does not restart it.
+            Action<PcapPacketCache>? startTx = null;
+            if (_modeOfOperation == ModeOfOperation.PlayerFromFiles && _pcapTxAsCaptured
+                && _txManager.IsReady && !_txManager.IsReplayingPcap)
+            {
+                bool loop = _loopPlayingEnabled;
+                var pauseGate = _playback.PauseGate;
+                startTx = cache => _txManager.StartPcapReplay(cache, speed, loop, pauseGate,
+                    onComplete: stats => AppendDiagLog($"[avtp-tx] PCAP TX done: {stats}"));
+            }
+
             _liveCapture.StartPcapReplay(
                 path, 
                 _playback.PauseGate,
@@ -2046,7 +2139,9 @@ namespace VilsSharpX
                 onError: msg =>
                 {
                     Dispatcher.Invoke(() => { LblStatus.Text = "PCAP: error"; });
-                });
+                },
+                speed: speed,
+                onLoaded: startTx);
         }
 
         private void StopRenderLoops()
@@ -2084,6 +2179,7 @@ namespace VilsSharpX
 
             // Stop all live capture sources
             _liveCapture.StopAll();
+            _txManager.StopPcapReplay();
 
             // Ensure we don't remain paused after stopping.
             _playback.PauseGate.Set();
@@ -2093,6 +2189,10 @@ namespace VilsSharpX
             {
                 _aviPlayer.Reset();
             }
+            if (_lastLoaded == LoadedSource.LvdsCapture && _capturePlayer.IsLoaded)
+            {
+                _capturePlayer.Reset();
+            }
 
             SaveUiSettings();
 
@@ -2182,6 +2282,12 @@ namespace VilsSharpX
                 return;
             }
 
+            if (_lastLoaded == LoadedSource.LvdsCapture)
+            {
+                StepLvdsCapture(dir);
+                return;
+            }
+
             if (!_sequencePlayer.HasAny)
             {
                 LblStatus.Text = "Sequence: load Seq A and/or Seq B first.";
@@ -2213,6 +2319,18 @@ namespace VilsSharpX
             if (_playback.Cts == null || _playback.IsPaused) RenderOneFrameNow();
         }
 
+        private void StepLvdsCapture(int dir)
+        {
+            if (!_capturePlayer.IsLoaded)
+            {
+                LblStatus.Text = "LVDS capture: load an .lvdscap first.";
+                return;
+            }
+
+            LblStatus.Text = _capturePlayer.Step(dir);
+            if (_playback.Cts == null || _playback.IsPaused) RenderOneFrameNow();
+        }
+
         private void StepScene(int dir)
         {
             if (!_scenePlayer.IsLoaded)
@@ -2297,6 +2415,7 @@ namespace VilsSharpX
                 LoadedSource.Image => _pgmFrame,
                 LoadedSource.Pcap => _liveCapture.HasAvtpFrame ? _liveCapture.AvtpFrame : _pgmFrame,
                 LoadedSource.Avi => _aviPlayer.GetBytesAndUpdateIfNeeded(DateTime.UtcNow, _playback.IsPaused) ?? _idleGradientFrame,
+                LoadedSource.LvdsCapture => _capturePlayer.GetBytesAndUpdateIfNeeded(DateTime.UtcNow, _playback.IsPaused) ?? _idleGradientFrame,
                 LoadedSource.Sequence => GetSequenceBytes() ?? _idleGradientFrame,
                 LoadedSource.Scene => _scenePlayer.GetBytesAndUpdateIfNeeded(DateTime.UtcNow, _playback.IsPaused) ?? _idleGradientFrame,
                 _ => _idleGradientFrame
@@ -2342,8 +2461,9 @@ namespace VilsSharpX
                     catch (OperationCanceledException) { break; }
                 }
 
-                // Detect AVI end-of-file when loop is disabled → auto-stop
-                if (_lastLoaded == LoadedSource.Avi && _aviPlayer.IsAtEnd)
+                // Detect AVI / capture end-of-file when loop is disabled → auto-stop
+                if ((_lastLoaded == LoadedSource.Avi && _aviPlayer.IsAtEnd) ||
+                    (_lastLoaded == LoadedSource.LvdsCapture && _capturePlayer.IsAtEnd))
                 {
                     _ = Dispatcher.BeginInvoke(() => StopAll());
                     break;
@@ -2379,40 +2499,62 @@ namespace VilsSharpX
             }
         }
 
-        private void UiRefreshLoop(CancellationToken ct)
+        private void OnCompositionRendering(object? sender, EventArgs e)
         {
-            var sw = Stopwatch.StartNew();
-            var period = TimeSpan.FromMilliseconds(16);
-            var next = sw.Elapsed;
+            // Raised more than once for the same frame when WPF renders twice; act once
+            var renderingTime = e is RenderingEventArgs re ? re.RenderingTime : TimeSpan.Zero;
+            if (renderingTime == _lastRenderingTime) return;
+            _lastRenderingTime = renderingTime;
+            RenderDisplayFrame();
+        }
 
-            while (!ct.IsCancellationRequested)
+        /// <summary>
+        /// Once per display frame (UI thread): take the newest frame each source
+        /// posted since the last one, render playback at most every
+        /// <see cref="RenderIntervalMs"/>, and copy the newest composed panes into
+        /// the bitmaps.  Everything older was replaced rather than queued, so a
+        /// slow UI drops display frames instead of falling behind.
+        /// </summary>
+        private void RenderDisplayFrame()
+        {
+            if (_liveMailbox.Take() is { } liveMeta)
+                HandleLiveFrameReady(liveMeta);
+            if (_lvdsMailbox.Take() is { } lvds)
             {
-                try { _playback.PauseGate.Wait(ct); }
-                catch { break; }
-
-                next += period;
-                try
-                {
-                    Dispatcher.Invoke(RenderAll);
-                }
-                catch
-                {
-                    // ignore shutdown races
-                    break;
-                }
+                using (lvds)
+                    HandleLvdsFrameReady(lvds);
+            }
 
-                var now = sw.Elapsed;
-                var sleep = next - now;
-                if (sleep > TimeSpan.Zero)
-                {
-                    try { Task.Delay(sleep, ct).Wait(ct); } catch { }
-                }
-                else next = now;
+            // Running playback; paused playback renders on demand (Prev/Next, settings).
+            // The 1 ms slack keeps every frame of a 60 Hz display.
+            var now = _renderClock.Elapsed;
+            if (_playback.Cts != null && _playback.PauseGate.IsSet &&
+                (now - _lastRenderAllTime).TotalMilliseconds >= RenderIntervalMs - 1)
+            {
+                _lastRenderAllTime = now;
+                RenderAll();
             }
+
+            PresentComposedFrame();
+        }
+
+        private void PresentComposedFrame()
+        {
+            var c = _compositor.TryAcquire();
+            if (c == null || c.Width != _currentWidth || c.Height != _currentHeight) return;
+            using var trace = TraceLog.Scope(TraceEvent.Present, c.Sequence);
+
+            BitmapUtils.Blit(_wbA, c.A, c.Width);
+            BitmapUtils.Blit(_wbB, c.B, c.Width);
+            BitmapUtils.Blit(_wbD, c.DiffBgr, c.Width * 3);
+
+            if (LblDiffStats != null)
+                LblDiffStats.Text = StatusFormatter.FormatDiffStats(c.MaxDiff, c.MinDiff, c.MeanAbsDiff, c.AboveDeadband, c.TotalDarkPixels);
         }
 
         private void RenderAll()
         {
+            using var trace = TraceLog.Scope(TraceEvent.Render);
             // When stopped/startup, keep the panes in "Signal not available" state and
             // disable compare/dead-pixel processing.
             if (_playback.Cts == null)
@@ -2494,25 +2636,11 @@ namespace VilsSharpX
             // B post-processing (forced dead pixel + optional compensation)
             b = ApplyBPostProcessing(a, b);
 
-            BitmapUtils.Blit(_wbA, a.Data, a.Stride);
-            BitmapUtils.Blit(_wbB, b.Data, b.Stride);
-            DiffRenderer.RenderCompareToBgr(_diffBgr, a.Data, b.Data, _currentWidth, _currentHeight, _diffThreshold,
-                _zeroZeroIsWhite,
-                out var minDiff, out var maxDiff, out var meanDiff,
-                out var maxAbsDiff, out var meanAbsDiff, out var aboveDeadband,
-                out var totalDarkPixels);
-            BitmapUtils.Blit(_wbD, _diffBgr, _currentWidth * 3);
-
-            // Record what we render (A/B in Gray8; D in Bgr24). Diff buffer is reused, so copy it.
-            if (_recordingManager.IsRecording && !_playback.IsPaused && _playback.Cts != null)
-            {
-                var dCopy = new byte[_diffBgr.Length];
-                Buffer.BlockCopy(_diffBgr, 0, dCopy, 0, dCopy.Length);
-                _recordingManager.TryEnqueueFrame(a.Data, b.Data, dCopy);
-            }
-
-            if (LblDiffStats != null)
-                LblDiffStats.Text = StatusFormatter.FormatDiffStats(maxDiff, minDiff, meanAbsDiff, aboveDeadband, totalDarkPixels);
+            // A, B and the diff are composed on the compositor thread and shown at the
+            // next display frame (PresentComposedFrame).  A recorded submit reaches the
+            // AVI recorder even if a newer frame is shown instead (see Window_Loaded).
+            bool record = _recordingManager.IsRecording && !_playback.IsPaused && _playback.Cts != null;
+            _compositor.Submit(a.Data, b.Data, _currentWidth, _currentHeight, _diffThreshold, _zeroZeroIsWhite, record);
 
             ApplyNoSignalUiState(noSignal: false);
             UpdateFpsLabels();
@@ -2561,6 +2689,7 @@ namespace VilsSharpX
                 // For AVI playback, show ONLY the "source fps" (frame content changes/sec).
                 // Do not fall back to the AVI header fps (often the fixed record fps like 100).
                 LoadedSource.Avi => _aviPlayer.SourceFpsEma,
+                LoadedSource.LvdsCapture => _capturePlayer.SourceFps,
                 _ => _playback.TargetFps
             };
         }
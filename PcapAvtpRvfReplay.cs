@@ -22,32 +22,89 @@ public static class PcapAvtpRvfReplay
         double speed = 1.0,
         ManualResetEventSlim? pauseGate = null)
     {
-        if (string.IsNullOrWhiteSpace(path)) throw new ArgumentException("Path is required", nameof(path));
-        if (!File.Exists(path)) throw new FileNotFoundException("PCAP file not found", path);
+        var cache = Load(path, log);
+        await ReplayAsync(cache, onChunk, log, ct, speed, pauseGate).ConfigureAwait(false);
+    }
+
+    /// <summary>
+    /// Replay a capture already in memory (see <see cref="Load"/>), so looping
+    /// does not read the file again.  <paramref name="speed"/> scales the
+    /// recorded timing; <see cref="double.PositiveInfinity"/> replays unpaced.
+    /// </summary>
+    public static async Task ReplayAsync(
+        PcapPacketCache cache,
+        Action<RvfChunk> onChunk,
+        Action<string>? log,
+        CancellationToken ct,
+        double speed = 1.0,
+        ManualResetEventSlim? pauseGate = null)
+    {
+        if (cache == null) throw new ArgumentNullException(nameof(cache));
         if (speed <= 0) speed = 1.0;
 
-        using var fs = File.OpenRead(path);
+        var packets = cache.Packets;
+        var timestamps = cache.TimestampsUs;
+        uint seq = 0;
+        uint frameId = 0;
+        int avtpMatches = 0;
+        int chunks = 0;
+
+        for (int i = 0; i < packets.Length; i++)
+        {
+            ct.ThrowIfCancellationRequested();
+            pauseGate?.Wait(ct);
+            if (i > 0)
+                await DelayByTimestampAsync(timestamps[i - 1], timestamps[i], speed, ct).ConfigureAwait(false);
+
+            if (AvtpRvfParser.TryParseAvtpRvfEthernet(packets[i], out var line1, out var endFrame, out var payload))
+            {
+                avtpMatches++;
+                onChunk(new RvfChunk((ushort)W, (ushort)H, (ushort)line1, (byte)NumLines, endFrame, frameId, seq++, payload));
+                chunks++;
+                if (endFrame) frameId++;
+            }
+        }
+
+        log?.Invoke($"PCAP replay finished. packets={packets.Length} avtpMatches={avtpMatches} chunks={chunks} frames={frameId}");
+    }
+
+    /// <summary>
+    /// Read every packet of a PCAP or PCAPNG file into memory.
+    /// </summary>
+    public static PcapPacketCache Load(string path, Action<string>? log = null)
+    {
+        if (string.IsNullOrWhiteSpace(path)) throw new ArgumentException("Path is required", nameof(path));
+        if (!File.Exists(path)) throw new FileNotFoundException("PCAP file not found", path);
 
-        uint first = ReadU32LE(fs);
-        fs.Position = 0;
+        var packets = new List<byte[]>();
+        var timestamps = new List<long>();
+        uint linkType;
 
-        if (first == 0x0A0D0D0Au)
+        using (var fs = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, 1 << 20, FileOptions.SequentialScan))
         {
-            await ReplayPcapNgAsync(fs, onChunk, log, ct, speed, pauseGate).ConfigureAwait(false);
+            uint first = ReadU32LE(fs);
+            fs.Position = 0;
+
+            linkType = first == 0x0A0D0D0Au
+                ? LoadPcapNg(fs, packets, timestamps, log)
+                : LoadPcap(fs, packets, timestamps, log);
         }
-        else
+
+        // Relative to the first packet, never going backwards
+        var ts = new long[timestamps.Count];
+        long t0 = ts.Length > 0 ? timestamps[0] : 0, last = 0;
+        for (int i = 0; i < ts.Length; i++)
         {
-            await ReplayPcapAsync(fs, onChunk, log, ct, speed, pauseGate).ConfigureAwait(false);
+            last = Math.Max(last, timestamps[i] - t0);
+            ts[i] = last;
         }
+
+        var cache = new PcapPacketCache(path, linkType, packets.ToArray(), ts);
+        log?.Invoke($"PCAP loaded: {cache.Count} packets, {cache.TotalBytes / 1024} KiB, {cache.DurationUs / 1000.0:F1} ms");
+        return cache;
     }
 
-    private static async Task ReplayPcapAsync(
-        Stream fs,
-        Action<RvfChunk> onChunk,
-        Action<string>? log,
-        CancellationToken ct,
-        double speed,
-        ManualResetEventSlim? pauseGate)
+    private static uint LoadPcap(Stream fs, List<byte[]> packets, List<long> timestamps, Action<string>? log)
     {
         // PCAP global header (24 bytes)
         uint magic = ReadU32LE(fs);
@@ -72,21 +129,10 @@ public static class PcapAvtpRvfReplay
         if (network != 1)
             log?.Invoke($"PCAP linktype={network} (expected Ethernet=1). Will still try.");
 
-        long? lastTsUs = null;
-        uint seq = 0;
-        uint frameId = 0;
-        int packets = 0;
-        int avtpMatches = 0;
-        int chunks = 0;
-
         while (fs.Position < fs.Length)
         {
-            ct.ThrowIfCancellationRequested();
-            pauseGate?.Wait(ct);
             if (!TryReadPacketHeader(fs, swap, out uint tsSec, out uint tsSub, out uint inclLen)) break;
 
-            packets++;
-
             byte[] data = new byte[inclLen];
             ReadExactly(fs, data);
 
@@ -94,22 +140,12 @@ public static class PcapAvtpRvfReplay
                 ? ((long)tsSec * 1_000_000L + (tsSub / 1000L))
                 : ((long)tsSec * 1_000_000L + tsSub);
 
-            pauseGate?.Wait(ct);
-            await DelayByTimestampAsync(lastTsUs, tsUs, speed, ct).ConfigureAwait(false);
-            lastTsUs = tsUs;
-
-            if (AvtpRvfParser.TryParseAvtpRvfEthernet(data, out var line1, out var endFrame, out var payload))
-            {
-                avtpMatches++;
-                onChunk(new RvfChunk((ushort)W, (ushort)H, (ushort)line1, (byte)NumLines, endFrame, frameId, seq++, payload));
-                chunks++;
-                if (endFrame) frameId++;
-            }
+            packets.Add(data);
+            timestamps.Add(tsUs);
         }
 
-        log?.Invoke($"PCAP replay finished. packets={packets} avtpMatches={avtpMatches} chunks={chunks} frames={frameId}");
+        return network;
     }
-
     private static bool TryReadPacketHeader(Stream fs, bool swap, out uint tsSec, out uint tsSub, out uint inclLen)
     {
         tsSec = tsSub = inclLen = 0;
@@ -125,30 +161,16 @@ public static class PcapAvtpRvfReplay
         return true;
     }
 
-    private static async Task ReplayPcapNgAsync(
-        Stream fs,
-        Action<RvfChunk> onChunk,
-        Action<string>? log,
-        CancellationToken ct,
-        double speed,
-        ManualResetEventSlim? pauseGate)
+    private static uint LoadPcapNg(Stream fs, List<byte[]> packets, List<long> timestamps, Action<string>? log)
     {
         // Minimal PCAPNG support: SHB + IDB + EPB/SPB.
         // Endianness is per-section; we support little endian sections.
 
-        var ifaces = new Dictionary<uint, (ushort linkType, double tsResSeconds)>();
-        long? lastTsUs = null;
-        uint seq = 0;
-        uint frameId = 0;
-        int packets = 0;
-        int avtpMatches = 0;
-        int chunks = 0;
+        var ifaces = new Dictionary<uint, (ushort linkType, byte tsResol)>();
+        long lastTsUs = 0;
 
         while (fs.Position < fs.Length)
         {
-            ct.ThrowIfCancellationRequested();
-            pauseGate?.Wait(ct);
-
             uint blockType = ReadU32LE(fs);
             uint totalLen = ReadU32LE(fs);
             if (totalLen < 12) throw new InvalidDataException("PCAPNG: invalid block length");
@@ -181,7 +203,7 @@ public static class PcapAvtpRvfReplay
                         uint ifaceId = (uint)ifaces.Count;
 
                         // Default timestamp resolution: 1e-6 seconds (microseconds)
-                        double tsRes = 1e-6;
+                        byte tsResol = 6;
 
                         // Parse options: (code uint16, length uint16, value padded to 32-bit)
                         int o = 8;
@@ -193,17 +215,12 @@ public static class PcapAvtpRvfReplay
                             if (code == 0) break;
                             if (o + len > body.Length) break;
                             if (code == 9 && len >= 1) // if_tsresol
-                            {
-                                byte v = body[o];
-                                bool isPowerOf2 = (v & 0x80) != 0;
-                                int exp = v & 0x7F;
-                                tsRes = isPowerOf2 ? 1.0 / (1 << exp) : Math.Pow(10, -exp);
-                            }
+                                tsResol = body[o];
                             int padded = (len + 3) & ~3;
                             o += padded;
                         }
 
-                        ifaces[ifaceId] = (linkType, tsRes);
+                        ifaces[ifaceId] = (linkType, tsResol);
                         break;
                     }
 
@@ -222,27 +239,17 @@ public static class PcapAvtpRvfReplay
 
                         byte[] packet = new byte[capLen];
                         ReadExactly(fs, packet);
-                        packets++;
 
                         // skip options (remaining bytes minus packet bytes)
                         int optionsLen = remainingBody - (int)capLen;
                         if (optionsLen > 0) fs.Position += optionsLen;
 
-                        double tsRes = ifaces.TryGetValue(ifaceId, out var inf) ? inf.tsResSeconds : 1e-6;
+                        byte tsResol = ifaces.TryGetValue(ifaceId, out var inf) ? inf.tsResol : (byte)6;
                         ulong ts = ((ulong)tsHigh << 32) | tsLow;
-                        long tsUs = (long)(ts * tsRes * 1_000_000.0);
-
-                        pauseGate?.Wait(ct);
-                        await DelayByTimestampAsync(lastTsUs, tsUs, speed, ct).ConfigureAwait(false);
-                        lastTsUs = tsUs;
+                        lastTsUs = TimestampToUs(ts, tsResol);
 
-                        if (AvtpRvfParser.TryParseAvtpRvfEthernet(packet, out var line1, out var endFrame, out var payload))
-                        {
-                            avtpMatches++;
-                            onChunk(new RvfChunk((ushort)W, (ushort)H, (ushort)line1, (byte)NumLines, endFrame, frameId, seq++, payload));
-                            chunks++;
-                            if (endFrame) frameId++;
-                        }
+                        packets.Add(packet);
+                        timestamps.Add(lastTsUs);
                         break;
                     }
 
@@ -254,15 +261,10 @@ public static class PcapAvtpRvfReplay
                         byte[] packet = new byte[capLen];
                         ReadExactly(fs, packet);
                         _ = origLen;
-                        packets++;
 
-                        if (AvtpRvfParser.TryParseAvtpRvfEthernet(packet, out var line1, out var endFrame, out var payload))
-                        {
-                            avtpMatches++;
-                            onChunk(new RvfChunk((ushort)W, (ushort)H, (ushort)line1, (byte)NumLines, endFrame, frameId, seq++, payload));
-                            chunks++;
-                            if (endFrame) frameId++;
-                        }
+                        // No timestamp: sent right after the packet before it
+                        packets.Add(packet);
+                        timestamps.Add(lastTsUs);
                         break;
                     }
 
@@ -281,7 +283,7 @@ public static class PcapAvtpRvfReplay
             }
         }
 
-        log?.Invoke($"PCAPNG replay finished. packets={packets} avtpMatches={avtpMatches} chunks={chunks} frames={frameId}");
+        return ifaces.TryGetValue(0, out var first) ? first.linkType : 1u;
     }
 
     // Parsing is shared with live capture via AvtpRvfParser.
@@ -414,10 +416,30 @@ public static class PcapAvtpRvfReplay
         }
     }
 
-    private static async Task DelayByTimestampAsync(long? lastTsUs, long tsUs, double speed, CancellationToken ct)
+    /// <summary>
+    /// PCAPNG timestamp in units of if_tsresol (bit 7 set: 2^-n s, else
+    /// 10^-n s) to µs, in integer arithmetic so ns captures keep exact µs.
+    /// </summary>
+    private static long TimestampToUs(ulong ts, byte tsResol)
+    {
+        int exp = tsResol & 0x7F;
+        if ((tsResol & 0x80) != 0)
+            return (long)(((UInt128)ts * 1_000_000) >> Math.Min(exp, 127));
+        if (exp >= 6)
+            return exp - 6 > 19 ? 0 : (long)(ts / Pow10(exp - 6));
+        return (long)(ts * Pow10(6 - exp));
+    }
+
+    private static ulong Pow10(int n)
+    {
+        ulong v = 1;
+        for (int i = 0; i < n; i++) v *= 10;
+        return v;
+    }
+
+    private static async Task DelayByTimestampAsync(long lastTsUs, long tsUs, double speed, CancellationToken ct)
     {
-        if (!lastTsUs.HasValue) return;
-        long deltaUs = tsUs - lastTsUs.Value;
+        long deltaUs = tsUs - lastTsUs;
         if (deltaUs <= 0) return;
 
         double ms = (deltaUs / 1000.0) / speed;
@@ -0,0 +1,66 @@
+using System;
+using System.IO;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// A PCAP / PCAPNG capture read into memory once, for replays that loop or
+/// run faster than the disk: every packet as captured, with its timestamp
+/// relative to the first packet.  Built by <see cref="PcapAvtpRvfReplay.Load"/>.
+/// </summary>
+public sealed class PcapPacketCache
+{
+    private readonly long _fileLength;
+    private readonly DateTime _fileWriteUtc;
+
+    internal PcapPacketCache(string path, uint linkType, byte[][] packets, long[] timestampsUs)
+    {
+        Path = path;
+        LinkType = linkType;
+        Packets = packets;
+        TimestampsUs = timestampsUs;
+        foreach (var p in packets)
+            TotalBytes += p.Length;
+        DurationUs = timestampsUs.Length > 0 ? timestampsUs[^1] : 0;
+
+        var info = new FileInfo(path);
+        _fileLength = info.Length;
+        _fileWriteUtc = info.LastWriteTimeUtc;
+    }
+
+    public string Path { get; }
+
+    /// <summary>Link type of the (first) interface; 1 = Ethernet.</summary>
+    public uint LinkType { get; }
+
+    /// <summary>Captured bytes of each packet (Ethernet frame without FCS).</summary>
+    public byte[][] Packets { get; }
+
+    /// <summary>
+    /// Capture time of each packet in µs after the first one.  Never
+    /// decreases: a packet stamped earlier than its predecessor gets the
+    /// predecessor's time (PCAPNG simple packet blocks carry no timestamp).
+    /// </summary>
+    public long[] TimestampsUs { get; }
+
+    public int Count => Packets.Length;
+    public long TotalBytes { get; }
+
+    /// <summary>Time from the first to the last packet, µs.</summary>
+    public long DurationUs { get; }
+
+    /// <summary>
+    /// Mean time between packets (µs), used as the gap between the last
+    /// packet of one loop and the first of the next.
+    /// </summary>
+    public long MeanIntervalUs => Count > 1 ? DurationUs / (Count - 1) : 0;
+
+    /// <summary>True if this cache was read from <paramref name="path"/> and the file has not changed since.</summary>
+    public bool IsCurrent(string path)
+    {
+        if (!string.Equals(System.IO.Path.GetFullPath(path), System.IO.Path.GetFullPath(Path), StringComparison.OrdinalIgnoreCase))
+            return false;
+        var info = new FileInfo(path);
+        return info.Exists && info.Length == _fileLength && info.LastWriteTimeUtc == _fileWriteUtc;
+    }
+}
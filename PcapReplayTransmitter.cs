@@ -0,0 +1,338 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+using SharpPcap.LibPcap;
+
+namespace VilsSharpX;
+
+/// <summary>
+/// Throughput and timing of a <see cref="PcapReplayTransmitter"/> run.
+///
+/// Jitter is the error of each measured gap against the gap scheduled from
+/// the capture (scaled by the speed): per packet when packets are sent one
+/// by one, per batch with send queues, where the driver paces the packets
+/// inside a batch and only the end of each batch is seen.
+/// </summary>
+public sealed record PcapReplayStats(
+    long Packets,
+    long Bytes,
+    int Passes,
+    TimeSpan Elapsed,
+    bool Batched,
+    long JitterSamples,
+    double JitterMeanUs,
+    double JitterRmsUs,
+    double JitterMaxUs)
+{
+    public double PacketsPerSecond => Elapsed.TotalSeconds > 0 ? Packets / Elapsed.TotalSeconds : 0;
+    public double MegabitsPerSecond => Elapsed.TotalSeconds > 0 ? Bytes * 8 / Elapsed.TotalSeconds / 1e6 : 0;
+
+    public override string ToString() =>
+        $"{Packets} packets in {Passes} pass(es), {Elapsed.TotalMilliseconds:F0} ms: " +
+        $"{PacketsPerSecond:F0} pkt/s, {MegabitsPerSecond:F1} Mbit/s, " +
+        $"jitter mean {JitterMeanUs:F1} / rms {JitterRmsUs:F1} / max {JitterMaxUs:F1} µs " +
+        $"({(Batched ? "per send queue" : "per packet")})";
+}
+
+/// <summary>
+/// Injects a <see cref="PcapPacketCache"/> on a NIC as captured, for
+/// stress-testing the ECU input path at full packet rate.
+///
+/// Packets go out in pcap send queues: each queue holds
+/// <see cref="BatchSpanUs"/> of capture time and is handed to the driver in
+/// one call, which paces the packets by their timestamps
+/// (<see cref="SendQueueTransmitModes.Synchronized"/>) or sends them
+/// back to back when unpaced.  The start of each queue is aligned to the
+/// replay clock, so gaps between queues and the per-call overhead do not
+/// add up as drift.  Queues are built once per run and sent again on every
+/// loop.  Where send queues are not available (libpcap outside Npcap) the
+/// packets are sent one by one with a spin-wait pacer instead.
+/// </summary>
+public sealed class PcapReplayTransmitter
+{
+    /// <summary>Speed for sending as fast as the NIC takes the packets.</summary>
+    public const double Unpaced = double.PositiveInfinity;
+
+    /// <summary>Capture time covered by one send queue, µs.</summary>
+    public const long BatchSpanUs = 20_000;
+
+    private const int BatchMaxBytes = 4 << 20;
+    private const int PcapHeaderBytes = 24;   // struct pcap_pkthdr, 64-bit timeval
+
+    // Below this much time to wait, spin instead of sleeping (Windows' default timer tick is 15.6 ms)
+    private const long SpinUs = 16_000;
+
+    private readonly LibPcapLiveDevice _device;
+    private readonly Action<string> _log;
+
+    /// <param name="device">Open, injection-capable device; not owned.</param>
+    public PcapReplayTransmitter(LibPcapLiveDevice device, Action<string>? log = null)
+    {
+        _device = device ?? throw new ArgumentNullException(nameof(device));
+        _log = log ?? (_ => { });
+    }
+
+    /// <summary>Send in pcap send queues when available (default); false sends packet by packet.</summary>
+    public bool UseSendQueues { get; set; } = true;
+
+    /// <summary>
+    /// Replay <paramref name="cache"/> <paramref name="passes"/> times (0 =
+    /// until cancelled) at <paramref name="speed"/> × the recorded timing
+    /// (<see cref="Unpaced"/> for as fast as possible).  Blocks; run it on a
+    /// dedicated thread.  <paramref name="onPass"/> gets the running totals
+    /// after each pass.
+    /// </summary>
+    public PcapReplayStats Run(
+        PcapPacketCache cache,
+        double speed,
+        int passes,
+        CancellationToken ct,
+        ManualResetEventSlim? pauseGate = null,
+        Action<PcapReplayStats>? onPass = null)
+    {
+        if (cache == null) throw new ArgumentNullException(nameof(cache));
+        if (!(speed > 0)) throw new ArgumentOutOfRangeException(nameof(speed), "Speed must be positive");
+        if (cache.Count == 0) return new PcapReplayStats(0, 0, 0, TimeSpan.Zero, false, 0, 0, 0, 0);
+
+        if (UseSendQueues)
+        {
+            List<Batch>? batches = null;
+            try
+            {
+                batches = BuildBatches(cache, speed);
+                return RunBatched(cache, batches, speed, passes, ct, pauseGate, onPass);
+            }
+            catch (Exception ex) when (ex is PlatformNotSupportedException or DllNotFoundException or EntryPointNotFoundException)
+            {
+                _log($"[pcap-tx] send queues not available ({ex.GetType().Name}); sending packet by packet");
+            }
+            finally
+            {
+                if (batches != null)
+                    foreach (var b in batches) b.Queue.Dispose();
+            }
+        }
+
+        return RunPaced(cache, speed, passes, p => _device.SendPacket(p), ct, pauseGate, onPass);
+    }
+
+    private readonly record struct Batch(SendQueue Queue, int First, int Last, long Bytes);
+
+    private static List<Batch> BuildBatches(PcapPacketCache cache, double speed)
+    {
+        var batches = new List<Batch>();
+        bool paced = !double.IsPositiveInfinity(speed);
+        var packets = cache.Packets;
+        var timestamps = cache.TimestampsUs;
+        int first = 0;
+        while (first < packets.Length)
+        {
+            // One batch: BatchSpanUs of capture time, at most BatchMaxBytes
+            int last = first;
+            long bytes = packets[first].Length;
+            while (last + 1 < packets.Length &&
+                   timestamps[last + 1] - timestamps[first] < BatchSpanUs &&
+                   bytes + packets[last + 1].Length + PcapHeaderBytes * (last + 2 - first) <= BatchMaxBytes)
+            {
+                last++;
+                bytes += packets[last].Length;
+            }
+
+            var queue = new SendQueue((int)bytes + PcapHeaderBytes * (last + 1 - first));
+            for (int i = first; i <= last; i++)
+            {
+                long t = paced ? (long)(timestamps[i] / speed) : 0;
+                if (!queue.Add(packets[i], (int)(t / 1_000_000), (int)(t % 1_000_000)))
+                {
+                    queue.Dispose();
+                    throw new InvalidOperationException($"Send queue full at packet {i}");
+                }
+            }
+            batches.Add(new Batch(queue, first, last, bytes));
+            first = last + 1;
+        }
+        return batches;
+    }
+
+    private PcapReplayStats RunBatched(
+        PcapPacketCache cache, List<Batch> batches, double speed, int passes,
+        CancellationToken ct, ManualResetEventSlim? pauseGate, Action<PcapReplayStats>? onPass)
+    {
+        bool paced = !double.IsPositiveInfinity(speed);
+        var mode = paced ? SendQueueTransmitModes.Synchronized : SendQueueTransmitModes.Normal;
+        var timestamps = cache.TimestampsUs;
+        var clock = new PacedClock(speed, cache.DurationUs + cache.MeanIntervalUs);
+        var jitter = new JitterStats();
+        long packets = 0, bytes = 0;
+        long lastEnd = 0, lastEndScheduled = 0;
+        int pass = 0;
+
+        while (passes <= 0 || pass < passes)
+        {
+            foreach (var b in batches)
+            {
+                ct.ThrowIfCancellationRequested();
+                if (pauseGate != null && !pauseGate.IsSet)
+                {
+                    clock.Pause(() => pauseGate.Wait(ct));
+                    lastEnd = 0;
+                }
+
+                if (paced) clock.WaitUntil(pass, timestamps[b.First], ct);
+
+                using (TraceLog.Scope(TraceEvent.PcapTxBatch, b.Last - b.First + 1))
+                {
+                    int sent = b.Queue.Transmit(_device, mode);
+                    if (sent < b.Queue.CurrentLength)
+                        throw new InvalidOperationException($"Send queue transmit stopped after {sent} of {b.Queue.CurrentLength} bytes: {_device.LastError}");
+                }
+
+                // The driver returns once the last packet of the queue is out
+                long end = clock.ElapsedTicks;
+                long endScheduled = clock.ScheduledTicks(pass, timestamps[b.Last]);
+                if (paced && lastEnd != 0)
+                    jitter.Add(clock.TicksToUs((end - lastEnd) - (endScheduled - lastEndScheduled)));
+                lastEnd = end;
+                lastEndScheduled = endScheduled;
+
+                packets += b.Last - b.First + 1;
+                bytes += b.Bytes;
+            }
+            pass++;
+            onPass?.Invoke(jitter.ToStats(packets, bytes, pass, clock.Elapsed, batched: true));
+        }
+
+        return jitter.ToStats(packets, bytes, pass, clock.Elapsed, batched: true);
+    }
+
+    /// <summary>
+    /// Packet-by-packet replay through <paramref name="send"/>, paced by a
+    /// sleep-then-spin wait on the <see cref="Stopwatch"/> clock.
+    /// </summary>
+    internal static PcapReplayStats RunPaced(
+        PcapPacketCache cache, double speed, int passes, Action<byte[]> send,
+        CancellationToken ct, ManualResetEventSlim? pauseGate = null, Action<PcapReplayStats>? onPass = null)
+    {
+        bool paced = !double.IsPositiveInfinity(speed);
+        var packets = cache.Packets;
+        var timestamps = cache.TimestampsUs;
+        var clock = new PacedClock(speed, cache.DurationUs + cache.MeanIntervalUs);
+        var jitter = new JitterStats();
+        long sentPackets = 0, bytes = 0;
+        long lastSent = 0, lastScheduled = 0;
+        int pass = 0;
+
+        while (passes <= 0 || pass < passes)
+        {
+            for (int i = 0; i < packets.Length; i++)
+            {
+                if ((i & 63) == 0)
+                {
+                    ct.ThrowIfCancellationRequested();
+                    if (pauseGate != null && !pauseGate.IsSet)
+                    {
+                        clock.Pause(() => pauseGate.Wait(ct));
+                        lastSent = 0;
+                    }
+                }
+
+                long scheduled = clock.ScheduledTicks(pass, timestamps[i]);
+                if (paced) clock.WaitUntil(pass, timestamps[i], ct);
+
+                send(packets[i]);
+
+                long now = clock.ElapsedTicks;
+                if (paced && lastSent != 0)
+                    jitter.Add(clock.TicksToUs((now - lastSent) - (scheduled - lastScheduled)));
+                lastSent = now;
+                lastScheduled = scheduled;
+
+                sentPackets++;
+                bytes += packets[i].Length;
+            }
+            pass++;
+            onPass?.Invoke(jitter.ToStats(sentPackets, bytes, pass, clock.Elapsed, batched: false));
+        }
+
+        return jitter.ToStats(sentPackets, bytes, pass, clock.Elapsed, batched: false);
+    }
+
+    /// <summary>
+    /// Replay schedule on the <see cref="Stopwatch"/> clock: packet time
+    /// scaled by the speed, each pass one capture length (plus one packet
+    /// interval) after the previous, shifted by the time spent paused.
+    /// </summary>
+    private sealed class PacedClock
+    {
+        private readonly Stopwatch _sw = Stopwatch.StartNew();
+        private readonly double _ticksPerUs;
+        private readonly long _passUs;
+        private long _pausedTicks;
+
+        public PacedClock(double speed, long passUs)
+        {
+            _ticksPerUs = Stopwatch.Frequency / 1e6 / (double.IsPositiveInfinity(speed) ? 1.0 : speed);
+            _passUs = passUs;
+        }
+
+        public long ElapsedTicks => _sw.ElapsedTicks;
+        public TimeSpan Elapsed => _sw.Elapsed;
+
+        public long ScheduledTicks(int pass, long timestampUs) =>
+            (long)((pass * _passUs + timestampUs) * _ticksPerUs) + _pausedTicks;
+
+        public double TicksToUs(long ticks) => ticks * 1e6 / Stopwatch.Frequency;
+
+        public void Pause(Action wait)
+        {
+            long t0 = _sw.ElapsedTicks;
+            wait();
+            _pausedTicks += _sw.ElapsedTicks - t0;
+        }
+
+        public void WaitUntil(int pass, long timestampUs, CancellationToken ct)
+        {
+            long target = ScheduledTicks(pass, timestampUs);
+            long spinTicks = Stopwatch.Frequency * SpinUs / 1_000_000;
+            while (true)
+            {
+                long remaining = target - _sw.ElapsedTicks;
+                if (remaining <= 0) return;
+                if (remaining > spinTicks)
+                {
+                    int sleepMs = (int)((remaining - spinTicks) * 1000 / Stopwatch.Frequency);
+                    if (sleepMs > 0 && ct.WaitHandle.WaitOne(sleepMs))
+                        ct.ThrowIfCancellationRequested();
+                    else
+                        Thread.Yield();
+                }
+                else
+                {
+                    Thread.SpinWait(20);
+                }
+            }
+        }
+    }
+
+    private sealed class JitterStats
+    {
+        private long _n;
+        private double _sumAbs, _sumSq, _max;
+
+        public void Add(double errorUs)
+        {
+            double abs = Math.Abs(errorUs);
+            _n++;
+            _sumAbs += abs;
+            _sumSq += errorUs * errorUs;
+            if (abs > _max) _max = abs;
+        }
+
+        public PcapReplayStats ToStats(long packets, long bytes, int passes, TimeSpan elapsed, bool batched) =>
+            new(packets, bytes, passes, elapsed, batched, _n,
+                _n > 0 ? _sumAbs / _n : 0,
+                _n > 0 ? Math.Sqrt(_sumSq / _n) : 0,
+                _max);
+    }
+}
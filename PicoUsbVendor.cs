@@ -1,93 +1,293 @@
 using LibUsbDotNet;
 using LibUsbDotNet.Main;
 using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using System.Threading;
 using System.Threading.Tasks;
 
 namespace VilsSharpX
 {
     public class PicoUsbVendor : IDisposable
     {
+        public const int VendorId = 0x2E8A;
+        public const int ProductId = 0x000B;
+
         private UsbDevice? _usbDevice;
         private UsbEndpointReader? _reader;
         private UsbEndpointWriter? _writer;
         private bool _connected = false;
 
-        public async Task<bool> ConnectAsync()
-        {
-            return await Task.Run(() =>
-            {
-                var finder = new UsbDeviceFinder(0x2E8A, 0x000B);
-                _usbDevice = UsbDevice.OpenUsbDevice(finder);
-                if (_usbDevice == null)
-                {
-                    DiagnosticLogger.Log("[usb] Device not found (VID=0x2E8A, PID=0x000B)");
-                    return false;
-                }
+        // libusb is shared by every bridge of the process: exit it with the last one
+        private static readonly object s_libLock = new();
+        private static int s_openDevices;
+        private bool _counted;
 
-                DiagnosticLogger.Log($"[usb] Device found: {_usbDevice.Info}");
+        /// <summary>USB serial number of the connected bridge (its chip ID), null before connecting.</summary>
+        public string? SerialNumber { get; private set; }
 
-                if (_usbDevice is IUsbDevice wholeUsbDevice)
+        public bool IsConnected => _connected;
+
+        /// <summary>
+        /// Serial numbers of the bridges attached (firmware reports its chip ID).
+        /// A bridge already opened by this or another process may not be
+        /// readable and is then listed by the serial in its device path.
+        /// </summary>
+        public static string[] ListSerialNumbers()
+        {
+            var serials = new List<string>();
+            try
+            {
+                foreach (UsbRegistry reg in UsbDevice.AllDevices)
                 {
-                    try
-                    {
-                        wholeUsbDevice.SetConfiguration(1);
-                        wholeUsbDevice.ClaimInterface(0);
-                        DiagnosticLogger.Log("[usb] Claimed interface 0, configuration 1");
-                    }
-                    catch (Exception ex)
+                    if (reg.Vid != VendorId || reg.Pid != ProductId) continue;
+                    string? serial = null;
+                    if (reg.Open(out UsbDevice dev))
                     {
-                        DiagnosticLogger.Log($"[usb] Error claiming interface/config: {ex.Message}");
+                        try { serial = dev.Info.SerialString; }
+                        finally { dev.Close(); }
                     }
+                    if (string.IsNullOrEmpty(serial))
+                        serial = UsbSymbolicName.Parse(reg.SymbolicName).SerialNumber;
+                    if (!string.IsNullOrEmpty(serial) && !serials.Contains(serial))
+                        serials.Add(serial);
                 }
+            }
+            catch (Exception ex)
+            {
+                DiagnosticLogger.Log($"[usb] Enumerating bridges failed: {ex.Message}");
+            }
+            serials.Sort(StringComparer.Ordinal);
+            return serials.ToArray();
+        }
+
+        public async Task<bool> ConnectAsync(string? serialNumber = null)
+        {
+            return await Task.Run(() => Connect(serialNumber));
+        }
 
-                // Enumerate endpoints for debug (LibUsbDotNet)
-                var config = _usbDevice.Configs[0];
-                foreach (var iface in config.InterfaceInfoList)
+        /// <summary>
+        /// Open the bridge with USB serial <paramref name="serialNumber"/>
+        /// (see <see cref="ListSerialNumbers"/>), or the first one found when null.
+        /// </summary>
+        public bool Connect(string? serialNumber = null)
+        {
+            var finder = serialNumber == null
+                ? new UsbDeviceFinder(VendorId, ProductId)
+                : new UsbDeviceFinder(VendorId, ProductId, serialNumber);
+            lock (s_libLock)
+            {
+                _usbDevice = UsbDevice.OpenUsbDevice(finder);
+                if (_usbDevice != null && !_counted)
                 {
-                    DiagnosticLogger.Log($"[usb] Interface {iface.Descriptor.InterfaceID}, AltSetting {iface.Descriptor.AlternateID}");
-                    foreach (var ep in iface.EndpointInfoList)
-                    {
-                        var addr = ep.Descriptor.EndpointID;
-                        string dir = (addr & 0x80) != 0 ? "IN" : "OUT";
-                        DiagnosticLogger.Log($"[usb]  Endpoint Addr=0x{addr:X2} ({dir}), Type={ep.Descriptor.Attributes & 0x3}, MaxPacket={ep.Descriptor.MaxPacketSize}");
-                    }
+                    s_openDevices++;
+                    _counted = true;
                 }
+            }
+            if (_usbDevice == null)
+            {
+                DiagnosticLogger.Log($"[usb] Device not found (VID=0x{VendorId:X4}, PID=0x{ProductId:X4}" +
+                                     $"{(serialNumber != null ? $", serial {serialNumber}" : "")})");
+                return false;
+            }
 
+            SerialNumber = _usbDevice.Info.SerialString;
+            DiagnosticLogger.Log($"[usb] Device found: {_usbDevice.Info}");
+
+            if (_usbDevice is IUsbDevice wholeUsbDevice)
+            {
                 try
                 {
-                    _reader = _usbDevice.OpenEndpointReader(ReadEndpointID.Ep01);
-                    DiagnosticLogger.Log("[usb] Opened EndpointReader Ep01 (0x81)");
+                    wholeUsbDevice.SetConfiguration(1);
+                    wholeUsbDevice.ClaimInterface(0);
+                    DiagnosticLogger.Log("[usb] Claimed interface 0, configuration 1");
                 }
                 catch (Exception ex)
                 {
-                    DiagnosticLogger.Log($"[usb] Failed to open EndpointReader Ep01: {ex.Message}");
+                    DiagnosticLogger.Log($"[usb] Error claiming interface/config: {ex.Message}");
                 }
-                try
+            }
+
+            // Enumerate endpoints for debug (LibUsbDotNet)
+            var config = _usbDevice.Configs[0];
+            foreach (var iface in config.InterfaceInfoList)
+            {
+                DiagnosticLogger.Log($"[usb] Interface {iface.Descriptor.InterfaceID}, AltSetting {iface.Descriptor.AlternateID}");
+                foreach (var ep in iface.EndpointInfoList)
                 {
-                    _writer = _usbDevice.OpenEndpointWriter(WriteEndpointID.Ep01);
-                    DiagnosticLogger.Log("[usb] Opened EndpointWriter Ep01 (0x01)");
+                    var addr = ep.Descriptor.EndpointID;
+                    string dir = (addr & 0x80) != 0 ? "IN" : "OUT";
+                    DiagnosticLogger.Log($"[usb]  Endpoint Addr=0x{addr:X2} ({dir}), Type={ep.Descriptor.Attributes & 0x3}, MaxPacket={ep.Descriptor.MaxPacketSize}");
                 }
-                catch (Exception ex)
+            }
+
+            try
+            {
+                _reader = _usbDevice.OpenEndpointReader(ReadEndpointID.Ep01);
+                DiagnosticLogger.Log("[usb] Opened EndpointReader Ep01 (0x81)");
+            }
+            catch (Exception ex)
+            {
+                DiagnosticLogger.Log($"[usb] Failed to open EndpointReader Ep01: {ex.Message}");
+            }
+            try
+            {
+                _writer = _usbDevice.OpenEndpointWriter(WriteEndpointID.Ep01);
+                DiagnosticLogger.Log("[usb] Opened EndpointWriter Ep01 (0x01)");
+            }
+            catch (Exception ex)
+            {
+                DiagnosticLogger.Log($"[usb] Failed to open EndpointWriter Ep01: {ex.Message}");
+            }
+            _connected = _reader != null;
+            return _connected;
+        }
+
+        /// <summary>Bulk IN max packet size (USB full speed).</summary>
+        public const int MaxPacketSize = 64;
+        /// <summary>
+        /// Default read size: 1024 packets.  One read spans many packets and
+        /// completes early on the short packet (or ZLP) that ends each frame,
+        /// so the device is never idle waiting for the next read request.
+        /// </summary>
+        public const int DefaultReadSize = 64 * 1024;
+        private const int ReadTimeoutMs = 5000;
+
+        /// <summary>Bulk IN transfers kept in flight by <see cref="StartReading"/>.</summary>
+        public const int ReadQueueDepth = 4;
+
+        private readonly byte[] _readBuf = new byte[DefaultReadSize];
+        private Thread? _readThread;
+        private volatile bool _reading;
+        private UsbTransfer?[]? _xfers;
+
+        /// <summary>
+        /// Stream the IN endpoint on a dedicated thread.  <see cref="ReadQueueDepth"/>
+        /// transfers of <see cref="DefaultReadSize"/> stay submitted at all times,
+        /// on buffers allocated once (pinned) and resubmitted as they complete,
+        /// so the device always has a read to fill and the steady state
+        /// allocates nothing.  <paramref name="onData"/> gets each completed
+        /// transfer (buffer, bytes) in order; the buffer is reused once it
+        /// returns.  Do not mix with <see cref="ReadAsync(int)"/>.
+        /// </summary>
+        public void StartReading(Action<byte[], int> onData)
+        {
+            if (!_connected || _reader == null) throw new InvalidOperationException("Device not connected");
+            if (_readThread != null) throw new InvalidOperationException("Already reading");
+            _reading = true;
+            _readThread = new Thread(() => ReadQueueLoop(onData))
+            {
+                Name = $"PicoUsbVendor.Read {SerialNumber}",
+                IsBackground = true,
+                Priority = ThreadPriority.AboveNormal,
+            };
+            _readThread.Start();
+        }
+
+        /// <summary>Stop <see cref="StartReading"/> and cancel the transfers in flight.</summary>
+        public void StopReading()
+        {
+            _reading = false;
+            var xfers = _xfers;
+            if (xfers != null)
+                foreach (var xfer in xfers)
+                    try { xfer?.Cancel(); } catch { }
+            _readThread?.Join(ReadTimeoutMs + 1000);
+            _readThread = null;
+        }
+
+        private void ReadQueueLoop(Action<byte[], int> onData)
+        {
+            var reader = _reader!;
+            var bufs = new byte[ReadQueueDepth][];
+            var xfers = new UsbTransfer?[ReadQueueDepth];
+            _xfers = xfers;
+            try
+            {
+                for (int i = 0; i < ReadQueueDepth; i++)
                 {
-                    DiagnosticLogger.Log($"[usb] Failed to open EndpointWriter Ep01: {ex.Message}");
+                    bufs[i] = GC.AllocateArray<byte>(DefaultReadSize, pinned: true);
+                    var ec = reader.SubmitAsyncTransfer(bufs[i], 0, DefaultReadSize, ReadTimeoutMs, out xfers[i]);
+                    if (ec != ErrorCode.None)
+                    {
+                        DiagnosticLogger.Log($"[usb] Submitting read {i} failed: {ec}");
+                        return;
+                    }
                 }
-                _connected = _reader != null;
-                return _connected;
-            });
+
+                // Transfers complete in submission order; the one resubmitted
+                // last is the newest, so waiting round-robin keeps the stream in order
+                for (int next = 0; _reading; next = (next + 1) % ReadQueueDepth)
+                {
+                    var xfer = xfers[next]!;
+                    var ec = xfer.Wait(out int n);
+                    if (!_reading) break;
+
+                    if (ec == ErrorCode.None)
+                    {
+                        if (n > 0)
+                        {
+                            TraceLog.Instant(TraceEvent.UsbRead, n);
+                            try
+                            {
+                                onData(bufs[next], n);
+                            }
+                            catch (Exception ex)
+                            {
+                                // A consumer bug must not end the stream; keep the transfer going
+                                DiagnosticLogger.Log($"[usb] Read handler failed: {ex.Message}");
+                            }
+                        }
+                        ec = xfer.Submit();
+                        if (ec == ErrorCode.None) continue;
+                    }
+                    else if (ec != ErrorCode.IoTimedOut)
+                    {
+                        DiagnosticLogger.Log($"[usb] Read failed: {ec}");
+                        Thread.Sleep(10);
+                    }
+
+                    // Timed out (cancelled) or failed: start over on a fresh transfer
+                    xfer.Dispose();
+                    xfers[next] = null;
+                    ec = reader.SubmitAsyncTransfer(bufs[next], 0, DefaultReadSize, ReadTimeoutMs, out xfers[next]);
+                    if (ec != ErrorCode.None)
+                    {
+                        DiagnosticLogger.Log($"[usb] Resubmitting read failed: {ec}");
+                        return;
+                    }
+                }
+            }
+            finally
+            {
+                foreach (var xfer in xfers)
+                {
+                    if (xfer == null) continue;
+                    try { xfer.Cancel(); xfer.Dispose(); } catch { }
+                }
+                _xfers = null;
+                _reading = false;
+            }
         }
 
-        public async Task<byte[]> ReadAsync(int length)
+        /// <summary>
+        /// Single read of up to <paramref name="length"/> bytes into a new array.
+        /// Allocates per call; stream with <see cref="StartReading"/> instead.
+        /// </summary>
+        public async Task<byte[]> ReadAsync(int length = DefaultReadSize)
         {
             return await Task.Run(() =>
             {
                 if (!_connected) throw new InvalidOperationException("Device not connected");
                 if (_reader == null) throw new InvalidOperationException("USB EndpointReader is null");
-                byte[] buffer = new byte[length];
+                // A read that is not a whole number of packets can overflow
+                // when the device sends a full packet into its last bytes
+                byte[] buffer = new byte[RoundUpToPacket(length)];
                 int bytesRead;
-                var ec = _reader.Read(buffer, 5000, out bytesRead);
+                var ec = _reader.Read(buffer, ReadTimeoutMs, out bytesRead);
                 if (ec == ErrorCode.None && bytesRead > 0)
                 {
-                    if (bytesRead == length) return buffer;
+                    if (bytesRead == buffer.Length) return buffer;
                     var outb = new byte[bytesRead];
                     Array.Copy(buffer, outb, bytesRead);
                     return outb;
@@ -96,18 +296,62 @@ namespace VilsSharpX
             });
         }
 
-        public async Task WriteAsync(byte[] data)
+        /// <summary>
+        /// Read into <paramref name="buffer"/> without allocating; returns the
+        /// bytes received (0 on timeout).  The read is cut to whole packets,
+        /// so pass at least <see cref="MaxPacketSize"/> bytes, ideally
+        /// <see cref="DefaultReadSize"/>.
+        /// </summary>
+        public async Task<int> ReadAsync(Memory<byte> buffer)
         {
-            await Task.Run(() =>
+            return await Task.Run(() =>
             {
                 if (!_connected) throw new InvalidOperationException("Device not connected");
-                if (_writer == null) throw new InvalidOperationException("USB EndpointWriter is null");
-                _writer.Write(data, 0, data.Length, 5000, out _);
+                if (_reader == null) throw new InvalidOperationException("USB EndpointReader is null");
+                int length = buffer.Length - buffer.Length % MaxPacketSize;
+                if (length == 0) throw new ArgumentException($"Buffer smaller than one packet ({MaxPacketSize} bytes)", nameof(buffer));
+
+                int bytesRead;
+                ErrorCode ec;
+                if (MemoryMarshal.TryGetArray((ReadOnlyMemory<byte>)buffer, out ArraySegment<byte> seg))
+                {
+                    ec = _reader.Read(seg.Array!, seg.Offset, length, ReadTimeoutMs, out bytesRead);
+                }
+                else
+                {
+                    // Native memory: stage through the reader's own buffer
+                    lock (_readBuf)
+                    {
+                        ec = _reader.Read(_readBuf, 0, Math.Min(length, _readBuf.Length), ReadTimeoutMs, out bytesRead);
+                        if (ec == ErrorCode.None && bytesRead > 0)
+                            _readBuf.AsSpan(0, bytesRead).CopyTo(buffer.Span);
+                    }
+                }
+                return ec == ErrorCode.None ? bytesRead : 0;
             });
         }
 
+        private static int RoundUpToPacket(int length) =>
+            Math.Max(MaxPacketSize, (length + MaxPacketSize - 1) / MaxPacketSize * MaxPacketSize);
+
+        public async Task WriteAsync(byte[] data)
+        {
+            await Task.Run(() => Write(data));
+        }
+
+        /// <summary>Blocking bulk OUT write (host commands are a few bytes).</summary>
+        public void Write(byte[] data)
+        {
+            if (!_connected) throw new InvalidOperationException("Device not connected");
+            if (_writer == null) throw new InvalidOperationException("USB EndpointWriter is null");
+            var ec = _writer.Write(data, 0, data.Length, 5000, out _);
+            if (ec != ErrorCode.None)
+                throw new InvalidOperationException($"USB write failed: {ec}");
+        }
+
         public void Dispose()
         {
+            StopReading();
             try
             {
                 if (_usbDevice != null)
@@ -120,7 +364,13 @@ namespace VilsSharpX
                         }
                         _usbDevice.Close();
                     }
-                    UsbDevice.Exit();
+                    _usbDevice = null;
+                }
+                lock (s_libLock)
+                {
+                    if (_counted && --s_openDevices == 0)
+                        UsbDevice.Exit();
+                    _counted = false;
                 }
             }
             catch { }
@@ -1,6 +1,7 @@
 ﻿using System;
 using System.Globalization;
 using System.IO;
+using System.Threading;
 
 namespace VilsSharpX
 {
@@ -12,8 +13,10 @@ namespace VilsSharpX
         private readonly int _width;
         private readonly int _height;
 
-        private AviTripletRecorder? _recorder;
-        private bool _isRecording;
+        // Frames are enqueued from the compositor thread (FrameCompositor.Recorder)
+        private volatile AviTripletRecorder? _recorder;
+        private LvdsLiveManager? _lvdsCapture;   // also writing a native LVDS capture file
+        private volatile bool _isRecording;
         private int _recordDropped;
 
         public bool IsRecording => _isRecording;
@@ -27,9 +30,12 @@ namespace VilsSharpX
         }
 
         /// <summary>
-        /// Starts recording to AVI files.
+        /// Starts recording to AVI files.  With a capturing <paramref name="lvds"/>,
+        /// its frames and telemetry also go unchanged to a native capture file
+        /// (<c>{ts}_LVDS.lvdscap</c>), see <see cref="LvdsCaptureWriter"/>.
         /// </summary>
-        public (bool success, string? error, string? statusMessage) StartRecording(int fps, byte diffThreshold)
+        public (bool success, string? error, string? statusMessage) StartRecording(int fps, byte diffThreshold,
+            LvdsLiveManager? lvds = null)
         {
             if (fps <= 0) fps = 30;
 
@@ -48,13 +54,23 @@ namespace VilsSharpX
                     compareCsvPath: pathXlsx, compareDeadband: diffThreshold);
                 _recordDropped = 0;
                 _isRecording = true;
-                return (true, null, $"Recording AVI to: {outDir}  ({ts}_AVTP/LVDS/Compare) @ {fps} fps");
+
+                string capInfo = "";
+                if (lvds != null && lvds.IsCapturing)
+                {
+                    string pathCap = MakeUniquePath(Path.Combine(outDir, $"{ts}_LVDS{LvdsCaptureWriter.FileExtension}"));
+                    lvds.StartCaptureFile(pathCap);
+                    _lvdsCapture = lvds;
+                    capInfo = $" + {Path.GetFileName(pathCap)}";
+                }
+                return (true, null, $"Recording AVI to: {outDir}  ({ts}_AVTP/LVDS/Compare{capInfo}) @ {fps} fps");
             }
             catch (Exception ex)
             {
                 try { _recorder?.Dispose(); } catch { }
                 _recorder = null;
                 _isRecording = false;
+                StopLvdsCapture();
                 return (false, ex.Message, null);
             }
         }
@@ -84,21 +100,36 @@ namespace VilsSharpX
             _recorder = null;
 
             string fpsInfo = actualFps > 0 ? $" Actual fps: {actualFps:F1}" : "";
+            string? capInfo = StopLvdsCapture();
+            if (capInfo != null) fpsInfo += $" {capInfo}.";
             return _recordDropped > 0
                 ? $"Recording stopped. Dropped frames (queue full): {_recordDropped}.{fpsInfo}"
                 : $"Recording stopped.{fpsInfo}";
         }
 
+        private string? StopLvdsCapture()
+        {
+            var lvds = _lvdsCapture;
+            _lvdsCapture = null;
+            try { return lvds?.StopCaptureFile(); }
+            catch (Exception ex) { return $"LVDS capture failed: {ex.Message}"; }
+        }
+
         /// <summary>
         /// Tries to enqueue a frame for recording. Returns false if queue is full.
+        /// Safe to call from any thread, also while recording stops.
         /// </summary>
         public bool TryEnqueueFrame(byte[] aData, byte[] bData, byte[] dBgr)
         {
-            if (!_isRecording || _recorder == null) return false;
+            var recorder = _recorder;
+            if (!_isRecording || recorder == null) return false;
 
-            if (!_recorder.TryEnqueue(aData, bData, dBgr))
+            bool accepted;
+            try { accepted = recorder.TryEnqueue(aData, bData, dBgr); }
+            catch (InvalidOperationException) { return false; }   // stopped meanwhile (also ObjectDisposedException)
+            if (!accepted)
             {
-                _recordDropped++;
+                Interlocked.Increment(ref _recordDropped);
                 return false;
             }
             return true;
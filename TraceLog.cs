@@ -0,0 +1,467 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Text.Json;
+using System.Threading;
+
+namespace VilsSharpX;
+
+/// <summary>Trace points of <see cref="TraceLog"/>; the names end up in the trace.</summary>
+public enum TraceEvent : ushort
+{
+    UsbRead = 1,            // completed bulk IN transfer: bytes
+    SerialRead,             // COM port read: bytes
+    ReceiverPush,           // LvdsCookedFrameReceiver.Push span: bytes
+    ReceiverFrame,          // frame complete in the receiver: frame id, channel
+    FrameReady,             // LvdsLiveManager raised a frame: frame id, channel
+    Render,                 // MainWindow.RenderAll span
+    DiffRender,             // DiffRenderer.RenderCompareToBgr span: pixels
+    AviEnqueue,             // AviTripletRecorder.TryEnqueue: accepted, queued
+    AviWrite,               // AviTripletRecorder worker, one frame set: frame
+    CaptureFileWrite,       // LvdsCaptureWriter record: bytes
+    Compose,                // FrameCompositor worker, one frame: request sequence
+    Present,                // MainWindow blits a composed frame at vsync: request sequence
+    PcapTxBatch,            // PcapReplayTransmitter sends one send queue: packets
+}
+
+/// <summary>
+/// Low-overhead binary tracing for the capture, render and record paths.
+///
+/// Each thread that traces gets its own ring of fixed-size events
+/// (Stopwatch timestamp, <see cref="TraceEvent"/>, kind, two integer
+/// arguments) that only it writes, so a trace point takes no lock and
+/// allocates nothing after the thread's first event.  A background thread
+/// drains the rings every <see cref="DrainIntervalMs"/>, or as soon as one
+/// is half full, into a compact binary file; <see cref="ExportChromeJson"/> turns it into Chrome /
+/// Perfetto trace JSON (chrome://tracing, ui.perfetto.dev).  A full ring
+/// drops new events and counts them.  With tracing off a trace point is
+/// one static field read.
+///
+/// File ("VTRACE01"): [magic:8] [stopwatch_freq:8] [start_ticks:8] [start_utc_ticks:8],
+/// then blocks of [type] + body:
+///   1 event name   [id:2] [name] [arg0 name] [arg1 name]    (strings: [len] + UTF-8)
+///   2 thread       [tid:4] [name]
+///   3 events       [tid:4] [count:4] count × 32-byte <see cref="Record"/>
+///   4 drops        [tid:4] [count:8] [ticks:8]   (running total of the thread's lost events)
+/// </summary>
+public static class TraceLog
+{
+    public const string FileExtension = ".vtrace";
+    public const int RingSize = 4096;
+    public const int DrainIntervalMs = 50;
+
+    private const int RingMask = RingSize - 1;
+    private const byte BlockEventName = 1, BlockThread = 2, BlockEvents = 3, BlockDrops = 4;
+    private static ReadOnlySpan<byte> Magic => "VTRACE01"u8;
+
+    private const byte KindBegin = (byte)'B', KindEnd = (byte)'E', KindInstant = (byte)'i', KindCounter = (byte)'C';
+
+    [StructLayout(LayoutKind.Sequential)]
+    private struct Record
+    {
+        public long Ticks;
+        public long Arg0;
+        public long Arg1;
+        public ushort Id;
+        public byte Kind;
+        private byte _pad0;
+        private int _pad1;
+    }
+
+    private sealed class Ring
+    {
+        public readonly Record[] Events = new Record[RingSize];
+        public readonly int ThreadId = Environment.CurrentManagedThreadId;
+        public readonly string Name = Thread.CurrentThread.Name ?? $"thread {Environment.CurrentManagedThreadId}";
+        public long Head;           // written by the owning thread
+        public long Tail;           // written by the drain thread
+        public long Dropped;        // written by the owning thread
+        public long DroppedWritten; // drain thread only
+        public bool Announced;      // drain thread only
+    }
+
+    [ThreadStatic] private static Ring? t_ring;
+
+    private static readonly object _lock = new();
+    private static Ring[] _rings = Array.Empty<Ring>();   // copy-on-write, under _lock
+    private static volatile bool _enabled;
+    private static FileStream? _file;
+    private static Thread? _drainThread;
+    private static readonly AutoResetEvent _wake = new(false);
+    private static byte[] _drainBuf = Array.Empty<byte>();
+
+    /// <summary>Tracing to a file (<see cref="Start"/>).</summary>
+    public static bool Enabled => _enabled;
+
+    /// <summary>File of the current or last session; null before the first <see cref="Start"/>.</summary>
+    public static string? Path { get; private set; }
+
+    /// <summary>Events lost to full rings since <see cref="Start"/>.</summary>
+    public static long DroppedEvents
+    {
+        get
+        {
+            long n = 0;
+            foreach (var r in Volatile.Read(ref _rings))
+                n += Volatile.Read(ref r.Dropped);
+            return n;
+        }
+    }
+
+    // ── Trace points ────────────────────────────────────────────────────
+
+    public static void Begin(TraceEvent id, long arg0 = 0, long arg1 = 0)
+    {
+        if (_enabled) Write(id, KindBegin, arg0, arg1);
+    }
+
+    public static void End(TraceEvent id, long arg0 = 0, long arg1 = 0)
+    {
+        if (_enabled) Write(id, KindEnd, arg0, arg1);
+    }
+
+    public static void Instant(TraceEvent id, long arg0 = 0, long arg1 = 0)
+    {
+        if (_enabled) Write(id, KindInstant, arg0, arg1);
+    }
+
+    public static void Counter(TraceEvent id, long value)
+    {
+        if (_enabled) Write(id, KindCounter, value, 0);
+    }
+
+    /// <summary>Begin now, end when the returned scope is disposed (<c>using var _ = TraceLog.Scope(...)</c>).</summary>
+    public static TraceScope Scope(TraceEvent id, long arg0 = 0, long arg1 = 0)
+    {
+        if (!_enabled) return default;
+        Write(id, KindBegin, arg0, arg1);
+        return new TraceScope(id);
+    }
+
+    public readonly struct TraceScope : IDisposable
+    {
+        private readonly TraceEvent _id;
+        internal TraceScope(TraceEvent id) => _id = id;
+        public void Dispose()
+        {
+            if (_id != 0) End(_id);
+        }
+    }
+
+    private static void Write(TraceEvent id, byte kind, long arg0, long arg1)
+    {
+        var r = t_ring ?? CreateRing();
+        long head = r.Head;
+        long used = head - Volatile.Read(ref r.Tail);
+        if (used >= RingSize)
+        {
+            Volatile.Write(ref r.Dropped, r.Dropped + 1);
+            return;
+        }
+        if (used == RingSize / 2)
+            _wake.Set();   // filling fast: drain before the next interval
+        ref var e = ref r.Events[head & RingMask];
+        e.Ticks = Stopwatch.GetTimestamp();
+        e.Arg0 = arg0;
+        e.Arg1 = arg1;
+        e.Id = (ushort)id;
+        e.Kind = kind;
+        Volatile.Write(ref r.Head, head + 1);
+    }
+
+    private static Ring CreateRing()
+    {
+        var r = new Ring();
+        lock (_lock)
+        {
+            var rings = new Ring[_rings.Length + 1];
+            _rings.CopyTo(rings, 0);
+            rings[^1] = r;
+            Volatile.Write(ref _rings, rings);
+        }
+        t_ring = r;
+        return r;
+    }
+
+    // ── Session ─────────────────────────────────────────────────────────
+
+    /// <summary>
+    /// Start tracing into <paramref name="path"/> (replaces a running session).
+    /// Events already in the rings are discarded.
+    /// </summary>
+    public static void Start(string path)
+    {
+        lock (_lock)
+        {
+            StopLocked();
+
+            string? dir = System.IO.Path.GetDirectoryName(path);
+            if (!string.IsNullOrWhiteSpace(dir)) Directory.CreateDirectory(dir);
+            var fs = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.Read, 1 << 16);
+
+            Span<byte> hdr = stackalloc byte[32];
+            Magic.CopyTo(hdr);
+            BinaryPrimitives.WriteInt64LittleEndian(hdr.Slice(8), Stopwatch.Frequency);
+            BinaryPrimitives.WriteInt64LittleEndian(hdr.Slice(16), Stopwatch.GetTimestamp());
+            BinaryPrimitives.WriteInt64LittleEndian(hdr.Slice(24), DateTime.UtcNow.Ticks);
+            fs.Write(hdr);
+            foreach (TraceEvent id in Enum.GetValues<TraceEvent>())
+            {
+                var (a0, a1) = ArgNames(id);
+                hdr[0] = BlockEventName;
+                BinaryPrimitives.WriteUInt16LittleEndian(hdr.Slice(1), (ushort)id);
+                fs.Write(hdr.Slice(0, 3));
+                WriteString(fs, id.ToString());
+                WriteString(fs, a0);
+                WriteString(fs, a1);
+            }
+
+            foreach (var r in _rings)
+            {
+                Volatile.Write(ref r.Tail, Volatile.Read(ref r.Head));
+                Volatile.Write(ref r.Dropped, 0);
+                r.DroppedWritten = 0;
+                r.Announced = false;
+            }
+
+            _file = fs;
+            Path = path;
+            _enabled = true;
+            _drainThread = new Thread(DrainLoop) { Name = "TraceLog.Drain", IsBackground = true };
+            _drainThread.Start();
+        }
+    }
+
+    /// <summary>Stop tracing and close the file, after writing the events still in the rings.</summary>
+    public static void Stop()
+    {
+        lock (_lock) StopLocked();
+    }
+
+    private static void StopLocked()
+    {
+        if (_file == null) return;
+        _enabled = false;
+        var t = _drainThread;
+        _drainThread = null;
+        _wake.Set();
+        t?.Join();
+        try
+        {
+            Drain(_file);
+            _file.Dispose();
+        }
+        catch { }
+        _file = null;
+    }
+
+    private static void DrainLoop()
+    {
+        var fs = _file!;
+        while (_enabled)
+        {
+            _wake.WaitOne(DrainIntervalMs);
+            try { Drain(fs); }
+            catch { _enabled = false; }   // disk full or similar: stop tracing, keep the app going
+        }
+    }
+
+    private static void Drain(FileStream fs)
+    {
+        Span<byte> hdr = stackalloc byte[21];
+        foreach (var r in Volatile.Read(ref _rings))
+        {
+            if (!r.Announced)
+            {
+                fs.WriteByte(BlockThread);
+                BinaryPrimitives.WriteInt32LittleEndian(hdr, r.ThreadId);
+                fs.Write(hdr.Slice(0, 4));
+                WriteString(fs, r.Name);
+                r.Announced = true;
+            }
+
+            long head = Volatile.Read(ref r.Head);
+            long tail = r.Tail;
+            int count = (int)(head - tail);
+            if (count > 0)
+            {
+                int bytes = count * Marshal.SizeOf<Record>();
+                if (_drainBuf.Length < bytes) _drainBuf = new byte[RingSize * Marshal.SizeOf<Record>()];
+                var dst = MemoryMarshal.Cast<byte, Record>(_drainBuf.AsSpan(0, bytes));
+                int first = (int)(tail & RingMask);
+                int n1 = Math.Min(count, RingSize - first);
+                r.Events.AsSpan(first, n1).CopyTo(dst);
+                r.Events.AsSpan(0, count - n1).CopyTo(dst.Slice(n1));
+                Volatile.Write(ref r.Tail, head);
+
+                hdr[0] = BlockEvents;
+                BinaryPrimitives.WriteInt32LittleEndian(hdr.Slice(1), r.ThreadId);
+                BinaryPrimitives.WriteInt32LittleEndian(hdr.Slice(5), count);
+                fs.Write(hdr.Slice(0, 9));
+                fs.Write(_drainBuf, 0, bytes);
+            }
+
+            long dropped = Volatile.Read(ref r.Dropped);
+            if (dropped != r.DroppedWritten)
+            {
+                hdr[0] = BlockDrops;
+                BinaryPrimitives.WriteInt32LittleEndian(hdr.Slice(1), r.ThreadId);
+                BinaryPrimitives.WriteInt64LittleEndian(hdr.Slice(5), dropped);
+                BinaryPrimitives.WriteInt64LittleEndian(hdr.Slice(13), Stopwatch.GetTimestamp());
+                fs.Write(hdr);
+                r.DroppedWritten = dropped;
+            }
+        }
+        fs.Flush();
+    }
+
+    private static (string, string) ArgNames(TraceEvent id) => id switch
+    {
+        TraceEvent.UsbRead or TraceEvent.SerialRead or TraceEvent.ReceiverPush
+            or TraceEvent.CaptureFileWrite => ("bytes", ""),
+        TraceEvent.ReceiverFrame or TraceEvent.FrameReady => ("frame", "channel"),
+        TraceEvent.DiffRender => ("pixels", ""),
+        TraceEvent.AviEnqueue => ("accepted", "queued"),
+        TraceEvent.AviWrite => ("frame", ""),
+        TraceEvent.PcapTxBatch => ("packets", ""),
+        _ => ("", ""),
+    };
+
+    private static void WriteString(Stream s, string value)
+    {
+        Span<byte> buf = stackalloc byte[256];
+        int n = Encoding.UTF8.GetBytes(value.AsSpan(0, Math.Min(value.Length, 80)), buf.Slice(1));
+        buf[0] = (byte)n;
+        s.Write(buf.Slice(0, n + 1));
+    }
+
+    // ── Export ──────────────────────────────────────────────────────────
+
+    /// <summary>
+    /// Convert a trace file to Chrome trace-event JSON (timestamps in µs
+    /// since <see cref="Start"/>, one track per thread).  Returns the
+    /// number of events written.
+    /// </summary>
+    public static int ExportChromeJson(string tracePath, string jsonPath)
+    {
+        var data = File.ReadAllBytes(tracePath);
+        if (data.Length < 32 || !data.AsSpan(0, 8).SequenceEqual(Magic))
+            throw new InvalidDataException("Not a trace file");
+        long freq = BinaryPrimitives.ReadInt64LittleEndian(data.AsSpan(8));
+        long start = BinaryPrimitives.ReadInt64LittleEndian(data.AsSpan(16));
+
+        var names = new Dictionary<ushort, (string Name, string A0, string A1)>();
+        int recSize = Marshal.SizeOf<Record>();
+        int events = 0;
+
+        using var fs = new FileStream(jsonPath, FileMode.Create, FileAccess.Write);
+        using var w = new Utf8JsonWriter(fs);
+        w.WriteStartObject();
+        w.WriteString("displayTimeUnit", "ns");
+        w.WriteStartArray("traceEvents");
+
+        int pos = 32;
+        while (pos < data.Length)
+        {
+            byte type = data[pos++];
+            switch (type)
+            {
+                case BlockEventName:
+                {
+                    ushort id = BinaryPrimitives.ReadUInt16LittleEndian(data.AsSpan(pos));
+                    pos += 2;
+                    string name = ReadString(data, ref pos), a0 = ReadString(data, ref pos), a1 = ReadString(data, ref pos);
+                    names[id] = (name, a0, a1);
+                    break;
+                }
+                case BlockThread:
+                {
+                    int tid = BinaryPrimitives.ReadInt32LittleEndian(data.AsSpan(pos));
+                    pos += 4;
+                    string name = ReadString(data, ref pos);
+                    w.WriteStartObject();
+                    w.WriteString("name", "thread_name");
+                    w.WriteString("ph", "M");
+                    w.WriteNumber("pid", 1);
+                    w.WriteNumber("tid", tid);
+                    w.WriteStartObject("args");
+                    w.WriteString("name", name);
+                    w.WriteEndObject();
+                    w.WriteEndObject();
+                    break;
+                }
+                case BlockEvents:
+                {
+                    int tid = BinaryPrimitives.ReadInt32LittleEndian(data.AsSpan(pos));
+                    int count = BinaryPrimitives.ReadInt32LittleEndian(data.AsSpan(pos + 4));
+                    pos += 8;
+                    var recs = MemoryMarshal.Cast<byte, Record>(data.AsSpan(pos, count * recSize));
+                    pos += count * recSize;
+                    foreach (ref readonly var e in recs)
+                    {
+                        if (!names.TryGetValue(e.Id, out var n)) n = ($"event {e.Id}", "", "");
+                        w.WriteStartObject();
+                        w.WriteString("name", n.Name);
+                        w.WriteString("ph", ((char)e.Kind).ToString());
+                        w.WriteNumber("ts", Math.Round((e.Ticks - start) * 1e6 / freq, 3));
+                        w.WriteNumber("pid", 1);
+                        w.WriteNumber("tid", tid);
+                        if (e.Kind == KindInstant) w.WriteString("s", "t");
+                        if (e.Kind == KindCounter)
+                        {
+                            w.WriteStartObject("args");
+                            w.WriteNumber("value", e.Arg0);
+                            w.WriteEndObject();
+                        }
+                        else if (n.A0.Length > 0 || n.A1.Length > 0)
+                        {
+                            w.WriteStartObject("args");
+                            if (n.A0.Length > 0) w.WriteNumber(n.A0, e.Arg0);
+                            if (n.A1.Length > 0) w.WriteNumber(n.A1, e.Arg1);
+                            w.WriteEndObject();
+                        }
+                        w.WriteEndObject();
+                        events++;
+                    }
+                    break;
+                }
+                case BlockDrops:
+                {
+                    int tid = BinaryPrimitives.ReadInt32LittleEndian(data.AsSpan(pos));
+                    long dropped = BinaryPrimitives.ReadInt64LittleEndian(data.AsSpan(pos + 4));
+                    long ticks = BinaryPrimitives.ReadInt64LittleEndian(data.AsSpan(pos + 12));
+                    pos += 20;
+                    w.WriteStartObject();
+                    w.WriteString("name", "dropped events");
+                    w.WriteString("ph", "C");
+                    w.WriteNumber("ts", Math.Round((ticks - start) * 1e6 / freq, 3));
+                    w.WriteNumber("pid", 1);
+                    w.WriteNumber("tid", tid);
+                    w.WriteStartObject("args");
+                    w.WriteNumber("value", dropped);
+                    w.WriteEndObject();
+                    w.WriteEndObject();
+                    break;
+                }
+                default:
+                    throw new InvalidDataException($"Unknown trace block {type} at offset {pos - 1}");
+            }
+        }
+
+        w.WriteEndArray();
+        w.WriteEndObject();
+        return events;
+    }
+
+    private static string ReadString(byte[] data, ref int pos)
+    {
+        int n = data[pos];
+        string s = Encoding.UTF8.GetString(data, pos + 1, n);
+        pos += 1 + n;
+        return s;
+    }
+}
@@ -0,0 +1,155 @@
+using System;
+using System.Diagnostics;
+using System.IO;
+
+namespace VilsSharpX.Bench;
+
+/// <summary>
+/// <see cref="LvdsCaptureWriter"/> / <see cref="LvdsCaptureReader"/>: records
+/// pooled Osram frames plus telemetry to a temporary capture file, reads
+/// every frame back and compares it, opens the same file without its index
+/// (the writer never closed it) and times appends, open and random seeks.
+/// </summary>
+internal static class CaptureBench
+{
+    private const int Frames = 3000;
+    private const int TelemetryEvery = 30;
+
+    public static bool Run()
+    {
+        Console.WriteLine("LvdsCaptureWriter / LvdsCaptureReader");
+        int w = LvdsProtocol.OsramW, h = LvdsProtocol.OsramH_Active;
+        string path = Path.Combine(Path.GetTempPath(), $"hostbench_{Environment.ProcessId}{LvdsCaptureWriter.FileExtension}");
+        string unindexed = Path.ChangeExtension(path, ".unindexed" + LvdsCaptureWriter.FileExtension);
+        bool ok = true;
+        try
+        {
+            var telemetry = MakeTelemetry();
+            var pool = new LvdsFramePool(bufferSize: w * h);
+            var pixels = new byte[w * h];
+
+            var cpu = Process.GetCurrentProcess().TotalProcessorTime;
+            var sw = Stopwatch.StartNew();
+            long appendTicks = 0;
+            using (var writer = new LvdsCaptureWriter(path, preallocateBytes: 16 << 20, queueCapacity: Frames))
+            {
+                for (int f = 0; f < Frames; f++)
+                {
+                    Fill(pixels, f);
+                    using var lease = pool.Rent(pixels, Meta(f, w, h));
+                    long t0 = Stopwatch.GetTimestamp();
+                    ok &= writer.TryAppend(lease);
+                    if (f % TelemetryEvery == 0)
+                        ok &= writer.TryAppend(telemetry);
+                    appendTicks += Stopwatch.GetTimestamp() - t0;
+                }
+            }
+            double writeMs = sw.Elapsed.TotalMilliseconds;
+            double cpuMs = (Process.GetCurrentProcess().TotalProcessorTime - cpu).TotalMilliseconds;
+            long fileBytes = new FileInfo(path).Length;
+            Console.WriteLine($"  write   {Frames} frames, {fileBytes / (1024.0 * 1024.0):F1} MiB in {writeMs:F0} ms" +
+                              $"  ({fileBytes / 1000.0 / writeMs:F0} MB/s, append {appendTicks * 1e9 / Stopwatch.Frequency / Frames:F0} ns/frame," +
+                              $" process CPU {cpuMs:F0} ms)");
+
+            ok &= Verify(path, expectComplete: true, w, h);
+
+            // Same records without the index: clear the header flag, as if the writer had crashed
+            File.Copy(path, unindexed, overwrite: true);
+            using (var fs = new FileStream(unindexed, FileMode.Open, FileAccess.ReadWrite))
+            {
+                fs.Position = 12;
+                fs.Write(new byte[4]);
+            }
+            ok &= Verify(unindexed, expectComplete: false, w, h);
+
+            sw.Restart();
+            using (var reader = LvdsCaptureReader.Open(path))
+            {
+                double openUs = sw.Elapsed.TotalMilliseconds * 1000;
+                var rng = new Random(1);
+                long sum = 0;
+                double seekUs = Program.TimeUs(() =>
+                {
+                    int i = rng.Next(reader.FrameCount);
+                    sum += reader.GetPixels(i)[i % (w * h)] + reader.GetMeta(i).FrameId;
+                });
+                double scanUs = Program.TimeUs(() =>
+                {
+                    for (int i = 0; i < reader.FrameCount; i++)
+                        sum += reader.GetPixels(i)[0];
+                }, 100);
+                Console.WriteLine($"  read    open {openUs:F0} µs, random seek {seekUs * 1000:F0} ns/frame," +
+                                  $" index walk {scanUs * 1000 / reader.FrameCount:F0} ns/frame  (#{sum & 0xFF:X2})");
+            }
+        }
+        finally
+        {
+            try { File.Delete(path); } catch { }
+            try { File.Delete(unindexed); } catch { }
+        }
+
+        if (!ok)
+            Console.WriteLine("  MISMATCH between frames written and read back");
+        return ok;
+    }
+
+    private static bool Verify(string path, bool expectComplete, int w, int h)
+    {
+        using var reader = LvdsCaptureReader.Open(path);
+        bool ok = reader.IsComplete == expectComplete && reader.FrameCount == Frames &&
+                  reader.TelemetryCount == (Frames + TelemetryEvery - 1) / TelemetryEvery;
+        var expect = new byte[w * h];
+        for (int f = 0; ok && f < reader.FrameCount; f++)
+        {
+            Fill(expect, f);
+            var meta = reader.GetMeta(f);
+            var want = Meta(f, w, h);
+            ok = reader.GetPixels(f).SequenceEqual(expect) && meta.FrameId == want.FrameId &&
+                 meta.FirmwareTimestampUs == want.FirmwareTimestampUs && meta.HostTimestampUs == want.HostTimestampUs &&
+                 meta.Width == w && meta.Height == h && meta.ValidLines == want.ValidLines &&
+                 meta.LineValidityMask.AsSpan().SequenceEqual(want.LineValidityMask) &&
+                 reader.FindFrame(want.HostTimestampUs) == f;
+        }
+        var t = reader.TelemetryCount > 0 ? reader.GetTelemetry(reader.TelemetryCount - 1) : null;
+        ok &= t != null && t.FramesSent == 1234 && reader.FindTelemetry(long.MaxValue) == reader.TelemetryCount - 1;
+        Console.WriteLine($"  verify  {(expectComplete ? "indexed" : "scanned")} {reader.FrameCount} frames, {reader.TelemetryCount} telemetry: {(ok ? "ok" : "FAIL")}");
+        return ok;
+    }
+
+    private static void Fill(byte[] pixels, int frame)
+    {
+        for (int i = 0; i < pixels.Length; i++)
+            pixels[i] = (byte)(i * 7 + frame * 13 + (i >> 8));
+    }
+
+    private static LvdsFrameMeta Meta(int frame, int w, int h)
+    {
+        var mask = new bool[h];
+        for (int r = 0; r < h; r++)
+            mask[r] = (r + frame) % 17 != 0;
+        return new LvdsFrameMeta
+        {
+            FrameId = (uint)frame,
+            FirmwareFrameId = (uint)frame * 2,
+            FirmwareTimestampUs = 1_000_000UL + (ulong)frame * 16_667,
+            HostTimestampUs = 5_000_000L + frame * 16_667L,
+            Width = w,
+            Height = h,
+            SourceWidth = w,
+            SourceHeight = h,
+            LinesReceived = h,
+            ValidLines = h - 1,
+            LinesExpected = h,
+            LineValidityMask = mask,
+            ChangedRows = h,
+        };
+    }
+
+    private static LvdsFirmwareTelemetry MakeTelemetry()
+    {
+        var body = new byte[16 + 20 * 4 + 4];
+        body[8] = 1;                                   // Osram
+        BitConverter.TryWriteBytes(body.AsSpan(16), 1234u);   // FramesSent
+        return LvdsFirmwareTelemetry.TryParse(1, body)!;
+    }
+}
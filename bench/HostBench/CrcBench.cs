@@ -0,0 +1,71 @@
+using System;
+
+namespace VilsSharpX.Bench;
+
+/// <summary>
+/// <see cref="LvdsCrc"/>: throughput of the bytewise reference, slicing-by-8
+/// and the default (hardware when available) paths on Nichia and Osram lines,
+/// and whole-frame batch verification.
+/// </summary>
+internal static class CrcBench
+{
+    public static bool Run()
+    {
+        Console.WriteLine($"LvdsCrc  CRC-32 hardware={LvdsCrc.Crc32Hardware ?? "none"}");
+        bool ok = true;
+        foreach (var (name, passed, detail) in LvdsCrc.RunSelfTest())
+        {
+            if (!passed)
+            {
+                Console.WriteLine($"  self-test FAILED: {name}: {detail}");
+                ok = false;
+            }
+        }
+
+        var rng = new Random(1);
+        foreach (int len in new[] { LvdsProtocol.NichiaW, LvdsProtocol.OsramW, 4096 })
+        {
+            var data = new byte[len];
+            rng.NextBytes(data);
+            ushort r16 = 0, f16 = 0;
+            uint r32 = 0, s32 = 0, f32 = 0;
+            double t16r = Program.TimeUs(() => r16 = LvdsCrc.ComputeCrc16Bytewise(data));
+            double t16 = Program.TimeUs(() => f16 = LvdsCrc.ComputeCrc16(data));
+            double t32r = Program.TimeUs(() => r32 = LvdsCrc.ComputeCrc32Bytewise(data));
+            double t32s = Program.TimeUs(() => s32 = LvdsCrc.ComputeCrc32Slicing8(data));
+            double t32 = Program.TimeUs(() => f32 = LvdsCrc.ComputeCrc32(data));
+            ok &= r16 == f16 && r32 == s32 && r32 == f32;
+            Console.WriteLine($"  {len,5} B  CRC16 bytewise {Mbs(len, t16r),7:F0} MB/s  slicing8 {Mbs(len, t16),7:F0} MB/s" +
+                              $"  | CRC32 bytewise {Mbs(len, t32r),7:F0}  slicing8 {Mbs(len, t32s),7:F0}  default {Mbs(len, t32),7:F0} MB/s");
+        }
+
+        foreach (bool crc32 in new[] { false, true })
+        {
+            int w = crc32 ? LvdsProtocol.OsramW : LvdsProtocol.NichiaW;
+            int h = crc32 ? LvdsProtocol.OsramH_Lvds : LvdsProtocol.NichiaH_Lvds;
+            var frame = new byte[w * h];
+            rng.NextBytes(frame);
+            var expected = new uint[h];
+            var check = new bool[h];
+            var good = new bool[h];
+            for (int r = 0; r < h; r++)
+            {
+                var line = frame.AsSpan(r * w, w);
+                expected[r] = crc32 ? LvdsCrc.ComputeCrc32Bytewise(line) : LvdsCrc.ComputeCrc16Bytewise(line);
+                check[r] = true;
+            }
+            int failed = 0;
+            double t = Program.TimeUs(() => failed = crc32
+                ? LvdsCrc.VerifyLinesCrc32(frame, w, w, expected, check, good)
+                : LvdsCrc.VerifyLinesCrc16(frame, w, w, expected, check, good));
+            ok &= failed == 0;
+            Console.WriteLine($"  {(crc32 ? "osram " : "nichia")} frame {w}x{h}  batch verify {t,7:F2} us" +
+                              $"  {1e6 / t,9:F0} frames/s  ({Mbs(w * h, t):F0} MB/s)");
+        }
+        if (!ok)
+            Console.WriteLine("  MISMATCH against the bytewise reference");
+        return ok;
+    }
+
+    private static double Mbs(int bytes, double us) => bytes / us;
+}
@@ -0,0 +1,102 @@
+using System;
+using System.Numerics;
+
+namespace VilsSharpX.Bench;
+
+/// <summary>
+/// <see cref="DiffRenderer.RenderCompareToBgr"/> against
+/// <see cref="DiffRenderer.RenderCompareToBgrScalar"/>: panel-sized and
+/// full-HD frames, with B equal to A, noisy, partly dark, and unrelated.
+/// </summary>
+internal static class DiffRendererBench
+{
+    private static readonly (string Name, int W, int H)[] Sizes =
+    {
+        ("nichia", 256, 64),
+        ("osram", 320, 80),
+        ("1080p", 1920, 1080),
+    };
+
+    private static readonly string[] Patterns = { "equal", "noise", "dark", "random" };
+
+    public static bool Run()
+    {
+        Console.WriteLine($"DiffRenderer.RenderCompareToBgr  Vector<byte>.Count={Vector<byte>.Count}" +
+                          $" accelerated={Vector.IsHardwareAccelerated} cores={Environment.ProcessorCount}");
+        bool ok = true;
+        foreach (var (size, w, h) in Sizes)
+        {
+            foreach (var pattern in Patterns)
+            {
+                MakeFrames(pattern, w, h, out var a, out var b);
+                foreach (byte deadband in new byte[] { 0, 3, 40 })
+                {
+                    foreach (bool zzw in new[] { false, true })
+                        ok &= Check(size, pattern, a, b, w, h, deadband, zzw);
+                }
+
+                var dst = new byte[w * h * 3];
+                double tRef = Program.TimeUs(() => DiffRenderer.RenderCompareToBgrScalar(dst, a, b, w, h, 3, true,
+                    out _, out _, out _, out _, out _, out _, out _));
+                double tVec = Program.TimeUs(() => DiffRenderer.RenderCompareToBgr(dst, a, b, w, h, 3, true,
+                    out _, out _, out _, out _, out _, out _, out _));
+                double mpix = w * h / tVec;
+                Console.WriteLine($"  {size,-7} {pattern,-7} scalar {tRef,9:F1} us  vector {tVec,9:F1} us" +
+                                  $"  {mpix,8:F1} Mpx/s  x{tRef / tVec,5:F1}");
+            }
+        }
+        if (!ok)
+            Console.WriteLine("  MISMATCH against the scalar reference");
+        return ok;
+    }
+
+    private static bool Check(string size, string pattern, byte[] a, byte[] b, int w, int h, byte deadband, bool zzw)
+    {
+        var dRef = new byte[w * h * 3];
+        var dVec = new byte[w * h * 3];
+        DiffRenderer.RenderCompareToBgrScalar(dRef, a, b, w, h, deadband, zzw,
+            out int min0, out int max0, out double mean0, out int maxAbs0, out double meanAbs0, out int above0, out int dark0);
+        DiffRenderer.RenderCompareToBgr(dVec, a, b, w, h, deadband, zzw,
+            out int min1, out int max1, out double mean1, out int maxAbs1, out double meanAbs1, out int above1, out int dark1);
+
+        bool same = dRef.AsSpan().SequenceEqual(dVec) &&
+                    min0 == min1 && max0 == max1 && mean0 == mean1 && maxAbs0 == maxAbs1 &&
+                    meanAbs0 == meanAbs1 && above0 == above1 && dark0 == dark1;
+        if (!same)
+        {
+            Console.WriteLine($"  {size} {pattern} deadband={deadband} zzw={zzw}: " +
+                              $"ref {min0}/{max0}/{mean0}/{maxAbs0}/{meanAbs0}/{above0}/{dark0} " +
+                              $"vec {min1}/{max1}/{mean1}/{maxAbs1}/{meanAbs1}/{above1}/{dark1} " +
+                              $"pixels {(dRef.AsSpan().SequenceEqual(dVec) ? "equal" : "differ")}");
+        }
+        return same;
+    }
+
+    private static void MakeFrames(string pattern, int w, int h, out byte[] a, out byte[] b)
+    {
+        var rng = new Random(w * 31 + h);
+        a = new byte[w * h];
+        b = new byte[w * h];
+        for (int y = 0; y < h; y++)
+        {
+            for (int x = 0; x < w; x++)
+            {
+                // Gradient with solid black and white patches, as on a test scene
+                int v = (x * 255 / Math.Max(1, w - 1) + y) & 0xFF;
+                if ((x / 16 + y / 8) % 7 == 0) v = 0;
+                if ((x / 16 + y / 8) % 11 == 0) v = 255;
+                a[y * w + x] = (byte)v;
+            }
+        }
+        for (int i = 0; i < a.Length; i++)
+        {
+            b[i] = pattern switch
+            {
+                "equal" => a[i],
+                "noise" => (byte)Math.Clamp(a[i] + rng.Next(-6, 7), 0, 255),
+                "dark" => rng.Next(20) == 0 ? (byte)0 : a[i],
+                _ => (byte)rng.Next(256),
+            };
+        }
+    }
+}
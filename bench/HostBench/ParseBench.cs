@@ -0,0 +1,141 @@
+using System;
+using System.Buffers.Binary;
+
+namespace VilsSharpX.Bench;
+
+/// <summary>
+/// Host parsers: <see cref="LvdsFrameReassembler"/> on an Osram UART line
+/// stream with idle gaps, and <see cref="LvdsCookedFrameReceiver"/> on
+/// extended keyframe packets with filler between them.  Each is fed in
+/// 1-byte and 64 KiB pushes, which must give the same frames, and timed
+/// against a plain copy of the same bytes.
+/// </summary>
+internal static class ParseBench
+{
+    private const int Frames = 200;
+
+    public static bool Run()
+    {
+        Console.WriteLine("LvdsFrameReassembler / LvdsCookedFrameReceiver Push");
+        bool ok = true;
+
+        byte[] lines = MakeLineStream(out int lineFrames);
+        ok &= Compare("reassembler", lines, lineFrames, chunk => RunReassembler(lines, chunk));
+        byte[] cooked = MakeCookedStream();
+        ok &= Compare("cooked", cooked, Frames, chunk => RunCooked(cooked, chunk));
+
+        if (!ok)
+            Console.WriteLine("  MISMATCH between push sizes or against the generated frames");
+        return ok;
+    }
+
+    private static bool Compare(string name, byte[] stream, int expectFrames, Func<int, (int Frames, long Hash)> run)
+    {
+        var one = run(1);
+        var big = run(64 * 1024);
+        bool ok = one == big && big.Frames == expectFrames;
+        if (!ok)
+            Console.WriteLine($"  {name}: 1-byte pushes {one.Frames} frames #{one.Hash:X}, 64K pushes {big.Frames} frames #{big.Hash:X}," +
+                              $" expected {expectFrames}");
+
+        var copy = new byte[64 * 1024];
+        double tCopy = Program.TimeUs(() =>
+        {
+            for (int i = 0; i < stream.Length; i += copy.Length)
+                stream.AsSpan(i, Math.Min(copy.Length, stream.Length - i)).CopyTo(copy);
+        });
+        foreach (int chunk in new[] { 512, 16 * 1024 })
+        {
+            double t = Program.TimeUs(() => run(chunk));
+            Console.WriteLine($"  {name,-11} {chunk,6} B pushes  {stream.Length / t,8:F0} MB/s" +
+                              $"  {big.Frames * 1e6 / t,9:F0} frames/s  (copy {stream.Length / tCopy:F0} MB/s)");
+        }
+        return ok;
+    }
+
+    private static (int, long) RunReassembler(byte[] stream, int chunk)
+    {
+        var r = new LvdsFrameReassembler(LvdsProtocol.OsramW, LvdsProtocol.OsramH_Lvds, LvdsProtocol.OsramH_Active, 4, false);
+        int frames = 0;
+        long hash = 0;
+        r.OnFrameReady += (f, m) =>
+        {
+            frames++;
+            hash = hash * 31 + f[m.FrameId % (uint)f.Length] + m.LinesReceived;
+        };
+        for (int i = 0; i < stream.Length; i += chunk)
+            r.Push(stream, i, Math.Min(chunk, stream.Length - i));
+        return (frames, hash * 31 + r.CrcErrorCount);
+    }
+
+    private static (int, long) RunCooked(byte[] stream, int chunk)
+    {
+        var rx = new LvdsCookedFrameReceiver();
+        int frames = 0;
+        long hash = 0;
+        rx.OnFrameLeased += l =>
+        {
+            frames++;
+            hash = hash * 31 + l.Span[(int)(l.Meta.FirmwareFrameId % (uint)l.Length)];
+        };
+        for (int i = 0; i < stream.Length; i += chunk)
+            rx.Push(stream, i, Math.Min(chunk, stream.Length - i));
+        return (frames, hash * 31 + rx.SyncLossCount);
+    }
+
+    /// <summary>
+    /// Osram lines [0x5D][row][320 px][CRC32 LE] with 0-20 idle bytes between
+    /// them; pixels avoid 0x5D so every line is found and each frame is
+    /// emitted complete at its last row.
+    /// </summary>
+    private static byte[] MakeLineStream(out int frames)
+    {
+        var rng = new Random(7);
+        int w = LvdsProtocol.OsramW, h = LvdsProtocol.OsramH_Lvds;
+        var s = new System.IO.MemoryStream();
+        var px = new byte[w];
+        var crc = new byte[4];
+        for (int f = 0; f < Frames; f++)
+        {
+            for (int row = 0; row < h; row++)
+            {
+                for (int x = 0; x < w; x++)
+                    px[x] = (byte)((x + row + f) == LvdsProtocol.SyncByte ? 0 : (x + row + f) & 0xFF);
+                s.WriteByte(LvdsProtocol.SyncByte);
+                s.WriteByte((byte)row);
+                s.Write(px);
+                BinaryPrimitives.WriteUInt32LittleEndian(crc, LvdsCrc.ComputeCrc32(px));
+                s.Write(crc);
+                for (int g = rng.Next(21); g > 0; g--)
+                    s.WriteByte(0);
+            }
+        }
+        frames = Frames;
+        return s.ToArray();
+    }
+
+    /// <summary>Version 1 extended KEY packets, 320×80, with 0-64 filler bytes between them.</summary>
+    private static byte[] MakeCookedStream()
+    {
+        var rng = new Random(8);
+        int w = LvdsProtocol.OsramW, h = LvdsProtocol.OsramH_Active;
+        var s = new System.IO.MemoryStream();
+        var hdr = new byte[16];
+        var px = new byte[w * h];
+        for (int f = 0; f < Frames; f++)
+        {
+            rng.NextBytes(px);
+            hdr[0] = 0xFE; hdr[1] = 0xEE; hdr[2] = 1; hdr[3] = 16;
+            hdr[4] = 0x02; hdr[5] = 0;
+            BinaryPrimitives.WriteUInt16LittleEndian(hdr.AsSpan(6), (ushort)f);
+            BinaryPrimitives.WriteUInt16LittleEndian(hdr.AsSpan(8), (ushort)w);
+            BinaryPrimitives.WriteUInt16LittleEndian(hdr.AsSpan(10), (ushort)h);
+            BinaryPrimitives.WriteUInt32LittleEndian(hdr.AsSpan(12), (uint)px.Length);
+            s.Write(hdr);
+            s.Write(px);
+            for (int g = rng.Next(65); g > 0; g--)
+                s.WriteByte((byte)rng.Next(0xFE));
+        }
+        return s.ToArray();
+    }
+}
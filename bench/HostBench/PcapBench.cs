@@ -0,0 +1,163 @@
+using System;
+using System.Buffers.Binary;
+using System.Diagnostics;
+using System.IO;
+using System.Threading;
+
+namespace VilsSharpX.Bench;
+
+/// <summary>
+/// <see cref="PcapAvtpRvfReplay.Load"/> / <see cref="PcapReplayTransmitter"/>:
+/// writes the same synthetic AVTP RVF capture as PCAP and as PCAPNG
+/// (nanosecond timestamps), loads both into memory and compares them
+/// packet by packet, decodes every frame from the cache, then replays it
+/// through the packet-by-packet pacer into a no-op sink at several speeds
+/// and in a loop.  Paced runs must take the capture's time (scaled) and
+/// send every packet; jitter is reported, it depends on the machine.
+/// </summary>
+internal static class PcapBench
+{
+    private const int FramesInCapture = 600;
+    private const int PacketsPerFrame = RvfReassembler.H / 4;   // 4 lines per packet
+    private const int PacketLen = 14 + 4 + 1312;
+    private const long IntervalUs = 40;                          // 25 kpps
+
+    public static bool Run()
+    {
+        Console.WriteLine("PcapAvtpRvfReplay.Load / PcapReplayTransmitter");
+        string pcap = Path.Combine(Path.GetTempPath(), $"hostbench_{Environment.ProcessId}.pcap");
+        string pcapng = Path.ChangeExtension(pcap, ".pcapng");
+        bool ok = true;
+        try
+        {
+            int n = FramesInCapture * PacketsPerFrame;
+            var packets = new byte[n][];
+            for (int i = 0; i < n; i++)
+                packets[i] = Packet(i);
+            WritePcap(pcap, packets);
+            WritePcapNg(pcapng, packets);
+
+            var sw = Stopwatch.StartNew();
+            var cache = PcapAvtpRvfReplay.Load(pcap);
+            double loadMs = sw.Elapsed.TotalMilliseconds;
+            var cacheNg = PcapAvtpRvfReplay.Load(pcapng);
+            bool same = cache.Count == n && cacheNg.Count == n && cache.TotalBytes == (long)n * PacketLen &&
+                        cache.DurationUs == (n - 1) * IntervalUs && cache.IsCurrent(pcap);
+            for (int i = 0; same && i < n; i++)
+            {
+                same = cache.TimestampsUs[i] == i * IntervalUs && cacheNg.TimestampsUs[i] == i * IntervalUs &&
+                       cache.Packets[i].AsSpan().SequenceEqual(packets[i]) &&
+                       cacheNg.Packets[i].AsSpan().SequenceEqual(packets[i]);
+            }
+            Console.WriteLine($"  load     {n} packets, {cache.TotalBytes / (1024.0 * 1024.0):F1} MiB in {loadMs:F0} ms" +
+                              $" ({cache.TotalBytes / 1000.0 / loadMs:F0} MB/s), PCAP = PCAPNG: {(same ? "ok" : "FAIL")}");
+            ok &= same;
+
+            int chunks = 0, frames = 0;
+            PcapAvtpRvfReplay.ReplayAsync(cache, c => { chunks++; if (c.EndFrame) frames++; }, null,
+                CancellationToken.None, PcapReplayTransmitter.Unpaced).GetAwaiter().GetResult();
+            bool decoded = chunks == n && frames == FramesInCapture;
+            Console.WriteLine($"  decode   {chunks} chunks, {frames} frames: {(decoded ? "ok" : "FAIL")}");
+            ok &= decoded;
+
+            ok &= Replay(cache, 1.0, 1);
+            ok &= Replay(cache, 2.0, 1);
+            ok &= Replay(cache, 4.0, 3);
+            ok &= Replay(cache, PcapReplayTransmitter.Unpaced, 3);
+        }
+        finally
+        {
+            try { File.Delete(pcap); } catch { }
+            try { File.Delete(pcapng); } catch { }
+        }
+        return ok;
+    }
+
+    private static bool Replay(PcapPacketCache cache, double speed, int passes)
+    {
+        long sent = 0;
+        var stats = PcapReplayTransmitter.RunPaced(cache, speed, passes, _ => sent++, CancellationToken.None);
+        bool ok = sent == (long)cache.Count * passes && stats.Packets == sent && stats.Passes == passes;
+        string rate = double.IsPositiveInfinity(speed) ? "unpaced" : $"{speed:0.#}x";
+        if (!double.IsPositiveInfinity(speed))
+        {
+            double expectMs = ((passes - 1) * (cache.DurationUs + cache.MeanIntervalUs) + cache.DurationUs) / speed / 1000.0;
+            ok &= Math.Abs(stats.Elapsed.TotalMilliseconds - expectMs) < expectMs * 0.05 + 2;
+            rate += $" ({expectMs:F0} ms scheduled)";
+        }
+        Console.WriteLine($"  {rate,-26} {stats}: {(ok ? "ok" : "FAIL")}");
+        return ok;
+    }
+
+    /// <summary>Packet <paramref name="i"/> of the capture: VLAN-tagged AVTP RVF, 4 lines of 320 pixels.</summary>
+    private static byte[] Packet(int i)
+    {
+        var p = new byte[PacketLen];
+        AvtpPacketBuilder.DestMac.CopyTo(p, 0);
+        AvtpPacketBuilder.SrcMac.CopyTo(p, 6);
+        BinaryPrimitives.WriteUInt16BigEndian(p.AsSpan(12), AvtpPacketBuilder.EthTypeVlan);
+        BinaryPrimitives.WriteUInt16BigEndian(p.AsSpan(14), (5 << 13) | 70);
+        BinaryPrimitives.WriteUInt16BigEndian(p.AsSpan(16), AvtpPacketBuilder.EthTypeAvtp);
+        var avtp = p.AsSpan(18);
+        int k = i % PacketsPerFrame;
+        avtp[0] = 0x07;
+        avtp[2] = (byte)i;
+        avtp[22] = k == PacketsPerFrame - 1 ? (byte)0x90 : (byte)0x80;
+        avtp[31] = (byte)(1 + 4 * k);
+        for (int j = 32; j < avtp.Length; j++)
+            avtp[j] = (byte)(i * 7 + j);
+        return p;
+    }
+
+    private static void WritePcap(string path, byte[][] packets)
+    {
+        using var fs = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.None, 1 << 20);
+        Span<byte> hdr = stackalloc byte[24];
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr, 0xA1B2C3D4u);
+        BinaryPrimitives.WriteUInt16LittleEndian(hdr.Slice(4), 2);
+        BinaryPrimitives.WriteUInt16LittleEndian(hdr.Slice(6), 4);
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr.Slice(16), 65535);
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr.Slice(20), 1);
+        fs.Write(hdr);
+        Span<byte> rec = stackalloc byte[16];
+        for (int i = 0; i < packets.Length; i++)
+        {
+            long t = 1_700_000_000L * 1_000_000 + i * IntervalUs;
+            BinaryPrimitives.WriteUInt32LittleEndian(rec, (uint)(t / 1_000_000));
+            BinaryPrimitives.WriteUInt32LittleEndian(rec.Slice(4), (uint)(t % 1_000_000));
+            BinaryPrimitives.WriteUInt32LittleEndian(rec.Slice(8), (uint)packets[i].Length);
+            BinaryPrimitives.WriteUInt32LittleEndian(rec.Slice(12), (uint)packets[i].Length);
+            fs.Write(rec);
+            fs.Write(packets[i]);
+        }
+    }
+
+    private static void WritePcapNg(string path, byte[][] packets)
+    {
+        using var fs = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.None, 1 << 20);
+        var w = new BinaryWriter(fs);
+
+        // SHB
+        w.Write(0x0A0D0D0Au); w.Write(28u); w.Write(0x1A2B3C4Du);
+        w.Write((ushort)1); w.Write((ushort)0); w.Write(-1L); w.Write(28u);
+
+        // IDB, Ethernet, if_tsresol = 9 (ns)
+        w.Write(1u); w.Write(32u); w.Write((ushort)1); w.Write((ushort)0); w.Write(0u);
+        w.Write((ushort)9); w.Write((ushort)1); w.Write(9u); w.Write(0u); w.Write(32u);
+
+        for (int i = 0; i < packets.Length; i++)
+        {
+            var p = packets[i];
+            int padded = (p.Length + 3) & ~3;
+            uint total = (uint)(32 + padded);
+            ulong t = (1_700_000_000UL * 1_000_000 + (ulong)(i * IntervalUs)) * 1000;
+            w.Write(6u); w.Write(total); w.Write(0u);
+            w.Write((uint)(t >> 32)); w.Write((uint)t);
+            w.Write((uint)p.Length); w.Write((uint)p.Length);
+            w.Write(p);
+            for (int j = p.Length; j < padded; j++) w.Write((byte)0);
+            w.Write(total);
+        }
+        w.Flush();
+    }
+}
@@ -0,0 +1,65 @@
+using System;
+using System.Diagnostics;
+
+namespace VilsSharpX.Bench;
+
+/// <summary>
+/// Host benchmarks: each one checks the optimized path against its reference
+/// implementation on the same input before timing both.
+///
+///   dotnet run -c Release --project bench/HostBench            run all
+///   dotnet run -c Release --project bench/HostBench -- diff     one benchmark
+///
+/// Exit status is 1 if any optimized result differs from its reference.
+/// </summary>
+public static class Program
+{
+    private static readonly (string Name, Func<bool> Run)[] Benches =
+    {
+        ("diff", DiffRendererBench.Run),
+        ("crc", CrcBench.Run),
+        ("parse", ParseBench.Run),
+        ("capture", CaptureBench.Run),
+        ("trace", TraceBench.Run),
+        ("render", RenderBench.Run),
+        ("pcap", PcapBench.Run),
+    };
+
+    public static int Main(string[] args)
+    {
+        bool ok = true;
+        int ran = 0;
+        foreach (var (name, run) in Benches)
+        {
+            if (args.Length > 0 && Array.IndexOf(args, name) < 0)
+                continue;
+            ok &= run();
+            ran++;
+        }
+        if (ran == 0)
+        {
+            Console.Error.WriteLine($"usage: HostBench [{string.Join('|', Array.ConvertAll(Benches, b => b.Name))}]...");
+            return 2;
+        }
+        return ok ? 0 : 1;
+    }
+
+    /// <summary>
+    /// Runs <paramref name="body"/> for about <paramref name="minMs"/> ms after a
+    /// warm-up and returns the mean time per call in microseconds.
+    /// </summary>
+    public static double TimeUs(Action body, int minMs = 300)
+    {
+        for (int i = 0; i < 20; i++)
+            body();
+        var sw = Stopwatch.StartNew();
+        long calls = 0;
+        do
+        {
+            for (int i = 0; i < 10; i++)
+                body();
+            calls += 10;
+        } while (sw.ElapsedMilliseconds < minMs);
+        return sw.Elapsed.TotalMilliseconds * 1000.0 / calls;
+    }
+}
@@ -0,0 +1,151 @@
+using System;
+using System.Diagnostics;
+using System.Threading;
+
+namespace VilsSharpX.Bench;
+
+/// <summary>
+/// <see cref="FrameCompositor"/>: a composed frame must match
+/// <see cref="DiffRenderer.RenderCompareToBgr"/> on the same pair; a
+/// producer submitting far faster than a 60 Hz consumer takes frames must
+/// only ever be seen newest-first, untorn, ending on its last frame;
+/// nothing submitted before <see cref="FrameCompositor.Invalidate"/> may
+/// come out after it; every recorded submit must reach the recorder in
+/// order even when it is never shown; and submitting allocates nothing.
+/// </summary>
+internal static class RenderBench
+{
+    private const int Frames = 500;
+    private const int DisplayPeriodMs = 16;
+
+    public static bool Run()
+    {
+        Console.WriteLine("FrameCompositor");
+        int w = LvdsProtocol.OsramW, h = LvdsProtocol.OsramH_Active;
+        bool ok = true;
+        using var compositor = new FrameCompositor();
+
+        // Same output as the renderer called directly
+        var a = Frame(w, h, 1);
+        var b = Frame(w, h, 2);
+        compositor.Submit(a, b, w, h, 3, false);
+        var c = WaitForFrame(compositor);
+        var expect = new byte[w * h * 3];
+        DiffRenderer.RenderCompareToBgr(expect, a, b, w, h, 3, false,
+            out int minDiff, out int maxDiff, out _, out _, out double meanAbsDiff, out int above, out int dark);
+        bool same = c != null && c.DiffBgr.AsSpan().SequenceEqual(expect) && c.A.AsSpan().SequenceEqual(a) &&
+                    c.B.AsSpan().SequenceEqual(b) && c.MinDiff == minDiff && c.MaxDiff == maxDiff &&
+                    c.MeanAbsDiff == meanAbsDiff && c.AboveDeadband == above && c.TotalDarkPixels == dark;
+        Console.WriteLine($"  compose  matches DiffRenderer: {(same ? "ok" : "FAIL")}");
+        ok &= same;
+
+        // Producer far ahead of the display: newest frame wins, nothing queues up
+        var pairs = new byte[16][];
+        for (int i = 0; i < pairs.Length; i++)
+            pairs[i] = Frame(w, h, i + 10);
+        long baseSeq = compositor.Submitted, baseComposed = compositor.Composed, basePresented = compositor.Presented;
+        var producer = new Thread(() =>
+        {
+            for (int f = 1; f <= Frames; f++)
+            {
+                compositor.Submit(pairs[f % pairs.Length], pairs[(f + 1) % pairs.Length], w, h, 3, false);
+                Thread.Sleep(1);   // ~1 kHz source
+            }
+        });
+        var sw = Stopwatch.StartNew();
+        producer.Start();
+        long last = 0, shown = 0;
+        bool ordered = true, untorn = true;
+        while (true)
+        {
+            bool done = !producer.IsAlive;
+            var o = compositor.TryAcquire();
+            if (o != null)
+            {
+                long seq = o.Sequence - baseSeq;
+                ordered &= seq > last;
+                untorn &= o.A.AsSpan().SequenceEqual(pairs[seq % pairs.Length]) &&
+                          o.B.AsSpan().SequenceEqual(pairs[(seq + 1) % pairs.Length]);
+                last = seq;
+                shown++;
+            }
+            if (done && last == Frames) break;
+            if (sw.ElapsedMilliseconds > 10_000) { ordered = false; break; }
+            Thread.Sleep(DisplayPeriodMs);
+        }
+        double ms = sw.Elapsed.TotalMilliseconds;
+        long composed = compositor.Composed - baseComposed;
+        bool latest = ordered && untorn && last == Frames && compositor.Presented - basePresented == shown;
+        Console.WriteLine($"  latest   {Frames} submitted in {ms:F0} ms, {composed} composed, {shown} shown" +
+                          $" ({composed * 1000.0 / ms:F0} compositions/s): {(latest ? "ok" : "FAIL")}");
+        ok &= latest;
+
+        // Invalidate drops what was submitted before it
+        compositor.Submit(a, b, w, h, 3, false);
+        compositor.Invalidate();
+        Thread.Sleep(50);
+        bool dropped = compositor.TryAcquire() == null;
+        compositor.Submit(b, a, w, h, 3, false);
+        var after = WaitForFrame(compositor);
+        dropped &= after != null && after.A.AsSpan().SequenceEqual(b);
+        Console.WriteLine($"  invalidate: {(dropped ? "ok" : "FAIL")}");
+        ok &= dropped;
+
+        // Recording: a burst far faster than the display, every frame recorded in order
+        long recorded = 0;
+        bool recordOk = true;
+        compositor.Recorder = (ra, rb, rd) =>
+        {
+            long i = Interlocked.Read(ref recorded);
+            recordOk &= ra == pairs[i % pairs.Length] && rb == pairs[(i + 1) % pairs.Length] &&
+                        rd.Length == w * h * 3;
+            Interlocked.Increment(ref recorded);
+        };
+        long recBase = compositor.Recorded;
+        int burst = 0;
+        for (int f = 0; f < Frames; f++)
+        {
+            while (compositor.Recorded - recBase < burst - FrameCompositor.MaxPendingRecords / 2)
+                Thread.Yield();   // a real source is paced; do not overrun the FIFO here
+            compositor.Submit(pairs[f % pairs.Length], pairs[(f + 1) % pairs.Length], w, h, 3, false, record: true);
+            burst++;
+        }
+        var rsw = Stopwatch.StartNew();
+        while (Interlocked.Read(ref recorded) < Frames && rsw.ElapsedMilliseconds < 5000)
+            Thread.Sleep(1);
+        recordOk &= Interlocked.Read(ref recorded) == Frames && compositor.RecordsDropped == 0;
+        compositor.Recorder = null;
+        Console.WriteLine($"  record   {Interlocked.Read(ref recorded)}/{Frames} recorded in order: {(recordOk ? "ok" : "FAIL")}");
+        ok &= recordOk;
+
+        double submitUs = Program.TimeUs(() => compositor.Submit(a, b, w, h, 3, false));
+        long before = GC.GetAllocatedBytesForCurrentThread();
+        for (int i = 0; i < 1000; i++)
+            compositor.Submit(a, b, w, h, 3, false);
+        long allocated = GC.GetAllocatedBytesForCurrentThread() - before;
+        bool noAlloc = allocated == 0;
+        Console.WriteLine($"  submit   {submitUs * 1000:F0} ns, {allocated} B allocated per 1000: {(noAlloc ? "ok" : "FAIL")}");
+        ok &= noAlloc;
+        return ok;
+    }
+
+    private static FrameCompositor.Output? WaitForFrame(FrameCompositor compositor)
+    {
+        var sw = Stopwatch.StartNew();
+        while (sw.ElapsedMilliseconds < 2000)
+        {
+            var o = compositor.TryAcquire();
+            if (o != null) return o;
+            Thread.Sleep(1);
+        }
+        return null;
+    }
+
+    private static byte[] Frame(int w, int h, int seed)
+    {
+        var f = new byte[w * h];
+        for (int i = 0; i < f.Length; i++)
+            f[i] = (byte)(i * seed + (i >> 5) * 3 + seed * 17);
+        return f;
+    }
+}
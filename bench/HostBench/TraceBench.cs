@@ -0,0 +1,99 @@
+using System;
+using System.IO;
+using System.Text.Json;
+using System.Threading;
+
+namespace VilsSharpX.Bench;
+
+/// <summary>
+/// <see cref="TraceLog"/>: cost of a trace point with tracing off and on,
+/// then a session with several threads tracing at once, exported to
+/// Chrome JSON.  Every event written (and not counted as dropped) must
+/// come out of the export, with begin / end pairs balanced per thread.
+/// </summary>
+internal static class TraceBench
+{
+    private const int Threads = 4;
+    private const int SpansPerThread = 20_000;
+
+    public static bool Run()
+    {
+        Console.WriteLine("TraceLog");
+        string path = Path.Combine(Path.GetTempPath(), $"hostbench_{Environment.ProcessId}{TraceLog.FileExtension}");
+        string json = Path.ChangeExtension(path, ".json");
+        bool ok = true;
+        try
+        {
+            const int batch = 1000;
+            double offUs = Program.TimeUs(() =>
+            {
+                for (int i = 0; i < batch; i++)
+                    TraceLog.Instant(TraceEvent.UsbRead, i);
+            });
+
+            TraceLog.Start(path);
+            double onUs = Program.TimeUs(() =>
+            {
+                for (int i = 0; i < batch; i++)
+                    TraceLog.Instant(TraceEvent.UsbRead, i);
+                Thread.Sleep(0);   // let the drain thread keep up with the ring
+            });
+            TraceLog.Stop();
+            long sink = 0;
+            double clockUs = Program.TimeUs(() =>
+            {
+                for (int i = 0; i < batch; i++)
+                    sink += System.Diagnostics.Stopwatch.GetTimestamp();
+            });
+            Console.WriteLine($"  trace point  off {offUs * 1000 / batch,5:F1} ns   on {onUs * 1000 / batch,5:F1} ns" +
+                              $"   (Stopwatch.GetTimestamp {clockUs * 1000 / batch:F1} ns{(sink == 0 ? "" : "")})");
+
+            TraceLog.Start(path);
+            var workers = new Thread[Threads];
+            for (int t = 0; t < Threads; t++)
+            {
+                workers[t] = new Thread(() =>
+                {
+                    for (int i = 0; i < SpansPerThread; i++)
+                    {
+                        using (TraceLog.Scope(TraceEvent.ReceiverPush, i))
+                            TraceLog.Instant(TraceEvent.ReceiverFrame, i, 0);
+                        if ((i & 255) == 0) Thread.Sleep(1);
+                    }
+                }) { Name = $"bench {t}" };
+                workers[t].Start();
+            }
+            foreach (var w in workers) w.Join();
+            long dropped = TraceLog.DroppedEvents;
+            TraceLog.Stop();
+
+            int exported = TraceLog.ExportChromeJson(path, json);
+            using var doc = JsonDocument.Parse(File.ReadAllBytes(json));
+            int begins = 0, ends = 0, instants = 0, threadNames = 0;
+            foreach (var e in doc.RootElement.GetProperty("traceEvents").EnumerateArray())
+            {
+                switch (e.GetProperty("ph").GetString())
+                {
+                    case "B": begins++; break;
+                    case "E": ends++; break;
+                    case "i": instants++; break;
+                    case "M": threadNames++; break;
+                }
+            }
+            long written = 3L * Threads * SpansPerThread;
+            ok = exported + dropped == written && threadNames >= Threads && instants == exported - begins - ends &&
+                 (dropped > 0 || begins == ends);
+            if (dropped > 0)
+                Console.WriteLine("  (events dropped: rings filled faster than they were drained)");
+            Console.WriteLine($"  {Threads} threads      {exported} events exported, {dropped} dropped, " +
+                              $"{new FileInfo(path).Length / 1024} KiB trace / {new FileInfo(json).Length / 1024} KiB JSON: {(ok ? "ok" : "FAIL")}");
+        }
+        finally
+        {
+            TraceLog.Stop();
+            try { File.Delete(path); } catch { }
+            try { File.Delete(json); } catch { }
+        }
+        return ok;
+    }
+}
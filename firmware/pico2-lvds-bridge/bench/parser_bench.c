@@ -0,0 +1,388 @@
+/*
+ * parser_bench.c - Throughput benchmark for the LVDS parser core
+ *
+ * Feeds LVDS UART byte streams through lvds_parser.c the way the capture
+ * DMA would (CHUNK bytes at a time into the ring) and reports parse
+ * rate, frame rate and cycles per byte.
+ *
+ * Streams are either generated (Nichia / Osram frames with inter-line
+ * gaps, false 0x5D bytes in the gaps and single-bit errors in the
+ * pixels) or replayed from a raw capture file.  Generated frames carry
+ * their frame number in pixel 0 of every row, so each placed row is
+ * checked against the pattern it was generated from; CRC reject is on,
+ * so a mismatching row means a corrupted line got through.
+ *
+ * Host:    see bench/CMakeLists.txt.  Cycles are TSC ticks on x86,
+ *          not reported elsewhere.
+ *   parser_bench                       run the built-in suite
+ *   parser_bench -p osram -e 20 -s 5   one case: protocol, bit errors per
+ *                                      1000 lines, false syncs per 1000
+ *                                      gaps (-F frames, -n repetitions)
+ *   parser_bench -w nichia.bin         also write the generated stream
+ *   parser_bench -f capture.bin -p osram   replay a raw capture
+ *   Exit status is 1 if any generated row was placed with wrong pixels.
+ *
+ * Target:  -DLVDS_BUILD_BENCH=ON builds pico2_lvds_parser_bench.uf2,
+ *          which runs the built-in suite every 5 s and prints the
+ *          results over USB stdio.  Cycles come from the Cortex-M33
+ *          DWT cycle counter.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvds_parser.h"
+
+#if PICO_ON_DEVICE
+#include "pico/stdlib.h"
+#else
+#include <time.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define HAVE_CYCLES 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLES 1
+#endif
+#endif
+
+#if PICO_ON_DEVICE
+#define STREAM_MAX   (128u * 1024)
+#else
+#define STREAM_MAX   (16u * 1024 * 1024)
+#endif
+
+#define CHUNK        1024    /* bytes written to the ring per feed */
+#define MAX_GAP      20      /* idle bytes between lines */
+
+/* ----------------------------------------------------------------- */
+/*  Clocks                                                            */
+/* ----------------------------------------------------------------- */
+
+#if PICO_ON_DEVICE
+#define HAVE_CYCLES 1
+#define DWT_CTRL     (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT   (*(volatile uint32_t *)0xE0001004)
+#define DEMCR        (*(volatile uint32_t *)0xE000EDFC)
+
+static uint64_t now_ns(void) { return time_us_64() * 1000u; }
+
+static void cycles_init(void)
+{
+    DEMCR |= 1u << 24;      /* TRCENA */
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= 1u;         /* CYCCNTENA */
+}
+
+/* 32-bit counter, wraps after ~28 s at 150 MHz: callers only take
+ * differences over one stream pass */
+static uint32_t cycles_now(void) { return DWT_CYCCNT; }
+#else
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void cycles_init(void) { }
+
+#if HAVE_CYCLES
+static uint64_t cycles_now(void) { return __rdtsc(); }
+#else
+static uint64_t cycles_now(void) { return 0; }
+#endif
+#endif
+
+/* ----------------------------------------------------------------- */
+/*  Stream generator                                                  */
+/* ----------------------------------------------------------------- */
+
+static uint8_t  stream[STREAM_MAX];
+static uint32_t stream_len;
+static uint32_t rng_state = 0x12345678u;
+
+static uint32_t rnd(void)
+{
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return rng_state = x;
+}
+
+static inline uint8_t pattern(uint32_t frame, int row, int col)
+{
+    return col == 0 ? (uint8_t)frame : (uint8_t)(frame * 7 + row * 3 + col);
+}
+
+/* Row byte as transmitted (Nichia: odd parity in bit 7) */
+static uint8_t row_byte(const lvds_proto_t *pr, int row)
+{
+    if (pr->row_mask == 0xFF) return (uint8_t)row;
+    int ones = 0;
+    for (int b = 0; b < 7; b++) ones += (row >> b) & 1;
+    return (uint8_t)(row | ((ones & 1) ? 0 : 0x80));
+}
+
+static void put_byte(uint8_t b)
+{
+    if (stream_len < STREAM_MAX) stream[stream_len++] = b;
+}
+
+/* `errors` = lines per 1000 with one flipped pixel bit, `strays` = gaps
+ * per 1000 with a false sync byte.  Returns the number of frames that
+ * fit into the stream buffer. */
+static uint32_t gen_stream(const lvds_proto_t *pr, uint32_t frames, int errors, int strays)
+{
+    uint32_t per_frame = pr->lvds_height * (pr->line_size + MAX_GAP);
+    if (frames > STREAM_MAX / per_frame - 1)
+        frames = STREAM_MAX / per_frame - 1;
+
+    uint8_t line[MAX_LINE_BYTES];
+    stream_len = 0;
+    for (int i = 0; i < 200; i++)            /* garbage before the first sync */
+        put_byte((uint8_t)(rnd() % 5 == 0 ? SYNC_BYTE : rnd()));
+
+    /* One extra frame start at the end so the last frame is emitted */
+    for (uint32_t f = 0; f <= frames; f++) {
+        int rows = (f == frames) ? 1 : pr->lvds_height;
+        for (int r = 0; r < rows; r++) {
+            line[0] = SYNC_BYTE;
+            line[1] = row_byte(pr, r);
+            uint8_t *pix = line + 2;
+            for (int c = 0; c < pr->width; c++)
+                pix[c] = pattern(f, r, c);
+
+            uint8_t *crc = pix + pr->width;
+            if (pr->crc_type == LVDS_CRC16) {
+                uint16_t v = lvds_crc16_ccitt(pix, pr->width);
+                crc[0] = (uint8_t)(v >> 8);
+                crc[1] = (uint8_t)v;
+            } else {
+                uint32_t v = lvds_crc32_iso_hdlc(pix, pr->width);
+                for (int i = 0; i < 4; i++) crc[i] = (uint8_t)(v >> (8 * i));
+            }
+            if ((int)(rnd() % 1000) < errors)
+                pix[rnd() % pr->width] ^= (uint8_t)(1u << (rnd() % 8));
+
+            for (int i = 0; i < pr->line_size; i++) put_byte(line[i]);
+
+            /* Idle gap, now and then with a stray sync byte in it */
+            int gap = (int)(rnd() % (MAX_GAP + 1));
+            int stray = ((int)(rnd() % 1000) < strays && gap > 0) ? (int)(rnd() % gap) : -1;
+            for (int i = 0; i < gap; i++)
+                put_byte(i == stray ? SYNC_BYTE : 0x00);
+        }
+    }
+    return frames;
+}
+
+/* ----------------------------------------------------------------- */
+/*  Parser harness                                                    */
+/* ----------------------------------------------------------------- */
+
+static uint8_t ring[RING_SIZE];
+static uint8_t frame_buf[MAX_FRAME_BYTES];
+
+typedef struct {
+    uint32_t frames;
+    uint32_t rows;          /* active rows delivered */
+    uint32_t bad_rows;      /* placed with pixels that do not match */
+} bench_result_t;
+
+static bench_result_t result;
+static bool verify;
+
+/* ops->frame_done: check the frame, then reuse the same buffer */
+static uint8_t *bench_frame_done(lvds_parser_t *p)
+{
+    const lvds_proto_t *pr = p->proto;
+    uint8_t missing[MISSING_BM_BYTES];
+
+    result.frames++;
+    result.rows += lvds_parser_finish_frame(p, missing);
+    if (!verify) return p->asm_fb;
+
+    for (int r = 0; r < pr->active_height; r++) {
+        if (missing[r >> 3] & (1u << (r & 7))) continue;
+        const uint8_t *row = p->asm_fb + r * pr->width;
+        for (int c = 1; c < pr->width; c++) {
+            if (row[c] != pattern(row[0], r, c)) {
+                result.bad_rows++;
+                break;
+            }
+        }
+    }
+    return p->asm_fb;
+}
+
+static const lvds_parser_ops_t bench_ops = {
+    .frame_done = bench_frame_done,
+};
+
+typedef struct {
+    const char *name;
+    const lvds_proto_t *proto;
+    int errors;             /* bit errors per 1000 lines */
+    int strays;             /* false syncs per 1000 gaps */
+} bench_case_t;
+
+/* Run the stream through the parser `reps` times.  Returns false if
+ * generated rows came out wrong. */
+static bool run_case(const bench_case_t *bc, int reps)
+{
+    static lvds_parser_t parser;
+    static lvds_parse_stats_t stats;
+    uint64_t ns = 0, cycles = 0;
+
+    memset(&result, 0, sizeof(result));
+    memset(&stats, 0, sizeof(stats));
+    for (int rep = 0; rep < reps; rep++) {
+        lvds_parser_init(&parser, &bench_ops, &stats, ring, bc->proto, frame_buf);
+        parser.crc_reject = true;
+
+        uint32_t wr = 0;
+        uint64_t us = 0;
+        for (uint32_t pos = 0; pos < stream_len; ) {
+            uint32_t n = stream_len - pos < CHUNK ? stream_len - pos : CHUNK;
+            for (uint32_t i = 0; i < n; i++)
+                ring[(wr + i) & RING_MASK] = stream[pos + i];
+            wr = (wr + n) & RING_MASK;
+            pos += n;
+            us += (uint64_t)n * bc->proto->bits_per_byte * 1000000u / bc->proto->baud;
+
+            /* Time the parser only, not the copy into the ring */
+            uint64_t t0 = now_ns();
+#if PICO_ON_DEVICE
+            uint32_t c0 = cycles_now();
+            while (parser.ring_rd != wr)
+                lvds_parser_feed(&parser, wr, us, RING_SIZE / 2);
+            cycles += (uint32_t)(cycles_now() - c0);
+#else
+            uint64_t c0 = cycles_now();
+            while (parser.ring_rd != wr)
+                lvds_parser_feed(&parser, wr, us, RING_SIZE / 2);
+            cycles += cycles_now() - c0;
+#endif
+            ns += now_ns() - t0;
+        }
+    }
+
+    double bytes = (double)stream_len * reps;
+    double sec = ns > 0 ? ns / 1e9 : 1e-9;
+    printf("%-18s %8.2f MB/s %9.0f frames/s", bc->name,
+           bytes / sec / 1e6, result.frames / sec);
+#if HAVE_CYCLES
+    printf(" %6.2f cyc/B", cycles / bytes);
+#else
+    (void)cycles;
+    printf("      - cyc/B");
+#endif
+    printf("  frames=%u rows=%u crc_ok=%u crc_err=%u skip=%u resync=%u bad=%u\n",
+           result.frames / reps, result.rows / reps,
+           stats.crc_ok_lines / reps, stats.crc_errors / reps,
+           stats.row_seq_skip / reps, stats.gap_resyncs / reps,
+           result.bad_rows / reps);
+    return result.bad_rows == 0;
+}
+
+static const bench_case_t suite[] = {
+    { "nichia clean",  &PROTO_NICHIA,  0, 0 },
+    { "nichia noisy",  &PROTO_NICHIA, 20, 5 },
+    { "osram clean",   &PROTO_OSRAM,   0, 0 },
+    { "osram noisy",   &PROTO_OSRAM,  20, 5 },
+};
+
+static bool run_generated(const bench_case_t *bc, uint32_t frames, int reps)
+{
+    rng_state = 0x12345678u;
+    gen_stream(bc->proto, frames, bc->errors, bc->strays);
+    verify = true;
+    return run_case(bc, reps);
+}
+
+static bool run_suite(uint32_t frames, int reps)
+{
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(suite) / sizeof(suite[0]); i++)
+        ok &= run_generated(&suite[i], frames, reps);
+    return ok;
+}
+
+#if PICO_ON_DEVICE
+
+int main(void)
+{
+    stdio_init_all();
+    lvds_crc_init();
+    cycles_init();
+    while (1) {
+        sleep_ms(5000);
+        printf("lvds parser bench, %u byte chunks\n", CHUNK);
+        run_suite(1000, 4);
+    }
+}
+
+#else
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: parser_bench [-p nichia|osram] [-e errors_per_1000_lines]\n"
+        "                    [-s false_syncs_per_1000_gaps] [-F frames] [-n reps]\n"
+        "                    [-w out.bin] [-f capture.bin]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const lvds_proto_t *proto = NULL;
+    const char *in_path = NULL, *out_path = NULL;
+    int errors = 0, strays = 0, reps = 10;
+    uint32_t frames = 500;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage();
+        const char *a = argv[i], *v = argv[++i];
+        if      (!strcmp(a, "-p")) proto = !strcmp(v, "osram") ? &PROTO_OSRAM : &PROTO_NICHIA;
+        else if (!strcmp(a, "-e")) errors = atoi(v);
+        else if (!strcmp(a, "-s")) strays = atoi(v);
+        else if (!strcmp(a, "-F")) frames = (uint32_t)atoi(v);
+        else if (!strcmp(a, "-n")) reps = atoi(v);
+        else if (!strcmp(a, "-w")) out_path = v;
+        else if (!strcmp(a, "-f")) in_path = v;
+        else usage();
+    }
+    if (reps < 1) reps = 1;
+
+    lvds_crc_init();
+    cycles_init();
+    printf("lvds parser bench, %u byte chunks, %d reps\n", CHUNK, reps);
+
+    if (!proto && !in_path)
+        return run_suite(frames, reps) ? 0 : 1;
+    if (!proto) proto = &PROTO_NICHIA;
+
+    if (in_path) {
+        FILE *f = fopen(in_path, "rb");
+        if (!f) { perror(in_path); return 2; }
+        stream_len = (uint32_t)fread(stream, 1, STREAM_MAX, f);
+        fclose(f);
+        bench_case_t bc = { in_path, proto, 0, 0 };
+        verify = false;
+        run_case(&bc, reps);
+        return 0;
+    }
+
+    bench_case_t bc = { proto == &PROTO_OSRAM ? "osram" : "nichia", proto, errors, strays };
+    bool ok = run_generated(&bc, frames, reps);
+    if (out_path) {
+        FILE *f = fopen(out_path, "wb");
+        if (!f || fwrite(stream, 1, stream_len, f) != stream_len) { perror(out_path); return 2; }
+        fclose(f);
+    }
+    return ok ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,460 @@
+/*
+ * lvds_parser.c - LVDS line parser + frame assembler (see lvds_parser.h)
+ *
+ * Plain C99 with no SDK calls, so it builds for the RP2350 firmware and
+ * for the host benchmark in bench/ unchanged.
+ */
+
+#include <string.h>
+#include "lvds_parser.h"
+
+const lvds_proto_t PROTO_NICHIA = { 256, 64, 68, 260, BAUD_NICHIA, LVDS_CRC16, 2, 10, 0x7F,
+                                    SYNC_BYTE, LVDS_PARITY_NONE };
+const lvds_proto_t PROTO_OSRAM  = { 320, 80, 84, 326, BAUD_OSRAM,  LVDS_CRC32, 4, 11, 0xFF,
+                                    SYNC_BYTE, LVDS_PARITY_ODD };
+
+bool lvds_proto_valid(const lvds_proto_t *pr)
+{
+    if (pr->crc_type != LVDS_CRC16 && pr->crc_type != LVDS_CRC32) return false;
+    if (pr->crc_len != (pr->crc_type == LVDS_CRC16 ? 2 : 4)) return false;
+    if (pr->parity > LVDS_PARITY_EVEN) return false;
+    if (pr->bits_per_byte != (pr->parity == LVDS_PARITY_NONE ? 10 : 11)) return false;
+    /* Every row number must fit the row address bits */
+    if (pr->lvds_height == 0 || pr->lvds_height > MAX_LVDS_ROWS ||
+        pr->lvds_height - 1 > pr->row_mask) return false;
+    return pr->width > 0 && pr->width <= MAX_LINE_WIDTH && pr->active_height > 0 && pr->active_height <= pr->lvds_height
+        && (uint32_t)pr->width * pr->active_height <= MAX_FRAME_BYTES
+        && pr->line_size == 2 + pr->width + pr->crc_len && pr->line_size <= MAX_LINE_BYTES
+        && pr->baud > 0;
+}
+
+/* ----------------------------------------------------------------- */
+/*  CRC-16/CCITT-FALSE  (poly 0x1021, init 0xFFFF, no reflection)    */
+/* ----------------------------------------------------------------- */
+
+static uint16_t crc16_table[256];
+
+/* ----------------------------------------------------------------- */
+/*  CRC-32/ISO-HDLC  (poly 0x04C11DB7 reflected, init/xorout ~0)     */
+/*  Software reference for the byte path; the firmware fast path     */
+/*  uses the DMA sniffer.  Matches LvdsCrc.ComputeCrc32 on the host. */
+/* ----------------------------------------------------------------- */
+
+static uint32_t crc32_table[256];
+
+void lvds_crc_init(void)
+{
+    for (int i = 0; i < 256; i++) {
+        uint16_t crc = (uint16_t)(i << 8);
+        for (int j = 0; j < 8; j++) {
+            if (crc & 0x8000) crc = (crc << 1) ^ 0x1021;
+            else              crc <<= 1;
+        }
+        crc16_table[i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; j++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        crc32_table[i] = crc;
+    }
+}
+
+uint16_t lvds_crc16_ccitt(const uint8_t *data, int len)
+{
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < len; i++) {
+        uint8_t idx = (crc >> 8) ^ data[i];
+        crc = (crc << 8) ^ crc16_table[idx];
+    }
+    return crc;
+}
+
+uint32_t lvds_crc32_iso_hdlc(const uint8_t *data, int len)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (int i = 0; i < len; i++)
+        crc = (crc >> 8) ^ crc32_table[(uint8_t)(crc ^ data[i])];
+    return ~crc;
+}
+
+static uint32_t line_crc(const lvds_proto_t *pr, const uint8_t *pix)
+{
+    return (pr->crc_type == LVDS_CRC16)
+         ? lvds_crc16_ccitt(pix, pr->width)
+         : lvds_crc32_iso_hdlc(pix, pr->width);
+}
+
+/* Expected CRC as transmitted after the pixels (`at` = first CRC byte) */
+static inline uint32_t expected_crc(const lvds_proto_t *pr, const uint8_t *at)
+{
+    if (pr->crc_type == LVDS_CRC16)
+        return ((uint32_t)at[0] << 8) | at[1];
+    return (uint32_t)at[0] | ((uint32_t)at[1] << 8)
+         | ((uint32_t)at[2] << 16) | ((uint32_t)at[3] << 24);
+}
+
+/* Extract row address from raw row byte.
+ *   Nichia: [odd_parity:1][row_addr:7]  row 0 = 0x80
+ *   Osram:  raw row number (parity handled by 8O1 UART) */
+static inline int extract_row(const lvds_parser_t *p, uint8_t raw)
+{
+    return raw & p->proto->row_mask;
+}
+
+/* ----------------------------------------------------------------- */
+/*  Setup                                                             */
+/* ----------------------------------------------------------------- */
+
+void lvds_parser_init(lvds_parser_t *p, const lvds_parser_ops_t *ops,
+                      lvds_parse_stats_t *stats, const uint8_t *ring,
+                      const lvds_proto_t *proto, uint8_t *asm_fb)
+{
+    memset(p, 0, sizeof(*p));
+    p->ops = ops;
+    p->stats = stats;
+    p->ring = ring;
+    p->proto = proto;
+    lvds_parser_reset(p, asm_fb);
+}
+
+void lvds_parser_reset(lvds_parser_t *p, uint8_t *asm_fb)
+{
+    p->ring_rd = 0;
+    p->ps = SCAN_SYNC;
+    p->line_pos = 0;
+    p->gap_budget = 0;
+    p->frame_locked = false;
+    p->prev_row = -1;
+    p->lines_placed = 0;
+    memset(p->line_placed, 0, sizeof(p->line_placed));
+    p->asm_fb = asm_fb;
+}
+
+void lvds_parser_resync(lvds_parser_t *p, uint32_t wr)
+{
+    p->ring_rd = wr & RING_MASK;
+    p->ps = SCAN_SYNC;
+    p->line_pos = 0;
+    p->frame_locked = false;
+}
+
+/* ----------------------------------------------------------------- */
+/*  Frame assembler                                                   */
+/* ----------------------------------------------------------------- */
+
+/* Start the next frame in asm_fb.  Its pixels are left as they are:
+ * whatever is not overwritten gets zeroed by lvds_parser_finish_frame(). */
+static void start_next_frame(lvds_parser_t *p)
+{
+    memset(p->line_placed, 0, p->proto->lvds_height * sizeof(bool));
+    p->lines_placed = 0;
+}
+
+/* Stale data from an earlier frame in a reused buffer, or rejected
+ * lines, must not reach the host. */
+uint16_t lvds_parser_finish_frame(const lvds_parser_t *p, uint8_t missing[MISSING_BM_BYTES])
+{
+    uint32_t w = p->proto->width;
+    uint16_t lines = 0;
+    memset(missing, 0, MISSING_BM_BYTES);
+    for (uint32_t r = 0; r < p->proto->active_height; r++) {
+        if (p->line_placed[r]) {
+            lines++;
+        } else {
+            memset(p->asm_fb + r * w, 0, w);
+            missing[r >> 3] |= (uint8_t)(1u << (r & 7));
+        }
+    }
+    return lines;
+}
+
+/* Time the byte at ring offset `off` arrived, from the feed snapshot */
+static uint64_t byte_time_us(const lvds_parser_t *p, uint32_t off)
+{
+    uint32_t behind = (p->wr_snap - off) & RING_MASK;
+    return p->t_snap - (uint64_t)behind * p->proto->bits_per_byte * 1000000u / p->proto->baud;
+}
+
+/* True if line `row` ends the frame being assembled (row decreased) */
+static bool ends_frame(const lvds_parser_t *p, int row)
+{
+    return row <= p->prev_row && p->prev_row >= 0 && p->lines_placed > 0;
+}
+
+/* Row validation: true if `row` should be written into asm_fb */
+static bool row_wanted(const lvds_parser_t *p, int row)
+{
+    return row < p->proto->active_height && !p->line_placed[row];
+}
+
+/* Frame boundary + row sequence shared by both parser paths, for a line
+ * that counts: any line with CRC reject off, only CRC-good ones with it
+ * on, so a corrupted row byte can neither end a frame nor move prev_row.
+ * `sync_off` = ring offset of the line's sync byte. */
+static void advance_row(lvds_parser_t *p, int row, uint32_t sync_off)
+{
+    /* Frame boundary: row decreased -> new frame */
+    bool frame_start = (row <= p->prev_row || p->prev_row < 0);
+    if (ends_frame(p, row)) {
+        p->asm_fb = p->ops->frame_done(p);
+        start_next_frame(p);
+    }
+    if (frame_start)
+        p->frame_sof_us = byte_time_us(p, sync_off);
+
+    /* Row-sequence validation: within a frame, rows should increase
+     * by exactly 1 each line (0, 1, 2, ..., 67).  A line from a
+     * false 0x5D match in gap data will have a random row number.
+     * Only place pixels when row matches the expected sequence.
+     * Frame start (prev_row == -1) always accepted. */
+    p->prev_row = row;
+
+    if (row >= p->proto->lvds_height) {
+        // row invalid -> probable false sync / corruption
+        p->stats->row_seq_skip++;
+    }
+}
+
+/* Count a line's CRC result.  Returns true if the line may be placed. */
+static bool account_line_crc(lvds_parser_t *p, bool match)
+{
+    if (match) {
+        p->stats->crc_ok_lines++;
+        return true;
+    }
+    p->stats->crc_errors++;
+    return !p->crc_reject;
+}
+
+static void mark_line_placed(lvds_parser_t *p, int row, uint32_t crc)
+{
+    p->line_placed[row] = true;
+    p->row_crc[row] = crc;
+    p->lines_placed++;
+    if (p->ops->row_placed)
+        p->ops->row_placed(p, row);
+}
+
+static void settle_line(const lvds_parser_t *p)
+{
+    if (p->ops->line_settle)
+        p->ops->line_settle();
+}
+
+void lvds_parser_line_moved(lvds_parser_t *p, uint32_t crc_got)
+{
+    const lvds_proto_t *pr = p->proto;
+    int row = p->pending_row;
+    bool match = (crc_got == p->pending_crc_exp);
+    bool crc_ok = account_line_crc(p, match);
+    if (p->ops->line_seen)
+        p->ops->line_seen(p, row, true, p->pending_off, match);
+    /* A rejected row stays unplaced and is zeroed at finish; it does not
+     * touch the frame boundary or prev_row either */
+    if (!crc_ok)
+        return;
+
+    if (p->pending_advance) {
+        advance_row(p, row, p->pending_off);
+        /* A line that ended the frame was moved into line_data */
+        if (p->pending_boundary && row_wanted(p, row)) {
+            memcpy(p->asm_fb + (row * pr->width), p->line_data, pr->width);
+            p->pending_place = true;
+        }
+    }
+    if (p->pending_place)
+        mark_line_placed(p, row, crc_got);
+}
+
+/* Byte path: complete line sits in p->line_data[], its sync byte was
+ * at ring offset `off` */
+static void handle_complete_line(lvds_parser_t *p, uint32_t off)
+{
+    const lvds_proto_t *pr = p->proto;
+    settle_line(p);
+
+    int row = extract_row(p, p->line_data[1]);
+
+    const uint8_t *pix = p->line_data + 2;
+    uint32_t crc = line_crc(pr, pix);
+    bool match = crc == expected_crc(pr, pix + pr->width);
+    bool crc_ok = account_line_crc(p, match);
+
+    if (p->ops->line_seen)
+        p->ops->line_seen(p, row, false, 0, match);
+
+    if (!crc_ok)
+        return;
+    advance_row(p, row, off);
+    if (row_wanted(p, row)) {
+        memcpy(p->asm_fb + (row * pr->width), pix, pr->width);
+        mark_line_placed(p, row, crc);
+    }
+}
+
+/* Fast path: complete line starts at ring offset `off` (sync byte).
+ * Pixels go straight from the ring into their asm_fb row; lines that
+ * are not placed (metadata rows, duplicates) are still CRC-checked. */
+static void handle_line_in_ring(lvds_parser_t *p, uint32_t off)
+{
+    const lvds_proto_t *pr = p->proto;
+    const uint8_t *ring = p->ring;
+    settle_line(p);
+
+    int row = extract_row(p, ring[(off + 1) & RING_MASK]);
+    uint32_t pix_off = (off + 2) & RING_MASK;
+    uint32_t crc_off = (pix_off + pr->width) & RING_MASK;
+
+    uint8_t crc_bytes[4];
+    for (int i = 0; i < pr->crc_len; i++)
+        crc_bytes[i] = ring[(crc_off + i) & RING_MASK];
+
+    /* With CRC reject on, the boundary and prev_row wait for the CRC
+     * (lvds_parser_line_moved).  A line that would end the frame cannot
+     * go into the next frame's buffer before the swap, so it is moved
+     * into line_data in software, which settles it at once; that is one
+     * line per frame. */
+    bool defer = p->crc_reject;
+    bool boundary = defer && ends_frame(p, row);
+    if (!defer)
+        advance_row(p, row, off);
+    bool place = !boundary && row_wanted(p, row);
+    uint8_t *dst = place ? p->asm_fb + (row * pr->width) : NULL;
+
+    p->pending_row      = row;
+    p->pending_place    = place;
+    p->pending_advance  = defer;
+    p->pending_boundary = boundary;
+    p->pending_off      = off;
+    p->pending_crc_exp  = expected_crc(pr, crc_bytes);
+
+    if (p->ops->line_move && !boundary) {
+        p->ops->line_move(p, dst, pix_off, pr->width);
+        return;
+    }
+
+    /* Software mover; rows that are not placed are checked in line_data */
+    uint8_t *to = dst ? dst : p->line_data;
+    uint32_t first = (pr->width < RING_SIZE - pix_off) ? pr->width : RING_SIZE - pix_off;
+    memcpy(to, ring + pix_off, first);
+    memcpy(to + first, ring, pr->width - first);
+    lvds_parser_line_moved(p, line_crc(pr, to));
+}
+
+/* ----------------------------------------------------------------- */
+/*  Line parser state machine                                         */
+/* ----------------------------------------------------------------- */
+
+uint32_t lvds_parser_feed(lvds_parser_t *p, uint32_t wr, uint64_t t_us, int budget)
+{
+    const lvds_proto_t *pr = p->proto;
+    const uint8_t *ring = p->ring;
+    uint32_t rd = p->ring_rd;
+
+    wr &= RING_MASK;
+    p->wr_snap = wr;
+    p->t_snap = t_us;
+
+    while (rd != wr && budget > 0)
+    {
+        /* Locked fast path: the previous line ended cleanly and the next
+         * one starts right here.  With the whole line already in the
+         * ring, validate sync + row byte in place and let
+         * handle_line_in_ring() copy the pixels straight into asm_fb.
+         * Anything unusual falls through to the byte state machine. */
+        if (p->ps == SCAN_GAP && ring[rd] == pr->sync_byte &&
+            ((wr - rd) & RING_MASK) >= pr->line_size &&
+            extract_row(p, ring[(rd + 1) & RING_MASK]) < pr->lvds_height)
+        {
+            handle_line_in_ring(p, rd);
+            rd = (rd + pr->line_size) & RING_MASK;
+            budget -= pr->line_size;
+            p->gap_budget = MAX_GAP_BYTES;
+            continue;
+        }
+
+        uint8_t b = ring[rd];
+        rd = (rd + 1) & RING_MASK;
+        budget--;
+
+        switch (p->ps)
+        {
+        case SCAN_SYNC:
+            /* Cold scan: search for the sync byte.  Only used at startup
+             * or after total loss of alignment; memchr() skips the non-sync run
+             * up to the write pointer or the ring end a word at a time. */
+            if (b != pr->sync_byte) {
+                uint32_t end = (wr >= rd) ? wr : RING_SIZE;
+                const uint8_t *hit = memchr(ring + rd, pr->sync_byte, end - rd);
+                uint32_t to = hit ? (uint32_t)(hit - ring) : end;
+                budget -= (int)(to - rd);
+                rd = to & RING_MASK;
+            } else {
+                p->line_data[0] = b;
+                p->line_pos = 1;
+                p->ps = READ_LINE;
+                p->frame_locked = false;
+            }
+            break;
+
+        case SCAN_GAP:
+            /* After a valid line, scan through inter-line gap/idle bytes
+             * looking for the next 0x5D.  Gap bytes are typically 0x00
+             * (LVDS idle), so there is no risk of false 0x5D matches.
+             * This handles protocols with variable inter-line padding. */
+            if (b == pr->sync_byte) {
+                p->line_data[0] = b;
+                p->line_pos = 1;
+                p->ps = READ_LINE;
+            } else {
+                p->stats->gap_bytes_total++;
+                p->gap_budget--;
+                if (p->gap_budget <= 0) {
+                    p->stats->gap_resyncs++;
+                    p->frame_locked = false;
+                    p->ps = SCAN_SYNC;
+                }
+            }
+            break;
+
+        case READ_LINE:
+            p->line_data[p->line_pos++] = b;
+
+            /* Early reject: invalid row after masking */
+            if (p->line_pos == 2) {
+                int rowChk = extract_row(p, b);
+                if (rowChk >= pr->lvds_height) {
+                    if (p->frame_locked) {
+                        /* Aligned but row byte is bad - scan gap for next sync */
+                        p->gap_budget = MAX_GAP_BYTES + pr->line_size;
+                        p->ps = SCAN_GAP;
+                    } else {
+                        /* From cold SCAN_SYNC - false sync on pixel 0x5D */
+                        if (b == pr->sync_byte) {
+                            p->line_data[0] = b;
+                            p->line_pos = 1;
+                        } else {
+                            p->ps = SCAN_SYNC;
+                            p->line_pos = 0;
+                        }
+                    }
+                    break;
+                }
+            }
+
+            if (p->line_pos >= pr->line_size) {
+                handle_complete_line(p, (rd - pr->line_size) & RING_MASK);
+                p->frame_locked = true;
+                p->line_pos = 0;
+                p->gap_budget = MAX_GAP_BYTES;
+                p->ps = SCAN_GAP;
+            }
+            break;
+        }
+    }
+
+    uint32_t used = (rd - p->ring_rd) & RING_MASK;
+    p->ring_rd = rd;
+    return used;
+}
@@ -0,0 +1,166 @@
+/*
+ * lvds_parser.h - LVDS line parser + frame assembler, no hardware access
+ *
+ * The parser consumes a capture ring that is filled elsewhere (PIO +
+ * DMA on the RP2350, a recorded capture in bench/).  It finds lines,
+ * checks row sequence and CRC, and assembles rows into a frame buffer.
+ * Everything that touches hardware or the rest of the firmware goes
+ * through lvds_parser_ops_t:
+ *   frame_done  - a frame is complete: hand it off, return the next buffer
+ *   line_move   - optional asynchronous line copy + CRC (DMA sniffer);
+ *                 without it lines are copied and checked in software
+ *   line_settle - finish the copy in flight, if any
+ *   line_seen   - optional, every complete line with its CRC result
+ *   row_placed  - optional, a row's pixels are final in the frame buffer
+ *
+ * Ring feed:
+ *   lvds_parser_feed(p, wr, t_us, budget) parses from p->ring_rd up to
+ *   ring offset `wr`, sampled at time `t_us`, and returns the bytes
+ *   consumed.  The caller owns write-pointer tracking and overrun
+ *   detection; after an overrun it calls lvds_parser_resync().
+ *
+ * Not thread-safe: one parser instance is driven by one core.
+ */
+#ifndef LVDS_PARSER_H
+#define LVDS_PARSER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define RING_BITS           15
+#define RING_SIZE           (1u << RING_BITS)
+#define RING_MASK           (RING_SIZE - 1)
+
+#define SYNC_BYTE           0x5D      /* of both built-in protocols */
+
+/* Max gap bytes between lines before declaring loss of sync.
+ * LVDS inter-line idle periods can insert 0-~20 null bytes. */
+#define MAX_GAP_BYTES       64
+
+/* Largest protocol (Osram): 320x84 frame, 2 + 320 + 4 byte lines */
+#define MAX_FRAME_BYTES     (320 * 84)
+#define MAX_LINE_BYTES      326
+#define MAX_LINE_WIDTH      320   /* pixels per line; row buffers are sized for it */
+#define MAX_LVDS_ROWS       84
+#define MISSING_BM_BYTES    12
+
+typedef enum { LVDS_CRC16 = 0, LVDS_CRC32 = 1 } lvds_crc_t;
+typedef enum { LVDS_PARITY_NONE = 0, LVDS_PARITY_ODD = 1, LVDS_PARITY_EVEN = 2 } lvds_parity_t;
+
+/* Line format of one panel type.  The built-in ones are below; others
+ * are uploaded at run time (host command 'U') and checked with
+ * lvds_proto_valid() first. */
+typedef struct {
+    uint16_t   width;
+    uint16_t   active_height;
+    uint16_t   lvds_height;
+    uint16_t   line_size;     /* sync + row + width + crc_len */
+    uint32_t   baud;
+    lvds_crc_t crc_type;
+    uint8_t    crc_len;
+    uint8_t    bits_per_byte; /* UART frame: start + data + parity + stop */
+    uint8_t    row_mask;      /* row address bits of the row byte */
+    uint8_t    sync_byte;     /* first byte of every line */
+    uint8_t    parity;        /* lvds_parity_t of the UART frame */
+} lvds_proto_t;
+
+#define BAUD_NICHIA  12500000
+#define BAUD_OSRAM   20000000
+
+extern const lvds_proto_t PROTO_NICHIA;
+extern const lvds_proto_t PROTO_OSRAM;
+
+/* Fields consistent with each other and within the parser's limits */
+bool     lvds_proto_valid(const lvds_proto_t *pr);
+
+/* Line counters, shared by all parser instances that point at them */
+typedef struct {
+    uint32_t crc_ok_lines;      /* lines with valid CRC */
+    uint32_t crc_errors;
+    uint32_t row_seq_skip;      /* lines skipped due to row sequence mismatch */
+    uint32_t gap_bytes_total;   /* total gap/idle bytes skipped */
+    uint32_t gap_resyncs;       /* times gap exceeded budget -> rescan */
+} lvds_parse_stats_t;
+
+typedef enum { SCAN_SYNC, READ_LINE, SCAN_GAP } parse_state_t;
+
+typedef struct lvds_parser lvds_parser_t;
+
+typedef struct {
+    /* Frame in p->asm_fb is complete (at least one row placed).
+     * Returns the buffer to assemble the next frame into; returning
+     * p->asm_fb drops the frame.  lvds_parser_finish_frame() zeroes the
+     * missing rows of a frame that is kept. */
+    uint8_t *(*frame_done)(lvds_parser_t *p);
+    /* Start copying `len` pixel bytes from ring offset `pix_off` to
+     * `dst` (NULL = CRC only) and computing their CRC; the result goes
+     * to lvds_parser_line_moved() by the next line_settle() call. */
+    void (*line_move)(lvds_parser_t *p, uint8_t *dst, uint32_t pix_off, uint32_t len);
+    void (*line_settle)(void);
+    /* Line as received: in the ring at `ring_off` (from_ring) or in
+     * p->line_data, plus its CRC result */
+    void (*line_seen)(lvds_parser_t *p, int row, bool from_ring, uint32_t ring_off, bool crc_ok);
+    /* Active row `row` of p->asm_fb is placed and its copy settled
+     * (p->lines_placed already counts it) */
+    void (*row_placed)(lvds_parser_t *p, int row);
+} lvds_parser_ops_t;
+
+struct lvds_parser {
+    const lvds_parser_ops_t *ops;
+    const lvds_proto_t *proto;
+    lvds_parse_stats_t *stats;
+    const uint8_t *ring;            /* RING_SIZE bytes */
+    uint32_t  ring_rd;
+    bool      crc_reject;           /* drop lines with a bad CRC */
+
+    /* Ring write offset and time sampled together for each feed; the
+     * arrival time of any byte in that pass follows from how far it
+     * sits behind the write pointer. */
+    uint32_t  wr_snap;
+    uint64_t  t_snap;
+
+    parse_state_t ps;
+    uint8_t   line_data[MAX_LINE_BYTES];
+    int       line_pos;
+    int       gap_budget;           /* bytes left to scan in SCAN_GAP */
+    bool      frame_locked;         /* true after first valid line */
+
+    uint8_t  *asm_fb;               /* frame being assembled */
+    bool      line_placed[MAX_LVDS_ROWS];
+    uint32_t  row_crc[MAX_LVDS_ROWS];   /* computed CRC of each placed row */
+    int       lines_placed;
+    int       prev_row;
+    uint64_t  frame_sof_us;         /* sync time of the current frame's first line */
+
+    /* Line handed to ops->line_move, settled by lvds_parser_line_moved() */
+    int       pending_row;
+    bool      pending_place;
+    bool      pending_advance;      /* boundary + prev_row wait for its CRC */
+    bool      pending_boundary;     /* ...and it ends the frame (in line_data) */
+    uint32_t  pending_off;          /* its sync byte */
+    uint32_t  pending_crc_exp;
+};
+
+void     lvds_crc_init(void);
+uint16_t lvds_crc16_ccitt(const uint8_t *data, int len);
+uint32_t lvds_crc32_iso_hdlc(const uint8_t *data, int len);
+
+/* Set up `p` over `ring` and start scanning at offset 0 */
+void     lvds_parser_init(lvds_parser_t *p, const lvds_parser_ops_t *ops,
+                          lvds_parse_stats_t *stats, const uint8_t *ring,
+                          const lvds_proto_t *proto, uint8_t *asm_fb);
+/* Forget all line and frame state (protocol change, restart) */
+void     lvds_parser_reset(lvds_parser_t *p, uint8_t *asm_fb);
+/* Unread bytes were lost: continue at ring offset `wr` with a cold scan */
+void     lvds_parser_resync(lvds_parser_t *p, uint32_t wr);
+uint32_t lvds_parser_feed(lvds_parser_t *p, uint32_t wr, uint64_t t_us, int budget);
+
+/* Result of ops->line_move for the line pending on `p` */
+void     lvds_parser_line_moved(lvds_parser_t *p, uint32_t crc_got);
+
+/* Zero the rows of p->asm_fb this frame did not deliver and fill the
+ * missing-row bitmap.  Returns the number of active rows received. */
+uint16_t lvds_parser_finish_frame(const lvds_parser_t *p, uint8_t missing[MISSING_BM_BYTES]);
+
+#endif /* LVDS_PARSER_H */
@@ -2,21 +2,53 @@
  * main.c - Frame-aware LVDS-to-USB-vendor bridge for Raspberry Pi Pico 2 (RP2350)
  *
  * Architecture:
- *   LVDS -> NBA3N012C -> TTL -> GPIO2 -> PIO UART RX -> byte-DMA -> ring
+ *   LVDS -> NBA3N012C -> TTL -> GPIO2 -> PIO UART RX -> word-DMA -> ring
  *   -> CPU line parser -> frame assembler -> USB vendor -> PC
  *
+ * The line parser and frame assembler are in lvds_parser.c and do not
+ * touch hardware; this file drives them through lvds_parser_ops_t (line
+ * DMA, frame hand-off, line records).  bench/ builds the same parser on
+ * a host for throughput measurements.
+ *
+ * With LVDS_LINKS=2 a second link on GPIO3 gets its own state machine,
+ * ring, parser and assembler.  Both links share the frame pool and the
+ * USB stream; every frame is sent with an extended header whose
+ * channel byte says which link it came from (0 = GPIO2, 1 = GPIO3).
+ *
+ * With LVDS_PACKED_FIFO=1 (default) the PIO autopushes four received
+ * bytes per FIFO word and a 32-bit DMA stores them in the ring, a
+ * quarter of the FIFO/DMA transactions of the byte-per-word programs.
+ *
+ * Dual-core pipeline (LVDS_DUAL_CORE=1, default):
+ *   core 1: ring -> line parser -> frame assembler -> ready queue
+ *   core 0: TinyUSB + host commands + ready queue -> USB sender
+ *   Frame buffers travel between the cores through two lock-free SPSC
+ *   queues (ready: core 1 -> core 0, free: core 0 -> core 1), so the
+ *   data path never blocks on the other core.
+ *
+ * Frame pool: FRAME_POOL_SIZE buffers circulate between the assembler,
+ * the ready queue and the sender, so a brief USB stall queues frames
+ * instead of dropping them.  Buffers are not cleared per frame: rows
+ * that were not placed are zeroed when the frame is handed off.
+ *
  * Instead of blindly forwarding raw UART bytes to USB (which overflows
  * because UART rate > USB vendor throughput via RDP), the firmware parses
  * the LVDS line protocol on-chip, assembles complete frames, and sends
  * cooked frame packets to the host.
  *
- * Frame skipping handles the bandwidth mismatch gracefully:
+ * Adaptive frame pacing handles the bandwidth mismatch gracefully:
  *   UART input:  849 KB/s  (260 B/line x 68 lines x 48 FPS, Nichia)
- *   USB output:  ~500 KB/s (USB FS vendor through RDP)
+ *   USB output:  ~500 KB/s (USB FS vendor through RDP) .. ~1 MB/s direct
  *   Cooked frame: 16392 B  (8-byte header + 256x64 pixels)
- *   At 24 FPS:  393 KB/s   <- fits comfortably in USB budget
  *
- * Result: ~24 FPS of COMPLETE, CORRECT frames.
+ * Every assembled frame is handed to the sender if a buffer is free, and
+ * dropped only when the whole pool is waiting on the sender.  The
+ * output rate therefore follows what the link actually drains: ~24 FPS
+ * through RDP, up to the full 48 FPS on a direct USB connection.  The
+ * measured drain rate and achieved FPS are reported by 'S'.
+ * 'P' <n> forces a fixed 1-in-n decimation instead (0/1 = adaptive).
+ *
+ * Result: COMPLETE, CORRECT frames at the highest rate the link carries.
  *
  * USB cooked frame protocol:
  *   [0xFE] [0xED]                        - magic bytes
@@ -25,13 +57,141 @@
  *   [height_lo] [height_hi]              - active height (LE)
  *   [width x height bytes of pixel data] - row-major, grayscale
  *
+ * Extended packet (delta mode 'D' 1, compression 'Z' <mode>, or LVDS_LINKS=2):
+ *   [0xFE] [0xEE]                        - magic bytes
+ *   [version] [hdr_len]                  - header version (2), total header bytes
+ *   [flags] [channel]                    - bit0 DELTA, bit1 KEY, bit2 RLE, bit3 NIB4;
+ *                                          link the frame came from (0 or 1)
+ *   [frame_id_lo] [frame_id_hi]          - 16-bit frame counter (LE)
+ *   [width_lo] [width_hi]                - frame width (LE)
+ *   [height_lo] [height_hi]              - active height (LE)
+ *   [payload_len x4]                     - payload bytes that follow (LE)
+ *   version 2 adds (hdr_len 44):
+ *   [frame_id x4]                        - 32-bit frame counter (LE)
+ *   [sof_us x8]                          - time_us_64() at the sync byte of
+ *                                          the frame's first line (LE)
+ *   [lines_placed x2]                    - active rows received (LE)
+ *   [missing_len] [reserved]             - bytes of missing-row bitmap used
+ *   [missing x12]                        - bit (r & 7) of byte r/8 = row r missing
+ *   version 3 adds (hdr_len 56):
+ *   [roi_x x2] [roi_y x2]                - window origin in the assembled frame (LE)
+ *   [src_width x2] [src_height x2]       - assembled frame size (LE)
+ *   [row_step] [reserved x3]             - source rows per sent row
+ *   Hosts skip header bytes they do not know (hdr_len).
+ *   width/height, lines_placed and the missing bitmap describe the rows
+ *   that are sent: sent row r is source row roi_y + r * row_step.
+ *   KEY:   width x height pixels          - full keyframe
+ *   DELTA: [ceil(height/8) row bitmap]   - bit (r & 7) of byte r/8 = row r changed
+ *          [changed rows, width bytes each, top to bottom]
+ *   A delta applies to the previously sent frame of the same channel.
+ *   A keyframe goes out every KEYFRAME_INTERVAL frames, after mode
+ *   changes/reconnects, and whenever the host sends 'K'.
+ *
+ * Compression ('Z' <mode>: 0 off, 1 RLE, 2 NIB4, 3 auto) applies to the
+ * pixel bytes of the payload (all rows of a KEY, the changed rows of a
+ * DELTA; the row bitmap stays raw):
+ *   NIB4:  [16-byte palette] then each row packed 2 pixels/byte, high
+ *          nibble first, ceil(width/2) bytes per row.  Only used when
+ *          the frame has <= 16 distinct gray levels.
+ *   RLE:   PackBits over the (packed) rows: n = 0..127 -> n+1 literal
+ *          bytes follow, n = 0x81..0xFF -> next byte repeated 257-n times.
+ *   Auto uses NIB4+RLE when possible, RLE otherwise.  A frame that does
+ *   not get smaller is sent raw (no compression flag).
+ *
+ * Region of interest ('W' <x x2> <y> <w x2> <h> <step>):
+ *   Frames carry only the window x .. x+w-1, rows y, y+step, ... below
+ *   y+h (w/h 0 = to the right/bottom edge, step 0/1 = every row), with
+ *   the window in the version 3 header.  All zero = full frame.  The
+ *   sender picks the window's rows straight out of the frame buffer, so
+ *   a small window costs neither a copy nor USB bandwidth outside it.
+ *
+ * Frame statistics ('H' <flags>: bit0 row summary, bit1 histogram, 0 off):
+ *   [0xFE] [0xEB]                        - magic bytes
+ *   [version] [channel]                  - statistics version (1), link
+ *   [len_lo] [len_hi]                    - body bytes that follow
+ *   [frame_id x4]                        - 32-bit frame counter (LE)
+ *   [width x2] [rows x2]                 - window that is sent (LE)
+ *   [flags] [reserved x3]                - parts present, as in 'H'
+ *   bit0: rows x [check x4][min][max][mean][reserved]
+ *   bit1: [256 x count16]                - gray level histogram (LE)
+ *   Sent immediately before the frame packet it describes.  The row
+ *   check is the line CRC of the whole source row (CRC-16 zero-extended
+ *   for Nichia), 0 = row missing, so equal checks mean an unchanged row.
+ *
+ * Raw line records (line mode, 'L' 1 <row_lo> <row_hi>):
+ *   [0xFE] [0xEF]                        - magic bytes
+ *   [status]                             - bit0 = CRC ok, bits 4-7 = channel
+ *   [len_lo] [len_hi]                    - line bytes that follow
+ *   [0x5D] [row] [pixels] [crc]          - the line exactly as received
+ *   One record per validated line with row_lo <= row <= row_hi; gap
+ *   bytes and early-rejected rows are not sent.  No frames are sent
+ *   while line mode is on ('L' 0 returns to frames).
+ *
+ * Row records (row mode, 'Y' 1; 'Y' 0 returns to frames):
+ *   [0xFE] [0xEA]                        - magic bytes
+ *   [type] [channel]                     - 0 = ROW, 1 = END; link
+ *   [frame_id x4]                        - 32-bit frame counter (LE)
+ *   [index x2]                           - window row (ROW), rows (END)
+ *   [len_lo] [len_hi]                    - body bytes that follow
+ *   ROW: the row's window pixels, sent as soon as the row is placed
+ *   END: [sof_us x8] [width x2] [rows x2] [lines_placed x2]
+ *        [missing_len] [reserved] [missing x12]
+ *        [roi_x x2] [roi_y x2] [src_width x2] [src_height x2]
+ *        [row_step] [reserved x3]         - as in the v2/v3 header
+ *   END follows the last active row, or the frame's last row when it
+ *   ends short.  A host sees each row about one line time after it
+ *   arrived instead of after the whole frame.  Rows are never delta
+ *   coded or compressed; the 'W' window applies.  'L' 1 ends row mode.
+ *
+ * Synthetic line generator ('G' <fps> <pattern> <errors>):
+ *   A state machine on pio1 sends generated frames in the current
+ *   protocol's line format (valid CRCs, `errors` bad-CRC lines per 1000)
+ *   on GEN_TX_PIN, which is wired back to the capture input.  Row 0
+ *   starts with the 32-bit generator frame number (LE), so the host can
+ *   count drops; with sof_us this measures FPS, drops and latency
+ *   without an ECU.  Pattern 0 scrolls a gradient (every row changes),
+ *   pattern 1 moves a 4-row bar (few rows change).  fps 0 = off.
+ *
+ * USB transmit ('X' <mode>):
+ *   1 = packed (default): between sender passes the TX FIFO holds only
+ *       whole 64-byte packets and it is flushed once per packet, so the
+ *       bulk IN transfers are multi-packet and the only short packet of
+ *       a frame is its tail (a ZLP when the frame ends on a packet
+ *       boundary).  The host can read in large blocks.
+ *   0 = flush after every sender pass.
+ *   'S' reports transfers / packets / ZLPs and bus use against the FS
+ *   bulk ceiling (19 packets per 1 ms frame).
+ *
  * Protocol modes (selected by host command over vendor):
  *   'N' = Nichia:  12,500,000 baud, 8N1, 8x oversampling, 256x64 active
  *   'O' = Osram:   20,000,000 baud, 8O1*, 4x oversampling, 320x80 active
+ *   'U' <16 bytes> = custom line format:
+ *       [width x2] [active_height x2] [lvds_height x2] [line_size x2]
+ *       [baud x4] [crc_type] [parity] [sync] [row_mask]       (all LE)
+ *       crc_type 0 = CRC-16, 1 = CRC-32; parity 0 none, 1 odd, 2 even;
+ *       line_size must be 2 + width + CRC bytes.  Invalid ones are
+ *       ignored (PROTO_REJ in 'S').  The RX program follows the baud:
+ *       8x up to clk_sys / 8, 4x up to clk_sys / 4.
+ *   'A' = auto-detect: a PIO edge timer measures the bit time on link 0
+ *       (a rate within 8% of a known one is taken as that one), capture
+ *       restarts at it and the built-in / last uploaded formats are
+ *       tried on 8 KB of input; the one with the most CRC-valid lines
+ *       is kept, else the previous one.  A status line reports
+ *       DETECT=result:measured_baud:lines.  Rates up to about clk_sys / 7
+ *       (20 Mbps at 150 MHz); parity is taken from the format.
+ *   Switching keeps the ring DMA running and clears no buffers: the
+ *   parsers resync to the write pointer, and the RX program is only
+ *   reloaded when the oversampling changes.
+ *
+ * Line CRC (checked by the DMA sniffer while the line is moved):
+ *   Nichia: CRC-16/CCITT-FALSE, 2 bytes big-endian
+ *   Osram:  CRC-32/ISO-HDLC,    4 bytes little-endian
+ *   'C' <0|1> = count CRC errors only (default) / drop bad lines
  *
  * Hardware setup:
  *   - Pico 2 on gusmanb LogicAnalyzer level-shifting board
  *   - LVDS receiver (onsemi NBA3N012C) -> TTL -> Channel 1 (GPIO 2)
+ *     (second link with LVDS_LINKS=2: Channel 2, GPIO 3)
  *   - USB vendor virtual COM port to PC
  */
 
@@ -42,154 +202,514 @@
 #include "hardware/dma.h"
 #include "hardware/clocks.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "pico/multicore.h"
 #include "tusb.h"
+#include "device/usbd_pvt.h"   /* usbd_edpt_xfer() for the ZLP, TinyUSB < 0.17 */
 #include "bsp/board_api.h"
 #include "pico/bootrom.h"
 
-/* Generated from uart_rx.pio */
+/* Generated from uart_rx.pio / uart_tx.pio */
 #include "uart_rx.pio.h"
+#include "uart_tx.pio.h"
+#include "lvds_parser.h"
 
 /* ----------------------------------------------------------------- */
 /*  Configuration                                                     */
 /* ----------------------------------------------------------------- */
 
-#define UART_RX_PIN         2
-#define LED_PIN             25
+/* 1 = parser/assembler on core 1, USB on core 0 (see CMakeLists.txt) */
+#ifndef LVDS_DUAL_CORE
+#define LVDS_DUAL_CORE      1
+#endif
 
-#define RING_BITS           15
-#define RING_SIZE           (1u << RING_BITS)
-#define RING_MASK           (RING_SIZE - 1)
+/* 1 = 4 bytes per PIO FIFO word + 32-bit DMA, 0 = one byte per word */
+#ifndef LVDS_PACKED_FIFO
+#define LVDS_PACKED_FIFO    1
+#endif
 
-#define SYNC_BYTE           0x5D
+/* 2 = also capture a second link on UART_RX_PIN_B (see CMakeLists.txt) */
+#ifndef LVDS_LINKS
+#define LVDS_LINKS          1
+#endif
+
+#define UART_RX_PIN         2
+#define UART_RX_PIN_B       3
+#ifndef GEN_TX_PIN
+#define GEN_TX_PIN          0       /* generator output, wire to Channel 1 */
+#endif
+#define LED_PIN             25
 
 #define FRAME_MAGIC_0       0xFE
 #define FRAME_MAGIC_1       0xED
 #define FRAME_HDR_SIZE      8
 
-typedef struct {
-    uint16_t width;
-    uint16_t active_height;
-    uint16_t lvds_height;
-    uint16_t line_size;
-    uint32_t baud;
-} lvds_proto_t;
-
-#define BAUD_NICHIA  12500000
-#define BAUD_OSRAM   20000000
-
-static const lvds_proto_t PROTO_NICHIA = { 256, 64, 68, 260, BAUD_NICHIA };
-static const lvds_proto_t PROTO_OSRAM  = { 320, 80, 84, 324, BAUD_OSRAM };
-static const lvds_proto_t *proto = &PROTO_NICHIA;
+#define EXT_MAGIC_1         0xEE
+#define EXT_HDR_VERSION     3
+#define EXT_HDR_SIZE        56
+#define EXT_FLAG_DELTA      0x01
+#define EXT_FLAG_KEY        0x02
+#define EXT_FLAG_RLE        0x04
+#define EXT_FLAG_NIB4       0x08
+
+#define KEYFRAME_INTERVAL   48
+
+#define LINE_REC_MAGIC_1    0xEF
+#define LINE_REC_HDR_SIZE   5
+#define LINE_Q_BITS         14
+#define LINE_Q_SIZE         (1u << LINE_Q_BITS)
+#define LINE_Q_MASK         (LINE_Q_SIZE - 1)
+
+#define ROW_REC_MAGIC_1     0xEA
+#define ROW_REC_HDR_SIZE    12
+#define ROW_REC_ROW         0
+#define ROW_REC_END         1
+#define ROW_REC_END_SIZE    40
+
+#define STATS_MAGIC_1       0xEB
+#define STATS_VERSION       1
+#define STATS_HDR_SIZE      6       /* FE EB ver channel len16 */
+#define STATS_FIXED_SIZE    12      /* frame_id x4, width x2, rows x2, flags, rsvd x3 */
+#define STATS_ROW_SIZE      8
+#define STATS_HIST_BINS     256
+#define STATS_FLAG_ROWS     0x01
+#define STATS_FLAG_HIST     0x02
+#define STATS_MAX_SIZE      (STATS_HDR_SIZE + STATS_FIXED_SIZE + \
+                             MAX_LVDS_ROWS * STATS_ROW_SIZE + STATS_HIST_BINS * 2)
+
+/* Line format in use: a copy of a built-in, uploaded ('U') or detected
+ * ('A') descriptor.  Only changed while the parser is paused. */
+static lvds_proto_t active_proto;
+static const lvds_proto_t *const proto = &active_proto;
 
 /* ----------------------------------------------------------------- */
 /*  Globals                                                           */
 /* ----------------------------------------------------------------- */
 
 static PIO  pio     = pio0;
-static uint sm      = 0;
-static int  dma_chan = -1;
 
-static uint8_t  ring_buf[RING_SIZE] __attribute__((aligned(RING_SIZE)));
-static uint32_t ring_rd = 0;
+static uint8_t  ring_bufs[LVDS_LINKS][RING_SIZE] __attribute__((aligned(RING_SIZE)));
 
-typedef enum { MODE_NICHIA = 0, MODE_OSRAM = 1 } protocol_mode_t;
+/* The control channel steps through ring_reload[] (a read ring), one
+ * entry per lap, so its read address is a lap counter mod RING_LAPS.
+ * Positions below are (lap << RING_BITS) | offset within the ring. */
+#define RING_LAP_BITS       8
+#define RING_LAPS           (1u << RING_LAP_BITS)
+#define RING_POS_MASK       ((1u << (RING_BITS + RING_LAP_BITS)) - 1)
+static uint32_t ring_reloads[LVDS_LINKS][RING_LAPS] __attribute__((aligned(RING_LAPS * 4)));
+
+typedef enum { MODE_NICHIA = 0, MODE_OSRAM = 1, MODE_CUSTOM = 2 } protocol_mode_t;
 static protocol_mode_t current_mode = MODE_NICHIA;
+static uint           rx_os;           /* oversampling of the loaded RX program */
+
+/* Descriptor upload ('U'): [width x2] [active_height x2] [lvds_height x2]
+ * [line_size x2] [baud x4] [crc_type] [parity] [sync] [row_mask] */
+#define PROTO_DESC_SIZE     16
+static lvds_proto_t   custom_proto;    /* last valid upload */
+static bool           custom_valid = false;
+static uint32_t       proto_rejects = 0;
+
+/* Auto-detection ('A'): edge timer on a spare state machine of the
+ * capture PIO, then a trial parse of the captured bytes per format.
+ * Stepped from the main loop (detect_step), so USB and the sender keep
+ * running while it measures and captures. */
+#define DETECT_SM           3
+#define DETECT_PULSES       1024
+#define DETECT_TIMEOUT_US   20000
+#define DETECT_SLICE_US     200     /* edge timer FIFO drained per main loop pass */
+#define DETECT_BYTES        8192
+#define DETECT_WAIT_US      50000
+#define DETECT_MIN_LINES    8
+#define DETECT_SNAP_PCT     8       /* measured rate within this of a known one = that one */
+
+typedef enum { DETECT_IDLE = 0, DETECT_MEASURE, DETECT_CAPTURE } detect_state_t;
+typedef enum { DETECT_NONE = 0, DETECT_OK, DETECT_NO_SIGNAL, DETECT_NO_LINES } detect_result_t;
+static const char *const detect_names[] = { "-", "OK", "NOSIGNAL", "NOLINES" };
+static detect_result_t detect_result = DETECT_NONE;
+static uint32_t detect_baud  = 0;      /* measured, before snapping */
+static uint32_t detect_lines = 0;      /* CRC-valid lines of the chosen format */
+static uint16_t detect_pulses[DETECT_PULSES];
+static detect_state_t  detect_state = DETECT_IDLE;
+static uint32_t        detect_n, detect_min_cy, detect_t0;
+static bool            detect_first;   /* edge timer may have started mid-pulse */
+static uint            detect_prog_off;
+static uint32_t        detect_start;   /* ring position of the capture at the measured rate */
+static lvds_proto_t    detect_prev, detect_cand[3];
+static protocol_mode_t detect_prev_mode, detect_cand_mode[3];
+static int             detect_ncand;
+
+/* Frame buffer pool (max: Osram 320x84 = 26880 B each).  One buffer is
+ * being assembled, one sent, the rest absorb USB stalls in ready_q. */
+#ifndef FRAME_POOL_SIZE
+#define FRAME_POOL_SIZE  6
+#endif
+
+_Static_assert(FRAME_POOL_SIZE > LVDS_LINKS, "each link assembles into its own buffer");
+
+static uint8_t  frame_pool[FRAME_POOL_SIZE][MAX_FRAME_BYTES];
+static uint8_t *send_fb = NULL;    /* sending from (NULL = idle, USB side) */
+
+/* Frame hand-off between assembler and sender.
+ * Single-producer / single-consumer ring: head is written only by the
+ * producer, tail only by the consumer, so it is safe across cores
+ * without locks.  Length must be a power of two > number of buffers. */
+typedef struct {
+    uint8_t  *fb;
+    uint32_t  frame_id;
+    uint16_t  width;
+    uint16_t  height;
+    uint64_t  sof_us;                     /* first line sync time */
+    uint16_t  lines;                      /* active rows placed */
+    uint8_t   missing[MISSING_BM_BYTES];  /* bit set = row missing */
+    uint8_t   channel;                    /* link the frame came from */
+} frame_desc_t;
 
-/* Double-buffered frame assembly (max: Osram 320x84 = 26880 B) */
-#define MAX_FRAME_BYTES  (320 * 84)
+#define FRAME_Q_LEN  8
 
-static uint8_t  fb_a[MAX_FRAME_BYTES];
-static uint8_t  fb_b[MAX_FRAME_BYTES];
-static uint8_t *asm_fb  = fb_a;    /* assembling into */
-static uint8_t *send_fb = NULL;    /* sending from (NULL = idle) */
+_Static_assert(FRAME_Q_LEN > FRAME_POOL_SIZE && (FRAME_Q_LEN & (FRAME_Q_LEN - 1)) == 0,
+               "FRAME_Q_LEN must be a power of two larger than the pool");
 
-static bool     line_placed[84];
-static int      lines_placed = 0;
-static int      prev_row = -1;
+typedef struct {
+    frame_desc_t      slot[FRAME_Q_LEN];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+} frame_queue_t;
+
+static frame_queue_t ready_q;      /* assembled frames -> sender   */
+static frame_queue_t free_q;       /* sent buffers     -> assembler */
+
+/* USB send state: the current packet is a list of byte ranges
+ * (stats, header, bitmap, runs of rows) written out back to back.
+ * Worst case: stats + header + bitmap + every row on its own (a
+ * narrow ROI does not merge rows). */
+typedef struct {
+    const uint8_t *ptr;
+    uint32_t       len;
+} send_seg_t;
 
-/* USB send state */
-static uint32_t send_total  = 0;
-static uint32_t send_offset = 0;
-static uint8_t  send_hdr[FRAME_HDR_SIZE];
+#define SEND_MAX_SEGS  (3 + MAX_LVDS_ROWS)
 
-/* Line parser state machine */
-typedef enum { SCAN_SYNC, READ_LINE, SCAN_GAP } parse_state_t;
-static parse_state_t ps = SCAN_SYNC;
-static uint8_t  line_data[324];   /* max line (Osram) */
-static int      line_pos = 0;
-static int      gap_budget = 0;       /* bytes left to scan in SCAN_GAP */
-static bool     frame_locked = false; /* true after first valid line */
+static send_seg_t send_seg[SEND_MAX_SEGS];
+static int        send_nseg    = 0;
+static int        send_cur     = 0;
+static uint32_t   send_seg_off = 0;
+static uint8_t    send_hdr[EXT_HDR_SIZE];
 
-/* Max gap bytes between lines before declaring loss of sync.
- * LVDS inter-line idle periods can insert 0-~20 null bytes. */
-#define MAX_GAP_BYTES  64
+/* Region of interest ('W'), as requested; clamped to each frame by
+ * frame_window().  roi_w/roi_h 0 = to the edge. */
+static uint16_t roi_x = 0, roi_w = 0;
+static uint8_t  roi_y = 0, roi_h = 0, roi_step = 1;
 
-/* Extract row address from raw row byte.
- *   Nichia: [odd_parity:1][row_addr:7]  row 0 = 0x80
- *   Osram:  raw row number (parity handled by 8O1 UART) */
-static inline int extract_row(uint8_t raw) {
-    return (current_mode == MODE_NICHIA) ? (raw & 0x7F) : raw;
-}
+/* Part of a frame that is sent: `rows` rows of `w` pixels, the first at
+ * `first`, each `pitch` bytes after the previous one */
+typedef struct {
+    const uint8_t *first;
+    uint32_t pitch;
+    uint16_t x, y, w, rows;
+    uint8_t  step;
+    bool     full;                        /* the whole frame */
+} frame_window_t;
+
+/* Delta encoding (sender side).  Each channel's ref mirrors what the
+ * host holds for it: the last frame sent, updated row by row as deltas
+ * go out.  keyframe_req invalidates all of them. */
+typedef struct {
+    uint8_t  fb[MAX_FRAME_BYTES];
+    bool     valid;
+    uint16_t w, h;
+    uint32_t since_key;
+} delta_ref_t;
+
+static volatile bool delta_enabled = false;
+static volatile bool keyframe_req  = true;
+static delta_ref_t delta_ref[LVDS_LINKS];
+static uint8_t  delta_bitmap[(84 + 7) / 8];
+
+/* Payload compression (sender side).  The packet is compressed a few
+ * rows per send_frame_chunk() call before it is written, so the
+ * header can carry the exact payload length. */
+typedef enum { COMP_OFF = 0, COMP_RLE = 1, COMP_NIB4 = 2, COMP_AUTO = 3 } comp_mode_t;
+typedef enum { COMP_IDLE, COMP_SCAN, COMP_PACK } comp_phase_t;
+
+#define COMP_ROW_BUDGET  512          /* input bytes per slice (~2 rows) */
+#define NIB4_PALETTE     16
+
+static volatile uint8_t comp_mode = COMP_OFF;
+static comp_phase_t comp_phase = COMP_IDLE;
+static uint8_t  comp_buf[MAX_FRAME_BYTES + 512];
+static uint32_t comp_len;
+static uint8_t  comp_flags;           /* EXT_FLAG_RLE / EXT_FLAG_NIB4 */
+static uint8_t  comp_lut[256];        /* gray level -> palette index */
+static uint32_t comp_used[8];         /* gray levels seen (bit set) */
+static uint32_t comp_levels;
+static uint32_t comp_row;             /* next row to scan/pack */
+static uint32_t comp_raw_len;         /* uncompressed pixel bytes */
+static const uint8_t *comp_src;       /* first pixel of the window */
+static uint32_t comp_pitch;           /* bytes between its rows */
+static uint16_t comp_w, comp_h;
+static bool     comp_delta;           /* rows selected by delta_bitmap */
+
+/* Frame statistics ('H' <flags>), computed over the sent window a few
+ * rows per send_frame_chunk() call before the frame is written.  Row
+ * checksums are the line CRCs the parser computed while placing each
+ * row, saved per pool buffer when the frame is handed off. */
+#define STATS_ROW_BUDGET  2048        /* pixels per slice */
+
+static volatile uint8_t stats_flags = 0;
+static bool     stats_busy = false;   /* stats_pkt still being filled */
+static uint8_t  stats_pkt[STATS_MAX_SIZE];
+static uint32_t stats_len;            /* 0 = no stats packet for this frame */
+static uint32_t stats_row;            /* next window row */
+static uint16_t stats_hist[STATS_HIST_BINS];
+static frame_window_t stats_win;
+static const uint32_t *stats_crc;     /* row CRCs of the frame being sent */
+static uint32_t frame_row_crc[FRAME_POOL_SIZE][MAX_LVDS_ROWS];
+
+/* Raw line passthrough: records go through a byte ring, head written
+ * by the parser core, tail by the sender (same rules as frame_queue_t).
+ * A record is published only once its CRC status is known. */
+static volatile bool    line_mode   = false;
+static volatile bool    row_mode    = false;  /* 'Y': rows stream through line_q */
+static volatile uint8_t line_row_lo = 0;
+static volatile uint8_t line_row_hi = 0xFF;
+static uint8_t  line_q[LINE_Q_SIZE];
+static volatile uint32_t line_q_head = 0;
+static volatile uint32_t line_q_tail = 0;
+
+/* One captured link: its state machine, capture ring, parser and frame
+ * assembler (lvds_parser.c).  The frame pool, queues and sender are
+ * shared, and frames carry the link's id as their channel. */
+typedef struct {
+    lvds_parser_t parser;             /* first: parser ops cast back to the link */
+    uint8_t   id;
+    uint      pin;
+    uint      sm;
+    int       dma_chan;
+    int       ring_ctrl_chan;         /* reloads dma_chan once per ring lap */
+    uint8_t  *ring_buf;
+    uint32_t *ring_reload;
+    uint32_t  ring_rd_pos;            /* parser.ring_rd with the parser's lap count */
+    uint32_t  frame_id;
+    uint32_t  decim;                  /* fixed decimation phase */
+    frame_window_t row_win;           /* row mode: window of the frame in progress */
+    bool      row_ended;              /* row mode: its end record is queued */
+} lvds_link_t;
+
+static lvds_link_t links[LVDS_LINKS] = {
+    { .id = 0, .pin = UART_RX_PIN,   .sm = 0, .dma_chan = -1, .ring_ctrl_chan = -1,
+      .ring_buf = ring_bufs[0], .ring_reload = ring_reloads[0] },
+#if LVDS_LINKS > 1
+    { .id = 1, .pin = UART_RX_PIN_B, .sm = 1, .dma_chan = -1, .ring_ctrl_chan = -1,
+      .ring_buf = ring_bufs[1], .ring_reload = ring_reloads[1] },
+#endif
+};
 
 /* Statistics */
-static uint32_t fw_frame_id     = 0;
 static uint32_t frames_sent     = 0;
 static uint32_t frames_dropped  = 0;
-static uint32_t crc_errors      = 0;
-static uint32_t crc_ok_lines    = 0;  /* lines with valid CRC */
-static uint32_t row_seq_skip    = 0;  /* lines skipped due to row sequence mismatch */
-static uint32_t gap_bytes_total = 0;  /* total gap/idle bytes skipped */
-static uint32_t gap_resyncs     = 0;  /* times gap exceeded budget -> rescan */
+static uint32_t queue_hwm       = 0;  /* most frames waiting in ready_q */
+static uint32_t line_recs       = 0;  /* raw line records queued */
+static uint32_t line_rec_drops  = 0;  /* ... dropped, line queue full */
+static lvds_parse_stats_t parse_stats;  /* line counters of all links */
 static uint32_t total_usb_bytes = 0;
 static uint32_t max_fill        = 0;
+static uint32_t ring_overruns   = 0;  /* times the DMA lapped the parser */
+static uint32_t key_frames      = 0;  /* keyframes sent in delta mode */
+static uint32_t delta_frames    = 0;  /* delta frames sent */
+static uint32_t delta_rows      = 0;  /* changed rows sent in deltas */
+static uint32_t comp_frames     = 0;  /* frames sent compressed */
+static uint32_t comp_in_bytes   = 0;  /* pixel bytes before compression */
+static uint32_t comp_out_bytes  = 0;  /* ... and after */
+static uint32_t stats_frames    = 0;  /* frame statistics packets sent */
+
+/* CRC policy: false = count only, true = drop lines with bad CRC */
+static volatile bool crc_reject = false;
+
+/* Frame pacing: 0/1 = adaptive (send whenever the sender is free),
+ * n > 1 = fixed 1-in-n decimation. */
+static volatile uint8_t pace_div = 0;
+
+/* Link measurement, updated by the sender core every PACE_WINDOW_US */
+#define PACE_WINDOW_US  500000
+static uint64_t pace_t0        = 0;
+static uint32_t pace_bytes0    = 0;
+static uint32_t pace_frames0   = 0;
+static uint32_t link_bytes_ps  = 0;   /* measured USB drain rate (B/s) */
+static uint32_t link_fps_x10   = 0;   /* achieved output FPS x 10 */
+
+/* USB transmit, see 'X' above.  Counters are kept by tud_vendor_tx_cb()
+ * for every completed bulk IN transfer. */
+#define USB_PKT_SIZE        64        /* FS bulk wMaxPacketSize */
+#define USB_EP_IN           0x81      /* EPNUM_VENDOR_IN */
+#define USB_FS_PKTS_PER_MS  19        /* bulk packets per 1 ms frame, at best */
+enum { USB_TX_FLUSH = 0, USB_TX_PACKED = 1 };
+static uint8_t  usb_tx_mode    = USB_TX_PACKED;
+static uint32_t usb_xfers      = 0;   /* bulk IN transfers completed */
+static uint32_t usb_packets    = 0;   /* packets in them */
+static uint32_t usb_zlps       = 0;   /* zero-length packets among those */
+static uint32_t usb_bus_pm     = 0;   /* packets / FS bulk ceiling, per mille */
+static uint32_t pace_packets0  = 0;
+
+/* Telemetry.  Latency histograms are cumulative log2-microsecond
+ * buckets: [0] = 0 us, [b] = [2^(b-1), 2^b) us, the last one catches
+ * everything from 1 ms up.  Core 1 fills hist_parse while core 0 reads
+ * it, so nothing is ever reset; the host diffs successive packets. */
+#define HIST_BUCKETS    12
+typedef struct { uint32_t n[HIST_BUCKETS]; } lat_hist_t;
+static lat_hist_t hist_parse;         /* parser passes that did work */
+static lat_hist_t hist_send;          /* send_frame_chunk() calls */
+static lat_hist_t hist_usb;           /* tud_task() calls */
+
+static inline void hist_add(lat_hist_t *h, uint32_t us)
+{
+    uint32_t b = us ? 32u - (uint32_t)__builtin_clz(us) : 0;
+    h->n[b < HIST_BUCKETS ? b : HIST_BUCKETS - 1]++;
+}
+
+#define TELEM_VERSION   1
+#define TELEM_HDR_SIZE  6             /* FE EC ver rsvd len16 */
+#define TELEM_COUNTERS  20
+#define TELEM_EXT_COUNTERS 9          /* appended after the histograms */
+#define TELEM_BODY_SIZE (16 + TELEM_COUNTERS * 4 + 4 + 3 * HIST_BUCKETS * 4 + \
+                         TELEM_EXT_COUNTERS * 4)
+#define TELEM_PKT_SIZE  (TELEM_HDR_SIZE + TELEM_BODY_SIZE)
+#define TELEM_MAX_HZ    100
+static uint32_t telem_period_us = 0;  /* 0 = periodic telemetry off */
+static uint64_t telem_next_us   = 0;
+static bool     telem_due       = false;
+static bool     status_req      = false;  /* 'S' text line pending */
+
+/* Scheduling.  Each stage runs only when it has work; a core with
+ * nothing to do sleeps in WFE until an interrupt (USB, timer alarm) or
+ * an SEV from the other core.  Budgets are time slices: the parser
+ * turns its slice into bytes from its own measured cost per byte. */
+#if LVDS_DUAL_CORE
+#define PARSE_SLICE_US       1000  /* core 1: bounds pause latency only */
+#else
+#define PARSE_SLICE_US       200   /* tud_task() runs at least this often */
+#endif
+#define SEND_SLICE_US        200
+#define PARSE_WAKES_PER_LINE 4     /* idle parser polls per line time */
+#define IDLE_MAX_US          1000  /* no sleep is longer than this */
+static uint32_t parse_ps_per_byte = 20000;  /* measured, 1/8 EMA */
+static uint32_t parse_idle_us     = 50;     /* set from the protocol */
+#if LVDS_DUAL_CORE
+static int      parse_alarm       = -1;     /* core 1 wake-up timer */
+#endif
 
 static uint32_t last_led_time   = 0;
 static bool     led_state       = false;
 
+/* Synthetic line generator (core 0).  Frames are built a few lines per
+ * main loop pass into one buffer while the DMA sends the other. */
+#define GEN_PIO            pio1
+#define GEN_SM             0
+#define GEN_GAP_BYTES      4            /* 0x00 idle bytes after each line */
+#define GEN_BUF_SIZE       (MAX_LVDS_ROWS * (MAX_LINE_BYTES + GEN_GAP_BYTES))
+#define GEN_ROWS_PER_STEP  8
+
+typedef enum { GEN_SCROLL = 0, GEN_BAR = 1 } gen_pattern_t;
+
+static uint8_t  gen_fps       = 0;      /* 0 = generator off */
+static uint8_t  gen_pattern   = GEN_SCROLL;
+static uint8_t  gen_errors    = 0;      /* bad-CRC lines per 1000 */
+static uint8_t  gen_bufs[2][GEN_BUF_SIZE];
+static int      gen_fill_buf  = 0;      /* buffer being generated */
+static int      gen_fill_row  = 0;      /* next line to generate */
+static uint32_t gen_len;                /* bytes per generated frame */
+static uint32_t gen_period_us;
+static uint64_t gen_next_us;
+static uint32_t gen_seq;                /* number of the frame being generated */
+static uint32_t gen_rng       = 1;
+static int      gen_dma_chan  = -1;
+static const pio_program_t *gen_prog = NULL;
+static uint     gen_prog_off;
+static uint32_t gen_frames    = 0;      /* frames sent by the generator */
+static uint32_t gen_late      = 0;      /* ... started over a period late */
+
+/* Core 1 pause handshake (mode switches and counter resets only, never data path) */
+static volatile bool core1_pause_req = false;
+static volatile bool core1_paused    = false;
+
 /* ----------------------------------------------------------------- */
 /*  Forward declarations                                              */
 /* ----------------------------------------------------------------- */
 
-static void start_pio(protocol_mode_t mode);
+static void start_pio(void);
 static void stop_pio(void);
 static void start_dma(void);
 static void stop_dma(void);
-static void restart_capture(protocol_mode_t mode);
+static void switch_proto(const lvds_proto_t *np, protocol_mode_t mode);
 static void reset_frame_state(void);
 static void process_host_commands(void);
-static void parse_ring_data(void);
-static void handle_complete_line(void);
-static void emit_assembled_frame(void);
+static bool parse_ring_data(void);
+static uint8_t *emit_assembled_frame(lvds_parser_t *p);
+static void frame_window(const frame_desc_t *d, frame_window_t *win);
+static uint16_t window_missing(const frame_desc_t *d, const frame_window_t *win,
+                               uint8_t missing[MISSING_BM_BYTES]);
+static const lvds_parser_ops_t link_parser_ops;
 static void send_frame_chunk(void);
 static void update_led(void);
-static inline uint32_t get_dma_wr(void);
+static void update_pacing(void);
+static void update_telemetry(void);
+static void gen_start(void);
+static void gen_stop(void);
+static void gen_step(void);
+static void detect_step(void);
+static void core0_idle_wait(bool parse_more);
+static inline uint32_t get_dma_wr(const lvds_link_t *l);
+static uint32_t get_ring_wr_pos(const lvds_link_t *l);
+static void line_dma_init(void);
+static void line_dma_configure(void);
+static void line_dma_finish(void);
+static void parser_pause(void);
+static void parser_resume(void);
+#if LVDS_DUAL_CORE
+static void core1_main(void);
+#endif
 
 /* ----------------------------------------------------------------- */
-/*  CRC-16/CCITT-FALSE  (poly 0x1021, init 0xFFFF, no reflection)    */
+/*  Lock-free SPSC frame queue                                        */
 /* ----------------------------------------------------------------- */
 
-static uint16_t crc16_table[256];
+static void fq_reset(frame_queue_t *q)
+{
+    q->head = 0;
+    q->tail = 0;
+}
+
+static bool fq_push(frame_queue_t *q, const frame_desc_t *d)
+{
+    uint32_t h = q->head;
+    if (h - q->tail >= FRAME_Q_LEN) return false;
+    q->slot[h & (FRAME_Q_LEN - 1)] = *d;
+    __dmb();                 /* slot (and frame pixels) visible before head */
+    q->head = h + 1;
+    __sev();                 /* wake the consumer core */
+    return true;
+}
 
-static void init_crc16_table(void)
+static inline uint32_t fq_depth(const frame_queue_t *q)
 {
-    for (int i = 0; i < 256; i++) {
-        uint16_t crc = (uint16_t)(i << 8);
-        for (int j = 0; j < 8; j++) {
-            if (crc & 0x8000) crc = (crc << 1) ^ 0x1021;
-            else              crc <<= 1;
-        }
-        crc16_table[i] = crc;
-    }
+    return q->head - q->tail;
 }
 
-static uint16_t crc16_ccitt(const uint8_t *data, int len)
+static bool fq_pop(frame_queue_t *q, frame_desc_t *d)
 {
-    uint16_t crc = 0xFFFF;
-    for (int i = 0; i < len; i++) {
-        uint8_t idx = (crc >> 8) ^ data[i];
-        crc = (crc << 8) ^ crc16_table[idx];
-    }
-    return crc;
+    uint32_t t = q->tail;
+    if (t == q->head) return false;
+    __dmb();                 /* read slot only after observing head */
+    *d = q->slot[t & (FRAME_Q_LEN - 1)];
+    __dmb();                 /* slot consumed before releasing it */
+    q->tail = t + 1;
+    return true;
+}
+
+static void fq_release_buffer(uint8_t *fb)
+{
+    frame_desc_t d = { .fb = fb };
+    fq_push(&free_q, &d);
 }
 
 /* ================================================================= */
@@ -202,21 +722,41 @@ int main(void)
     gpio_init(LED_PIN);
     gpio_set_dir(LED_PIN, GPIO_OUT);
     tusb_init();
-    init_crc16_table();
+    lvds_crc_init();
+    active_proto = PROTO_NICHIA;
+    line_dma_init();
+    for (int i = 0; i < LVDS_LINKS; i++)
+        lvds_parser_init(&links[i].parser, &link_parser_ops, &parse_stats,
+                         links[i].ring_buf, proto, frame_pool[i]);
 
-    start_pio(MODE_NICHIA);
+    reset_frame_state();
+    start_pio();
     start_dma();
 
+#if LVDS_DUAL_CORE
+    multicore_launch_core1(core1_main);
+#endif
+
     while (1)
     {
+        bool parse_more = false;
+        uint32_t t0 = time_us_32();
         tud_task();
+        uint32_t t1 = time_us_32();
+        hist_add(&hist_usb, t1 - t0);
         process_host_commands();
-        parse_ring_data();
+#if !LVDS_DUAL_CORE
+        parse_more = parse_ring_data();
+        t1 = time_us_32();
+#endif
         send_frame_chunk();
+        hist_add(&hist_send, time_us_32() - t1);
+        update_pacing();
+        update_telemetry();
+        gen_step();
+        detect_step();
         update_led();
-
-        if (dma_channel_hw_addr(dma_chan)->transfer_count == 0)
-            dma_channel_set_trans_count(dma_chan, 0x0FFFFFFF, true);
+        core0_idle_wait(parse_more);
     }
     return 0;
 }
@@ -225,322 +765,1734 @@ int main(void)
 /*  Line Parser + Frame Assembler                                     */
 /* ================================================================= */
 
-static void parse_ring_data(void)
+#if LVDS_DUAL_CORE
+static void parse_alarm_fired(uint alarm_num)
+{
+    (void)alarm_num;
+    __sev();        /* sets the event register even if WFE has not started */
+}
+
+/* Core 1: parser + assembler only.  No USB calls from this core. */
+static void core1_main(void)
 {
-    uint32_t wr = get_dma_wr();
-    uint32_t rd = ring_rd;
-    int budget = 16384;
-    int tick = 0;
+    /* Claimed here so the alarm IRQ is taken on core 1 */
+    parse_alarm = hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback(parse_alarm, parse_alarm_fired);
 
-    while (rd != wr && budget-- > 0)
+    while (1)
     {
-        uint8_t b = ring_buf[rd];
-        rd = (rd + 1) & RING_MASK;
-
-        switch (ps)
-        {
-        case SCAN_SYNC:
-            /* Cold scan: byte-by-byte search for 0x5D.
-             * Only used at startup or after total loss of alignment. */
-            if (b == SYNC_BYTE) {
-                line_data[0] = b;
-                line_pos = 1;
-                ps = READ_LINE;
-                frame_locked = false;
-            }
-            break;
+        if (core1_pause_req) {
+            core1_paused = true;
+            while (core1_pause_req) __wfe();
+            core1_paused = false;
+        }
+        if (!parse_ring_data()) {
+            /* Caught up: sleep until part of the next line has arrived */
+            if (!hardware_alarm_set_target(parse_alarm, make_timeout_time_us(parse_idle_us)))
+                __wfe();
+        }
+    }
+}
+#endif
 
-        case SCAN_GAP:
-            /* After a valid line, scan through inter-line gap/idle bytes
-             * looking for the next 0x5D.  Gap bytes are typically 0x00
-             * (LVDS idle), so there is no risk of false 0x5D matches.
-             * This handles protocols with variable inter-line padding. */
-            if (b == SYNC_BYTE) {
-                line_data[0] = b;
-                line_pos = 1;
-                ps = READ_LINE;
-            } else {
-                gap_bytes_total++;
-                gap_budget--;
-                if (gap_budget <= 0) {
-                    gap_resyncs++;
-                    frame_locked = false;
-                    ps = SCAN_SYNC;
-                }
-            }
-            break;
+/* Stop the parser at a line-safe point before core 0 touches its state.
+ * Single-core build: the parser is not running while we are here. */
+static void parser_pause(void)
+{
+#if LVDS_DUAL_CORE
+    core1_pause_req = true;
+    __sev();
+    while (!core1_paused) tight_loop_contents();
+#endif
+}
 
-        case READ_LINE:
-            line_data[line_pos++] = b;
-
-            /* Early reject: invalid row after masking */
-            if (line_pos == 2) {
-                int rowChk = extract_row(b);
-                if (rowChk >= proto->lvds_height) {
-                    if (frame_locked) {
-                        /* Aligned but row byte is bad - scan gap for next sync */
-                        gap_budget = MAX_GAP_BYTES + proto->line_size;
-                        ps = SCAN_GAP;
-                    } else {
-                        /* From cold SCAN_SYNC - false sync on pixel 0x5D */
-                        if (b == SYNC_BYTE) {
-                            line_data[0] = b;
-                            line_pos = 1;
-                        } else {
-                            ps = SCAN_SYNC;
-                            line_pos = 0;
-                        }
-                    }
-                    break;
-                }
-            }
+static void parser_resume(void)
+{
+#if LVDS_DUAL_CORE
+    core1_pause_req = false;
+    __sev();
+#endif
+}
 
-            if (line_pos >= proto->line_size) {
-                handle_complete_line();
-                frame_locked = true;
-                line_pos = 0;
-                gap_budget = MAX_GAP_BYTES;
-                ps = SCAN_GAP;
-            }
-            break;
-        }
+/* Per-link pass budget: PARSE_SLICE_US, shared by the links, at the
+ * measured cost per byte */
+static int parse_budget(void)
+{
+    uint32_t b = (uint32_t)((uint64_t)PARSE_SLICE_US * 1000000u / parse_ps_per_byte) / LVDS_LINKS;
+    if (b < proto->line_size) b = proto->line_size;
+    if (b > RING_SIZE / 2)    b = RING_SIZE / 2;
+    return (int)b;
+}
 
-        if ((++tick & 0x1FF) == 0) {
-        tud_task();
-        }
+/* One parser pass over one link.  Returns true if unparsed bytes are left. */
+static bool parse_link(lvds_link_t *l)
+{
+    lvds_parser_t *p = &l->parser;
+    uint32_t wpos = get_ring_wr_pos(l);
+    uint32_t lag = (wpos - l->ring_rd_pos) & RING_POS_MASK;
+    /* Lap count read just before the control channel stepped it */
+    if (lag > RING_POS_MASK - RING_SIZE)
+        lag = (lag + RING_SIZE) & RING_POS_MASK;
+    if (lag == 0) return false;
+
+    if (lag >= RING_SIZE) {
+        /* Unread bytes were overwritten: restart at the write pointer */
+        ring_overruns++;
+        max_fill = RING_SIZE;
+        l->ring_rd_pos = (l->ring_rd_pos + lag) & RING_POS_MASK;
+        lvds_parser_resync(p, wpos);
+        return false;
+    }
+    if (lag > max_fill) max_fill = lag;
+
+    uint32_t wr = wpos & RING_MASK;
+    uint64_t t0 = time_us_64();
+    uint32_t used = lvds_parser_feed(p, wr, t0, parse_budget());
+    uint32_t us = (uint32_t)(time_us_64() - t0);
+    l->ring_rd_pos = (l->ring_rd_pos + used) & RING_POS_MASK;
+    hist_add(&hist_parse, us);
+
+    /* Short passes are dominated by the fixed overhead; skip them */
+    if (used >= 1024) {
+        int32_t cost = (int32_t)((uint64_t)us * 1000000u / used);
+        parse_ps_per_byte += (cost - (int32_t)parse_ps_per_byte) / 8;
+        if (parse_ps_per_byte == 0) parse_ps_per_byte = 1;
     }
+    return p->ring_rd != wr;
+}
 
-    uint32_t fill = (wr >= rd) ? (wr - rd) : (RING_SIZE - rd + wr);
-    if (fill > max_fill) max_fill = fill;
-    ring_rd = rd;
+/* One parser pass over every link.  Returns true if any has bytes left. */
+static bool parse_ring_data(void)
+{
+    bool more = false;
+    for (int i = 0; i < LVDS_LINKS; i++)
+        more |= parse_link(&links[i]);
+    return more;
 }
 
-static void handle_complete_line(void)
+/* ----------------------------------------------------------------- */
+/*  Raw line passthrough                                              */
+/* ----------------------------------------------------------------- */
+
+static inline void put_le16(uint8_t *p, uint32_t v)
 {
-    /* Extract row address (Nichia: mask off parity bit) */
-    int row = extract_row(line_data[1]);
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+}
 
-    /* CRC diagnostic only (algorithm does not match Nichia device) */
-    uint16_t crc_exp = ((uint16_t)line_data[proto->line_size - 2] << 8)
-                     | line_data[proto->line_size - 1];
-    uint16_t crc_got = crc16_ccitt(line_data + 2, proto->width);
+static inline void put_le32(uint8_t *p, uint32_t v)
+{
+    put_le16(p, v);
+    put_le16(p + 2, v >> 16);
+}
 
-    if (crc_got != crc_exp)
-        crc_errors++;
-    else
-        crc_ok_lines++;
+static inline void put_le64(uint8_t *p, uint64_t v)
+{
+    put_le32(p, (uint32_t)v);
+    put_le32(p + 4, (uint32_t)(v >> 32));
+}
 
-    /* Frame boundary: row decreased -> new frame */
-    if (row <= prev_row && prev_row >= 0 && lines_placed > 0)
-        emit_assembled_frame();
 
-    /* Row-sequence validation: within a frame, rows should increase
-     * by exactly 1 each line (0, 1, 2, ..., 67).  A line from a
-     * false 0x5D match in gap data will have a random row number.
-     * Only place pixels when row matches the expected sequence.
-     * Frame start (prev_row == -1) always accepted. */
-    prev_row = row;
+static void line_q_put(uint32_t at, const uint8_t *src, uint32_t n)
+{
+    uint32_t off = at & LINE_Q_MASK;
+    uint32_t first = (n < LINE_Q_SIZE - off) ? n : LINE_Q_SIZE - off;
+    memcpy(line_q + off, src, first);
+    memcpy(line_q, src + first, n - first);
+}
 
-    if (row < proto->lvds_height) {
-        if (row < proto->active_height) {
-            if (!line_placed[row]) {
-                memcpy(asm_fb + (row * proto->width), line_data + 2, proto->width);
-                line_placed[row] = true;
-                lines_placed++;
-            }
-        }
+/* Queue one line of link `l` as a record, from its ring at `ring_off`
+ * (from_ring) or from its parser's line_data.  Dropped if the row is
+ * filtered out or the queue is full. */
+static void line_rec_add(const lvds_link_t *l, int row, bool from_ring, uint32_t ring_off,
+                         bool crc_match)
+{
+    if (row < line_row_lo || row > line_row_hi) return;
+
+    uint32_t len = proto->line_size;
+    uint32_t h = line_q_head;
+    if (LINE_Q_SIZE - (h - line_q_tail) < LINE_REC_HDR_SIZE + len) {
+        line_rec_drops++;
+        return;
+    }
+
+    uint8_t hdr[LINE_REC_HDR_SIZE] = {
+        FRAME_MAGIC_0, LINE_REC_MAGIC_1, (uint8_t)((l->id << 4) | (crc_match ? 1 : 0)),
+        len & 0xFF, len >> 8
+    };
+    line_q_put(h, hdr, LINE_REC_HDR_SIZE);
+    if (from_ring) {
+        uint32_t first = (len < RING_SIZE - ring_off) ? len : RING_SIZE - ring_off;
+        line_q_put(h + LINE_REC_HDR_SIZE, l->ring_buf + ring_off, first);
+        line_q_put(h + LINE_REC_HDR_SIZE + first, l->ring_buf, len - first);
     } else {
-        // row invalid -> probable false sync / corruption
-        row_seq_skip++;
+        line_q_put(h + LINE_REC_HDR_SIZE, l->parser.line_data, len);
     }
+    __dmb();                 /* record bytes visible before head */
+    line_q_head = h + LINE_REC_HDR_SIZE + len;
+    line_recs++;
+    __sev();
+}
 
+static void link_line_seen(lvds_parser_t *p, int row, bool from_ring, uint32_t ring_off,
+                           bool crc_ok)
+{
+    if (line_mode)
+        line_rec_add((const lvds_link_t *)p, row, from_ring, ring_off, crc_ok);
 }
 
-static void emit_assembled_frame(void)
+/* ----------------------------------------------------------------- */
+/*  Row streaming                                                     */
+/* ----------------------------------------------------------------- */
+
+/* Queue a row-mode record of link `l`; dropped if the queue is full */
+static bool row_rec_put(const lvds_link_t *l, uint8_t type, uint32_t index,
+                        uint32_t frame_id, const uint8_t *body, uint32_t len)
 {
-    static uint32_t decim = 0;
-    if (++decim & 1) return; 
+    uint32_t h = line_q_head;
+    if (LINE_Q_SIZE - (h - line_q_tail) < ROW_REC_HDR_SIZE + len) {
+        line_rec_drops++;
+        return false;
+    }
 
-    fw_frame_id++;
+    uint8_t hdr[ROW_REC_HDR_SIZE];
+    hdr[0] = FRAME_MAGIC_0;
+    hdr[1] = ROW_REC_MAGIC_1;
+    hdr[2] = type;
+    hdr[3] = l->id;
+    put_le32(hdr + 4, frame_id);
+    put_le16(hdr + 8, index);
+    put_le16(hdr + 10, len);
+    line_q_put(h, hdr, ROW_REC_HDR_SIZE);
+    line_q_put(h + ROW_REC_HDR_SIZE, body, len);
+    __dmb();                 /* record bytes visible before head */
+    line_q_head = h + ROW_REC_HDR_SIZE + len;
+    line_recs++;
+    __sev();
+    return true;
+}
 
-    if (send_fb == NULL) {
-        /* Swap buffers and start sending */
-        send_fb = asm_fb;
-        send_offset = 0;
-        uint16_t w = proto->width;
-        uint16_t h = proto->active_height;
-        send_total = FRAME_HDR_SIZE + (uint32_t)w * h;
+/* Close the frame in progress on link `l`: lines placed, missing rows
+ * and window, in the same layout as the v2/v3 extended header fields */
+static void row_rec_end(lvds_link_t *l)
+{
+    lvds_parser_t *p = &l->parser;
+    const frame_window_t *win = &l->row_win;
+    frame_desc_t d = { p->asm_fb, ++l->frame_id, proto->width, proto->active_height,
+                       p->frame_sof_us, 0, { 0 }, l->id };
+    d.lines = lvds_parser_finish_frame(p, d.missing);
+
+    uint8_t b[ROW_REC_END_SIZE];
+    put_le64(b, d.sof_us);
+    put_le16(b + 8, win->w);
+    put_le16(b + 10, win->rows);
+    put_le16(b + 12, window_missing(&d, win, b + 16));
+    b[14] = (uint8_t)((win->rows + 7) / 8);
+    b[15] = 0;
+    put_le16(b + 28, win->x);
+    put_le16(b + 30, win->y);
+    put_le16(b + 32, d.width);
+    put_le16(b + 34, d.height);
+    b[36] = win->step;
+    b[37] = 0;
+    b[38] = 0;
+    b[39] = 0;
+    row_rec_put(l, ROW_REC_END, win->rows, d.frame_id, b, ROW_REC_END_SIZE);
+    l->row_ended = true;
+    frames_sent++;
+}
 
-        send_hdr[0] = FRAME_MAGIC_0;
-        send_hdr[1] = FRAME_MAGIC_1;
-        send_hdr[2] = fw_frame_id & 0xFF;
-        send_hdr[3] = (fw_frame_id >> 8) & 0xFF;
-        send_hdr[4] = w & 0xFF;
-        send_hdr[5] = (w >> 8) & 0xFF;
-        send_hdr[6] = h & 0xFF;
-        send_hdr[7] = (h >> 8) & 0xFF;
-
-        frames_sent++;
-        asm_fb = (asm_fb == fb_a) ? fb_b : fb_a;
+/* ops->row_placed: in row mode every placed row inside the window goes
+ * out at once, and the frame ends with its last active row rather than
+ * with the next frame's first line. */
+static void link_row_placed(lvds_parser_t *p, int row)
+{
+    if (!row_mode) return;
+    lvds_link_t *l = (lvds_link_t *)p;
+
+    /* The window is fixed for a frame when its first row lands (step 0:
+     * row mode came on mid-frame) */
+    if (p->lines_placed == 1 || l->row_win.step == 0) {
+        frame_desc_t d = { p->asm_fb, 0, proto->width, proto->active_height, 0, 0, { 0 }, l->id };
+        frame_window(&d, &l->row_win);
+        l->row_ended = false;
+    }
+
+    const frame_window_t *win = &l->row_win;
+    uint32_t dy = (uint32_t)row - win->y;
+    if (row >= win->y && dy % win->step == 0 && dy / win->step < win->rows)
+        row_rec_put(l, ROW_REC_ROW, dy / win->step, l->frame_id + 1,
+                    p->asm_fb + row * proto->width + win->x, win->w);
+
+    if (row == proto->active_height - 1)
+        row_rec_end(l);
+}
+
+/* ----------------------------------------------------------------- */
+/*  Line mover: memory-to-memory DMA, sniffer computes the CRC        */
+/* ----------------------------------------------------------------- */
+
+/* At most one line is in flight, from any link.  Its CRC and placement
+ * are settled by line_dma_finish() before the next line is started or
+ * handled, so the copy overlaps with scanning the following gap instead
+ * of costing CPU.  The read side uses the same RING_BITS wrap as the
+ * capture channels, so lines that straddle the end of a ring need no
+ * special case. */
+static int      line_dma_chan = -1;
+static bool     line_dma_busy = false;
+static lvds_link_t *pending_link;
+static uint8_t  line_sink[MAX_LINE_BYTES];   /* target for rows not placed */
+
+static void line_dma_init(void)
+{
+    if (line_dma_chan < 0)
+        line_dma_chan = dma_claim_unused_channel(true);
+    line_dma_configure();
+}
+
+/* Select the sniffer CRC for the current protocol */
+static void line_dma_configure(void)
+{
+    dma_channel_config c = dma_channel_get_default_config(line_dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, false, RING_BITS);   /* wrap reads in the ring */
+    channel_config_set_sniff_enable(&c, true);
+    dma_channel_configure(line_dma_chan, &c, line_sink, links[0].ring_buf, 0, false);
+
+    if (proto->crc_type == LVDS_CRC16) {
+        /* CRC-16/CCITT-FALSE: MSB-first, no reflection, no xorout */
+        dma_sniffer_set_output_reverse_enabled(false);
+        dma_sniffer_set_output_invert_enabled(false);
+        dma_sniffer_enable(line_dma_chan, DMA_SNIFF_CTRL_CALC_VALUE_CRC16, true);
     } else {
+        /* CRC-32/ISO-HDLC: reflected input (CRC32R), reflected output,
+         * final xor 0xFFFFFFFF */
+        dma_sniffer_set_output_reverse_enabled(true);
+        dma_sniffer_set_output_invert_enabled(true);
+        dma_sniffer_enable(line_dma_chan, DMA_SNIFF_CTRL_CALC_VALUE_CRC32R, true);
+    }
+    line_dma_busy = false;
+}
+
+/* ops->line_move: pixels go straight from the ring into their asm_fb
+ * row; lines that are not placed go to line_sink so the CRC is still
+ * counted. */
+static void line_dma_start(lvds_parser_t *p, uint8_t *dst, uint32_t pix_off, uint32_t len)
+{
+    pending_link = (lvds_link_t *)p;
+    dma_sniffer_set_data_accumulator(
+        proto->crc_type == LVDS_CRC16 ? 0xFFFFu : 0xFFFFFFFFu);
+    dma_channel_set_read_addr(line_dma_chan, pending_link->ring_buf + pix_off, false);
+    dma_channel_set_write_addr(line_dma_chan, dst ? dst : line_sink, false);
+    dma_channel_set_trans_count(line_dma_chan, len, true);
+    line_dma_busy = true;
+}
+
+static void line_dma_finish(void)
+{
+    if (!line_dma_busy) return;
+    dma_channel_wait_for_finish_blocking(line_dma_chan);
+    line_dma_busy = false;
+
+    uint32_t crc_got = dma_sniffer_get_data_accumulator();
+    if (proto->crc_type == LVDS_CRC16) crc_got &= 0xFFFF;
+    lvds_parser_line_moved(&pending_link->parser, crc_got);
+}
+
+/* ----------------------------------------------------------------- */
+/*  Frame hand-off                                                    */
+/* ----------------------------------------------------------------- */
+
+/* ops->frame_done: returns the buffer to assemble the next frame into */
+static uint8_t *emit_assembled_frame(lvds_parser_t *p)
+{
+    lvds_link_t *l = (lvds_link_t *)p;
+
+    /* Line mode: lines go out as records; keep tracking frame boundaries only */
+    if (line_mode)
+        return p->asm_fb;
+
+    /* Row mode: rows are already out, only the end record may be due */
+    if (row_mode) {
+        if (!l->row_ended)
+            row_rec_end(l);
+        l->row_ended = false;
+        return p->asm_fb;
+    }
+
+    uint8_t div = pace_div;
+    if (div > 1 && (++l->decim % div) != 0) {
+        /* Fixed decimation: skip this frame */
+        frames_dropped++;
+        return p->asm_fb;
+    }
+
+    frame_desc_t spare;
+    if (!fq_pop(&free_q, &spare)) {
         frames_dropped++;
+        return p->asm_fb;
     }
 
-    /* Clear the new assembly buffer */
-    memset(line_placed, 0, proto->lvds_height * sizeof(bool));
-    memset(asm_fb, 0, (uint32_t)proto->width * proto->active_height);
-    lines_placed = 0;
+    /* Only frames handed to the sender are numbered, so a gap on the
+     * host means packets were lost on the way (and so a delta base) */
+    l->frame_id++;
+
+    /* Hand the finished buffer to the sender, keep assembling into the spare */
+    frame_desc_t d = { p->asm_fb, l->frame_id, proto->width, proto->active_height,
+                       p->frame_sof_us, 0, { 0 }, l->id };
+    d.lines = lvds_parser_finish_frame(p, d.missing);
+
+    /* Row checksums for 'H': CRC of each placed row, 0 = missing */
+    uint32_t *crc = frame_row_crc[(p->asm_fb - frame_pool[0]) / MAX_FRAME_BYTES];
+    for (int r = 0; r < proto->active_height; r++)
+        crc[r] = p->line_placed[r] ? p->row_crc[r] : 0;
+
+    fq_push(&ready_q, &d);
+    frames_sent++;
+
+    uint32_t depth = fq_depth(&ready_q);
+    if (depth > queue_hwm) queue_hwm = depth;
+    return spare.fb;
 }
 
+static const lvds_parser_ops_t link_parser_ops = {
+    .frame_done  = emit_assembled_frame,
+    .line_move   = line_dma_start,
+    .line_settle = line_dma_finish,
+    .line_seen   = link_line_seen,
+    .row_placed  = link_row_placed,
+};
+
 /* ================================================================= */
 /*  USB Frame Sender (non-blocking)                                   */
 /* ================================================================= */
 
+/* Append a byte range to the packet; adjacent ranges are merged so a
+ * run of changed rows goes out as one write. */
+static void send_add_seg(const uint8_t *ptr, uint32_t len)
+{
+    if (len == 0) return;
+    if (send_nseg > 0) {
+        send_seg_t *last = &send_seg[send_nseg - 1];
+        if (last->ptr + last->len == ptr) {
+            last->len += len;
+            return;
+        }
+    }
+    if (send_nseg >= SEND_MAX_SEGS) return;   /* cannot happen; never write past send_seg[] */
+    send_seg[send_nseg].ptr = ptr;
+    send_seg[send_nseg].len = len;
+    send_nseg++;
+}
+
+static void delta_refs_invalidate(void)
+{
+    for (int i = 0; i < LVDS_LINKS; i++)
+        delta_ref[i].valid = false;
+}
+
+/* Clamp the ROI request to frame `d` */
+static void frame_window(const frame_desc_t *d, frame_window_t *win)
+{
+    uint32_t x = roi_x < d->width ? roi_x : d->width - 1u;
+    uint32_t y = roi_y < d->height ? roi_y : d->height - 1u;
+    uint32_t w = d->width - x, h = d->height - y;
+    if (roi_w && roi_w < w) w = roi_w;
+    if (roi_h && roi_h < h) h = roi_h;
+
+    win->x = (uint16_t)x;
+    win->y = (uint16_t)y;
+    win->w = (uint16_t)w;
+    win->step = roi_step > 1 ? roi_step : 1;
+    win->rows = (uint16_t)((h + win->step - 1) / win->step);
+    win->pitch = d->width * win->step;
+    win->first = d->fb + y * d->width + x;
+    win->full = (w == d->width && h == d->height && win->step == 1);
+}
+
+/* Lines placed / missing bitmap of the rows inside the window */
+static uint16_t window_missing(const frame_desc_t *d, const frame_window_t *win,
+                               uint8_t missing[MISSING_BM_BYTES])
+{
+    if (win->full) {
+        memcpy(missing, d->missing, MISSING_BM_BYTES);
+        return d->lines;
+    }
+    uint16_t lines = 0;
+    memset(missing, 0, MISSING_BM_BYTES);
+    for (uint32_t r = 0; r < win->rows; r++) {
+        uint32_t src = win->y + r * win->step;
+        if (d->missing[src >> 3] & (1u << (src & 7)))
+            missing[r >> 3] |= (uint8_t)(1u << (r & 7));
+        else
+            lines++;
+    }
+    return lines;
+}
+
+/* ----------------------------------------------------------------- */
+/*  Frame statistics                                                  */
+/* ----------------------------------------------------------------- */
+
+/* Start the stats packet of frame `d` if 'H' is on.  Its size is known
+ * up front, so it goes in as the first segment and stats_step() fills
+ * it in before anything is written. */
+static void stats_prepare(const frame_desc_t *d, const frame_window_t *win)
+{
+    uint8_t flags = stats_flags;
+    stats_busy = false;
+    stats_len = 0;
+    if (!flags) return;
+
+    uint32_t body = STATS_FIXED_SIZE;
+    if (flags & STATS_FLAG_ROWS) body += win->rows * STATS_ROW_SIZE;
+    if (flags & STATS_FLAG_HIST) body += STATS_HIST_BINS * 2;
+
+    stats_pkt[0] = FRAME_MAGIC_0;
+    stats_pkt[1] = STATS_MAGIC_1;
+    stats_pkt[2] = STATS_VERSION;
+    stats_pkt[3] = d->channel;
+    put_le16(stats_pkt + 4, body);
+    uint8_t *b = stats_pkt + STATS_HDR_SIZE;
+    put_le32(b, d->frame_id);
+    put_le16(b + 4, win->w);
+    put_le16(b + 6, win->rows);
+    b[8] = flags;
+    b[9] = 0;
+    b[10] = 0;
+    b[11] = 0;
+
+    stats_win = *win;
+    stats_crc = frame_row_crc[(d->fb - frame_pool[0]) / MAX_FRAME_BYTES];
+    stats_row = 0;
+    memset(stats_hist, 0, sizeof(stats_hist));
+    stats_len = STATS_HDR_SIZE + body;
+    stats_busy = true;
+    send_add_seg(stats_pkt, stats_len);
+}
+
+/* One bounded slice of statistics work (~STATS_ROW_BUDGET pixels) */
+static void stats_step(void)
+{
+    const frame_window_t *win = &stats_win;
+    uint8_t flags = stats_pkt[STATS_HDR_SIZE + 8];
+    uint8_t *rec = stats_pkt + STATS_HDR_SIZE + STATS_FIXED_SIZE;
+    uint32_t budget = 0;
+
+    for (; stats_row < win->rows && budget < STATS_ROW_BUDGET; stats_row++) {
+        const uint8_t *row = win->first + stats_row * win->pitch;
+        uint32_t lo = 255, hi = 0, sum = 0;
+        for (uint32_t x = 0; x < win->w; x++) {
+            uint32_t v = row[x];
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+            sum += v;
+            stats_hist[v]++;
+        }
+        budget += win->w;
+
+        if (flags & STATS_FLAG_ROWS) {
+            uint8_t *e = rec + stats_row * STATS_ROW_SIZE;
+            put_le32(e, stats_crc[win->y + stats_row * win->step]);
+            e[4] = (uint8_t)lo;
+            e[5] = (uint8_t)hi;
+            e[6] = (uint8_t)((sum + win->w / 2) / win->w);
+            e[7] = 0;
+        }
+    }
+    if (stats_row < win->rows) return;
+
+    if (flags & STATS_FLAG_HIST) {
+        uint8_t *h = rec + ((flags & STATS_FLAG_ROWS) ? win->rows * STATS_ROW_SIZE : 0);
+        for (int i = 0; i < STATS_HIST_BINS; i++)
+            put_le16(h + 2 * i, stats_hist[i]);
+    }
+    stats_busy = false;
+    stats_frames++;
+}
+
+/* Build the segment list for one frame (legacy, keyframe or delta) */
+static void prepare_frame_packet(const frame_desc_t *d)
+{
+    frame_window_t win;
+    frame_window(d, &win);
+    uint32_t w = win.w, h = win.rows;
+    uint32_t pix_total = w * h;
+
+    send_nseg = 0;
+    send_cur = 0;
+    send_seg_off = 0;
+
+    comp_phase = COMP_IDLE;
+    stats_prepare(d, &win);
+
+    /* The legacy header has no channel or window fields: single-link
+     * builds sending whole frames only */
+    if (LVDS_LINKS == 1 && !delta_enabled && comp_mode == COMP_OFF && win.full) {
+        send_hdr[0] = FRAME_MAGIC_0;
+        send_hdr[1] = FRAME_MAGIC_1;
+        put_le16(send_hdr + 2, d->frame_id);
+        put_le16(send_hdr + 4, w);
+        put_le16(send_hdr + 6, h);
+        send_add_seg(send_hdr, FRAME_HDR_SIZE);
+        send_add_seg(d->fb, pix_total);
+        return;
+    }
+
+    delta_ref_t *ref = &delta_ref[d->channel];
+    if (delta_enabled && keyframe_req) {
+        keyframe_req = false;
+        delta_refs_invalidate();
+    }
+    bool key = !delta_enabled || !ref->valid
+            || ref->w != w || ref->h != h || ref->since_key >= KEYFRAME_INTERVAL;
+    uint8_t  flags;
+    uint32_t payload;
+
+    send_add_seg(send_hdr, EXT_HDR_SIZE);
+
+    if (!delta_enabled) {
+        flags = EXT_FLAG_KEY;
+        payload = pix_total;
+        /* Rows of a full-width window merge into one segment */
+        for (uint32_t r = 0; r < h; r++)
+            send_add_seg(win.first + r * win.pitch, w);
+    } else if (key) {
+        for (uint32_t r = 0; r < h; r++) {
+            memcpy(ref->fb + r * w, win.first + r * win.pitch, w);
+            send_add_seg(win.first + r * win.pitch, w);
+        }
+        ref->valid = true;
+        ref->w = w;
+        ref->h = h;
+        ref->since_key = 0;
+        key_frames++;
+
+        flags = EXT_FLAG_KEY;
+        payload = pix_total;
+    } else {
+        uint32_t bm_len = (h + 7) / 8;
+        memset(delta_bitmap, 0, bm_len);
+        send_add_seg(delta_bitmap, bm_len);
+        payload = bm_len;
+
+        for (uint32_t r = 0; r < h; r++) {
+            const uint8_t *row = win.first + r * win.pitch;
+            uint8_t *ref_row = ref->fb + r * w;
+            if (memcmp(row, ref_row, w) != 0) {
+                delta_bitmap[r >> 3] |= (uint8_t)(1u << (r & 7));
+                memcpy(ref_row, row, w);
+                send_add_seg(row, w);
+                payload += w;
+                delta_rows++;
+            }
+        }
+        ref->since_key++;
+        delta_frames++;
+        flags = EXT_FLAG_DELTA;
+    }
+
+    send_hdr[0] = FRAME_MAGIC_0;
+    send_hdr[1] = EXT_MAGIC_1;
+    send_hdr[2] = EXT_HDR_VERSION;
+    send_hdr[3] = EXT_HDR_SIZE;
+    send_hdr[4] = flags;
+    send_hdr[5] = d->channel;
+    put_le16(send_hdr + 6, d->frame_id);
+    put_le16(send_hdr + 8, w);
+    put_le16(send_hdr + 10, h);
+    put_le32(send_hdr + 12, payload);
+    put_le32(send_hdr + 16, d->frame_id);
+    put_le64(send_hdr + 20, d->sof_us);
+    put_le16(send_hdr + 28, window_missing(d, &win, send_hdr + 32));
+    send_hdr[30] = (uint8_t)((h + 7) / 8);
+    send_hdr[31] = 0;
+    put_le16(send_hdr + 44, win.x);
+    put_le16(send_hdr + 46, win.y);
+    put_le16(send_hdr + 48, d->width);
+    put_le16(send_hdr + 50, d->height);
+    send_hdr[52] = win.step;
+    send_hdr[53] = 0;
+    send_hdr[54] = 0;
+    send_hdr[55] = 0;
+
+    if (comp_mode != COMP_OFF) {
+        comp_src = win.first;
+        comp_pitch = win.pitch;
+        comp_w = w;
+        comp_h = h;
+        comp_delta = (flags == EXT_FLAG_DELTA);
+        comp_raw_len = comp_delta ? payload - (h + 7) / 8 : payload;
+        comp_row = 0;
+        comp_len = 0;
+        if (comp_raw_len == 0) {
+            comp_phase = COMP_IDLE;
+        } else if (comp_mode == COMP_RLE) {
+            comp_flags = EXT_FLAG_RLE;
+            comp_phase = COMP_PACK;
+        } else {
+            memset(comp_used, 0, sizeof(comp_used));
+            comp_levels = 0;
+            comp_phase = COMP_SCAN;
+        }
+    }
+}
+
+/* ----------------------------------------------------------------- */
+/*  Payload compression                                               */
+/* ----------------------------------------------------------------- */
+
+/* PackBits: runs of >= 3 equal bytes become [257-n][byte], the rest
+ * goes out as literal blocks [n-1][n bytes] (n <= 128). */
+static uint32_t rle_encode(const uint8_t *src, uint32_t n, uint8_t *dst)
+{
+    uint32_t i = 0, o = 0;
+    while (i < n) {
+        uint32_t run = 1;
+        while (i + run < n && run < 128 && src[i + run] == src[i]) run++;
+        if (run >= 3) {
+            dst[o++] = (uint8_t)(257 - run);
+            dst[o++] = src[i];
+            i += run;
+            continue;
+        }
+        uint32_t start = i, lit = 0;
+        while (i < n && lit < 128) {
+            if (i + 2 < n && src[i] == src[i + 1] && src[i] == src[i + 2]) break;
+            i++;
+            lit++;
+        }
+        dst[o++] = (uint8_t)(lit - 1);
+        memcpy(dst + o, src + start, lit);
+        o += lit;
+    }
+    return o;
+}
+
+static inline bool comp_row_selected(uint32_t r)
+{
+    return !comp_delta || (delta_bitmap[r >> 3] & (1u << (r & 7)));
+}
+
+/* Compression finished: swap the raw pixel segments for comp_buf if it
+ * is smaller, otherwise leave the raw packet as prepared. */
+static void comp_finish(bool ok)
+{
+    comp_phase = COMP_IDLE;
+    if (!ok || comp_len >= comp_raw_len) return;
+
+    uint32_t bm_len = comp_delta ? (comp_h + 7u) / 8u : 0;
+    send_nseg = 0;
+    send_add_seg(stats_pkt, stats_len);
+    send_add_seg(send_hdr, EXT_HDR_SIZE);
+    if (bm_len) send_add_seg(delta_bitmap, bm_len);
+    send_add_seg(comp_buf, comp_len);
+
+    send_hdr[4] |= comp_flags;
+    put_le32(send_hdr + 12, bm_len + comp_len);
+
+    comp_frames++;
+    comp_in_bytes += comp_raw_len;
+    comp_out_bytes += comp_len;
+}
+
+/* One bounded slice of compression work (~COMP_ROW_BUDGET input bytes) */
+static void compress_step(void)
+{
+    uint32_t budget = 0;
+
+    if (comp_phase == COMP_SCAN) {
+        for (; comp_row < comp_h && budget < COMP_ROW_BUDGET; comp_row++) {
+            if (!comp_row_selected(comp_row)) continue;
+            const uint8_t *row = comp_src + comp_row * comp_pitch;
+            for (uint32_t x = 0; x < comp_w; x++) {
+                uint32_t v = row[x];
+                if (!(comp_used[v >> 5] & (1u << (v & 31)))) {
+                    comp_used[v >> 5] |= 1u << (v & 31);
+                    if (++comp_levels > NIB4_PALETTE) break;
+                }
+            }
+            budget += comp_w;
+            if (comp_levels > NIB4_PALETTE) {
+                if (comp_mode == COMP_NIB4) { comp_finish(false); return; }
+                comp_flags = EXT_FLAG_RLE;
+                comp_row = 0;
+                comp_phase = COMP_PACK;
+                return;
+            }
+        }
+        if (comp_row < comp_h) return;
+
+        /* Palette = used levels in ascending order */
+        uint32_t idx = 0;
+        memset(comp_buf, 0, NIB4_PALETTE);
+        for (uint32_t v = 0; v < 256; v++) {
+            if (comp_used[v >> 5] & (1u << (v & 31))) {
+                comp_lut[v] = (uint8_t)idx;
+                comp_buf[idx++] = (uint8_t)v;
+            }
+        }
+        comp_len = NIB4_PALETTE;
+        comp_flags = (comp_mode == COMP_AUTO) ? (EXT_FLAG_NIB4 | EXT_FLAG_RLE) : EXT_FLAG_NIB4;
+        comp_row = 0;
+        comp_phase = COMP_PACK;
+        return;
+    }
+
+    /* COMP_PACK */
+    uint8_t packed[(MAX_LINE_WIDTH + 1) / 2];
+    for (; comp_row < comp_h && budget < COMP_ROW_BUDGET; comp_row++) {
+        if (!comp_row_selected(comp_row)) continue;
+        const uint8_t *row = comp_src + comp_row * comp_pitch;
+        const uint8_t *src = row;
+        uint32_t n = comp_w;
+
+        if (comp_flags & EXT_FLAG_NIB4) {
+            for (uint32_t x = 0; x < comp_w; x += 2) {
+                uint8_t hi = comp_lut[row[x]];
+                uint8_t lo = (x + 1 < comp_w) ? comp_lut[row[x + 1]] : 0;
+                packed[x >> 1] = (uint8_t)((hi << 4) | lo);
+            }
+            src = packed;
+            n = (comp_w + 1) / 2;
+        }
+        if (comp_flags & EXT_FLAG_RLE)
+            comp_len += rle_encode(src, n, comp_buf + comp_len);
+        else {
+            memcpy(comp_buf + comp_len, src, n);
+            comp_len += n;
+        }
+        budget += comp_w;
+
+        /* Not paying off: send raw (also bounds comp_buf use) */
+        if (comp_len >= comp_raw_len) { comp_finish(false); return; }
+    }
+    if (comp_row >= comp_h) comp_finish(true);
+}
+
+/* Abandon the frame in flight.  In delta mode the host's copy is now
+ * unknown, so the next frame must be a keyframe. */
+static void abort_send(void)
+{
+    if (send_fb) {
+        fq_release_buffer(send_fb);
+        send_fb = NULL;
+    }
+    send_nseg = 0;
+    send_cur = 0;
+    send_seg_off = 0;
+    comp_phase = COMP_IDLE;
+    stats_busy = false;
+    stats_len = 0;
+    delta_refs_invalidate();
+}
+
+/* Line mode: stream the line record queue.  Records are contiguous in
+ * the byte stream, so no framing is needed on this side. */
+static void send_line_records(void)
+{
+    if (!tud_connected()) { line_q_tail = line_q_head; return; }
+
+    bool progressed = false;
+    uint32_t t0 = time_us_32();
+    while (time_us_32() - t0 < SEND_SLICE_US)
+    {
+        uint32_t avail = tud_vendor_write_available();
+        if (avail < USB_PKT_SIZE) break;
+
+        uint32_t t = line_q_tail;
+        uint32_t n = line_q_head - t;
+        if (n == 0) break;
+        __dmb();             /* read records only after observing head */
+
+        uint32_t off = t & LINE_Q_MASK;
+        if (n > LINE_Q_SIZE - off) n = LINE_Q_SIZE - off;
+        if (n > avail) n = avail;
+        uint32_t w = tud_vendor_write(line_q + off, n);
+        if (w == 0) break;
+        __dmb();             /* bytes consumed before releasing them */
+        line_q_tail = t + w;
+        total_usb_bytes += w;
+        progressed = true;
+    }
+    if (progressed) tud_vendor_write_flush();
+}
+
+/* Return every queued frame to the pool without sending it */
+static void drop_queued_frames(void)
+{
+    frame_desc_t d;
+    abort_send();
+    while (fq_pop(&ready_q, &d))
+        fq_release_buffer(d.fb);
+}
+
+/* [FE][EC][ver][0][len16] + mode, counters, latency histograms, then
+ * counters added later (older hosts ignore the extra bytes).
+ * Layout is mirrored by LvdsFirmwareTelemetry on the host. */
+static const uint32_t *const telem_counters[TELEM_COUNTERS] = {
+    &frames_sent, &frames_dropped, &parse_stats.crc_ok_lines, &parse_stats.crc_errors,
+    &parse_stats.row_seq_skip, &parse_stats.gap_bytes_total, &parse_stats.gap_resyncs, &max_fill,
+    &total_usb_bytes, &link_bytes_ps, &link_fps_x10, &queue_hwm,
+    &key_frames, &delta_frames, &delta_rows, &comp_frames,
+    &comp_in_bytes, &comp_out_bytes, &line_recs, &line_rec_drops,
+};
+
+static void build_telemetry(uint8_t *pkt)
+{
+    const lat_hist_t *hists[3] = { &hist_parse, &hist_send, &hist_usb };
+    uint8_t *p = pkt + TELEM_HDR_SIZE;
+
+    pkt[0] = 0xFE;
+    pkt[1] = 0xEC;
+    pkt[2] = TELEM_VERSION;
+    pkt[3] = 0;
+    put_le16(pkt + 4, TELEM_BODY_SIZE);
+
+    put_le64(p, time_us_64());
+    p[8]  = (uint8_t)current_mode;
+    p[9]  = (uint8_t)((crc_reject ? 0x01 : 0) | (delta_enabled ? 0x02 : 0) |
+                      (line_mode ? 0x04 : 0) | (tud_connected() ? 0x08 : 0) |
+                      (LVDS_LINKS > 1 ? 0x10 : 0) | (gen_fps ? 0x20 : 0) |
+                      (usb_tx_mode == USB_TX_PACKED ? 0x40 : 0) |
+                      (stats_flags ? 0x80 : 0));
+    p[10] = comp_mode;
+    p[11] = pace_div;
+    put_le32(p + 12, proto->baud);
+    p += 16;
+
+    for (int i = 0; i < TELEM_COUNTERS; i++, p += 4)
+        put_le32(p, *telem_counters[i]);
+
+    p[0] = HIST_BUCKETS; p[1] = 0; p[2] = 0; p[3] = 0;
+    p += 4;
+    for (int h = 0; h < 3; h++)
+        for (int i = 0; i < HIST_BUCKETS; i++, p += 4)
+            put_le32(p, hists[h]->n[i]);
+
+    put_le32(p, ring_overruns);
+    put_le32(p + 4, parse_ps_per_byte);
+    put_le32(p + 8, gen_frames);
+    put_le32(p + 12, gen_late);
+    put_le32(p + 16, usb_xfers);
+    put_le32(p + 20, usb_packets);
+    put_le32(p + 24, usb_zlps);
+    put_le32(p + 28, usb_bus_pm);
+    put_le32(p + 32, stats_frames);
+}
+
+static int format_status(char *buf, size_t size)
+{
+    return snprintf(buf, size,
+        "MODE=%s BAUD=%u FMT=%ux%u/%u:%s:%02X DETECT=%s:%u:%u PROTO_REJ=%u CRC=%s PACE=%u FPS=%u.%u LINK=%uKB/s USB=%u SENT=%u DROP=%u QUEUE=%u/%u LINES=%s%u/%u KEY=%u DELTA=%u/%u COMP=%u:%u/%u/%u CRC_OK=%u CRC_ERR=%u ROW_SKIP=%u GAP=%u RESYNC=%u MAXFILL=%u/%u OVERRUN=%u LINKS=%u GEN=%u:%u/%u USBTX=%s:%u/%u/%u BUS=%u.%u%% ROI=%u,%u,%ux%u/%u STATS=%u:%u\n",
+        current_mode == MODE_NICHIA ? "NICHIA" : current_mode == MODE_OSRAM ? "OSRAM" : "CUSTOM",
+        proto->baud,
+        proto->width, proto->active_height, proto->lvds_height,
+        proto->crc_type == LVDS_CRC16 ? "CRC16" : "CRC32", proto->sync_byte,
+        detect_names[detect_result], detect_baud, detect_lines, proto_rejects,
+        crc_reject ? "REJECT" : "COUNT",
+        pace_div > 1 ? pace_div : 0,
+        link_fps_x10 / 10, link_fps_x10 % 10, link_bytes_ps / 1024,
+        total_usb_bytes, frames_sent, frames_dropped,
+        queue_hwm, FRAME_POOL_SIZE - 1,
+        line_mode ? "ON:" : row_mode ? "ROW:" : "", line_recs, line_rec_drops,
+        key_frames, delta_frames, delta_rows,
+        comp_mode, comp_frames, comp_out_bytes, comp_in_bytes,
+        parse_stats.crc_ok_lines, parse_stats.crc_errors, parse_stats.row_seq_skip,
+        parse_stats.gap_bytes_total, parse_stats.gap_resyncs,
+        max_fill, RING_SIZE, ring_overruns, LVDS_LINKS,
+        gen_fps, gen_frames, gen_late,
+        usb_tx_mode == USB_TX_PACKED ? "PACKED" : "FLUSH",
+        usb_xfers, usb_packets, usb_zlps, usb_bus_pm / 10, usb_bus_pm % 10,
+        roi_x, roi_y, roi_w, roi_h, roi_step > 1 ? roi_step : 1,
+        stats_flags, stats_frames);
+}
+
+/* Emit pending status text / telemetry.  Only called between packets;
+ * each one goes out whole or waits for FIFO room, so the host parser
+ * never sees it interleaved with frame bytes.  Returns true once
+ * nothing is pending. */
+static bool send_status_packets(void)
+{
+    if (!tud_connected()) { status_req = false; telem_due = false; return true; }
+
+    if (status_req) {
+        char status[640];
+        int len = format_status(status, sizeof(status));
+        if (len >= (int)sizeof(status)) len = sizeof(status) - 1;
+        if (tud_vendor_write_available() < (uint32_t)len) return false;
+        tud_vendor_write(status, len);
+        total_usb_bytes += len;
+        status_req = false;
+    }
+    if (telem_due) {
+        uint8_t pkt[TELEM_PKT_SIZE];
+        if (tud_vendor_write_available() < TELEM_PKT_SIZE) return false;
+        build_telemetry(pkt);
+        tud_vendor_write(pkt, TELEM_PKT_SIZE);
+        total_usb_bytes += TELEM_PKT_SIZE;
+        telem_due = false;
+    }
+    tud_vendor_write_flush();
+    return true;
+}
+
+/* Queue up to `max` bytes of the current segment.  At the end of the
+ * packet flushes and releases the frame (send_fb becomes NULL). */
+static uint32_t send_packet_bytes(uint32_t max)
+{
+    const send_seg_t *sg = &send_seg[send_cur];
+    uint32_t rem = sg->len - send_seg_off;
+    uint32_t w = tud_vendor_write(sg->ptr + send_seg_off, max < rem ? max : rem);
+    send_seg_off += w;
+    total_usb_bytes += w;
+
+    if (send_seg_off >= sg->len) {
+        send_cur++;
+        send_seg_off = 0;
+    }
+    if (send_cur >= send_nseg) {
+        // flush o singură dată pe frame complet
+        tud_vendor_write_flush();
+        fq_release_buffer(send_fb);
+        send_fb = NULL;
+    }
+    return w;
+}
+
 static void send_frame_chunk(void)
 {
-    if (send_fb == NULL) return;
-    if (!tud_connected()) { send_fb = NULL; return; }
+    /* Line records are only whole once the queue has drained */
+    if (send_fb == NULL && (status_req || telem_due) &&
+        (!(line_mode || row_mode) || line_q_tail == line_q_head))
+    {
+        if (!send_status_packets()) return;
+    }
+
+    if (send_fb == NULL && (line_mode || row_mode)) {
+        send_line_records();
+        return;
+    }
+
+    if (send_fb == NULL) {
+        frame_desc_t d;
+        if (!fq_pop(&ready_q, &d)) return;
+        if (!tud_connected()) { fq_release_buffer(d.fb); delta_refs_invalidate(); return; }
+
+        send_fb = d.fb;
+        prepare_frame_packet(&d);
+    }
+    if (!tud_connected()) { abort_send(); return; }
+
+    if (stats_busy) {
+        stats_step();
+        return;
+    }
+    if (comp_phase != COMP_IDLE) {
+        compress_step();
+        return;
+    }
 
     bool progressed = false;
+    uint32_t t0 = time_us_32();
 
-    for (int pass = 0; pass < 16; pass++)
+    while (time_us_32() - t0 < SEND_SLICE_US)
     {
         uint32_t avail = tud_vendor_write_available();
-        if (avail < 64) break; // sub un packet, nu forța
+        if (avail < USB_PKT_SIZE) break; // sub un packet, nu forța
 
-        if (send_offset < FRAME_HDR_SIZE) {
-            uint32_t rem = FRAME_HDR_SIZE - send_offset;
-            uint32_t chunk = (avail < rem) ? avail : rem;
-            uint32_t w = tud_vendor_write(send_hdr + send_offset, chunk);
-            if (w == 0) break;
-            send_offset += w;
-            total_usb_bytes += w;
-            progressed = true;
-            avail -= w;
-            if (w < chunk || avail < 64) break;
-        }
+        uint32_t w = send_packet_bytes(avail);
+        if (w == 0) break;
+        progressed = true;
+        if (send_fb == NULL) return;
+    }
 
-        uint32_t pix_off   = send_offset - FRAME_HDR_SIZE;
-        uint32_t pix_total = (uint32_t)proto->width * proto->active_height;
-        if (pix_off < pix_total) {
-            uint32_t rem = pix_total - pix_off;
-            uint32_t chunk = (avail < rem) ? avail : rem;
-            uint32_t w = tud_vendor_write(send_fb + pix_off, chunk);
+    if (usb_tx_mode == USB_TX_PACKED) {
+        /* Stop on a packet boundary.  Whatever the stack takes from the
+         * FIFO before the frame's end-of-packet flush is then made of
+         * full packets; the FIFO has room for the rest of the packet
+         * since its size is a multiple of USB_PKT_SIZE. */
+        uint32_t part = (CFG_TUD_VENDOR_TX_BUFSIZE - tud_vendor_write_available()) % USB_PKT_SIZE;
+        while (part != 0 && send_fb != NULL) {
+            uint32_t w = send_packet_bytes(USB_PKT_SIZE - part);
             if (w == 0) break;
-            send_offset += w;
-            total_usb_bytes += w;
-            progressed = true;
-            if (w < chunk) break;
-        }
-
-        if (send_offset >= send_total) {
-            // flush o singură dată pe frame complet
-            tud_vendor_write_flush();
-            send_fb = NULL;
-            return;
+            part = (part + w) % USB_PKT_SIZE;
         }
+    } else if (progressed) {
+        // flush doar dacă am scris ceva
+        tud_vendor_write_flush();
     }
+}
 
-    // flush doar dacă am scris ceva
-    if (progressed) tud_vendor_write_flush();
+/* Measure what the link actually drains.  Only bytes accepted by
+ * tud_vendor_write() count, so when the host stops reading (FIFO full)
+ * the measured rate falls accordingly. */
+static void update_pacing(void)
+{
+    uint64_t now = time_us_64();
+    uint64_t dt  = now - pace_t0;
+    if (dt < PACE_WINDOW_US) return;
+
+    uint32_t bytes  = total_usb_bytes;
+    uint32_t frames = frames_sent;
+    link_bytes_ps = (uint32_t)(((uint64_t)(bytes - pace_bytes0) * 1000000u) / dt);
+    link_fps_x10  = (uint32_t)(((uint64_t)(frames - pace_frames0) * 10000000u) / dt);
+    usb_bus_pm    = (uint32_t)(((uint64_t)(usb_packets - pace_packets0) * 1000000u) /
+                               (dt * USB_FS_PKTS_PER_MS));
+
+    pace_t0       = now;
+    pace_bytes0   = bytes;
+    pace_frames0  = frames;
+    pace_packets0 = usb_packets;
+}
+
+static void update_telemetry(void)
+{
+    if (telem_period_us == 0) return;
+    uint64_t now = time_us_64();
+    if (now < telem_next_us) return;
+    telem_due = true;
+    telem_next_us += telem_period_us;
+    if (telem_next_us <= now) telem_next_us = now + telem_period_us;
+}
+
+/* True if send_frame_chunk() can make progress now.  Waiting for FIFO
+ * room needs no polling: the USB IRQ that frees it also ends WFE. */
+static bool sender_has_work(void)
+{
+    bool pending = status_req || telem_due || fq_depth(&ready_q) > 0 ||
+                   ((line_mode || row_mode) && line_q_tail != line_q_head);
+    if (!tud_connected()) return pending;   /* sender drops it all */
+    if (send_fb != NULL && (stats_busy || comp_phase != COMP_IDLE)) return true;
+    return (send_fb != NULL || pending) && tud_vendor_write_available() >= USB_PKT_SIZE;
 }
 
+/* Sleep until an interrupt, an SEV from core 1 or the next timed job.
+ * A wake-up lost to a race costs at most IDLE_MAX_US. */
+static void core0_idle_wait(bool parse_more)
+{
+    if (parse_more || tud_task_event_ready() || tud_vendor_available() ||
+        sender_has_work() || detect_state != DETECT_IDLE)
+        return;
+
+    uint64_t now = time_us_64();
+#if LVDS_DUAL_CORE
+    uint64_t wake = now + IDLE_MAX_US;
+#else
+    uint64_t wake = now + parse_idle_us;     /* parser runs in this loop */
+#endif
+    if (pace_t0 + PACE_WINDOW_US < wake) wake = pace_t0 + PACE_WINDOW_US;
+    if (telem_period_us && telem_next_us < wake) wake = telem_next_us;
+    if (gen_fps) {
+        if (gen_fill_row < proto->lvds_height) return;   /* frame still being built */
+        uint64_t g = gen_next_us;
+        if (dma_channel_is_busy(gen_dma_chan)) {
+            /* Not before the frame on the wire has gone out */
+            uint64_t done = now + (uint64_t)dma_channel_hw_addr(gen_dma_chan)->transfer_count *
+                                  proto->bits_per_byte * 1000000u / proto->baud;
+            if (done > g) g = done;
+        }
+        if (g < wake) wake = g;
+    }
+    if (wake > now)
+        best_effort_wfe_or_timeout(from_us_since_boot(wake));
+}
 
 /* ================================================================= */
-/*  DMA: byte-width from PIO FIFO byte 3                             */
+/*  DMA: PIO RX FIFO -> capture ring (self-rearming)                 */
 /* ================================================================= */
 
-static void start_dma(void)
+/* dma_chan fills the ring once per transfer and chains to ring_ctrl_chan,
+ * which writes the next ring_reload[] entry to dma_chan's count-and-
+ * trigger alias.  The ring keeps filling with no CPU involvement. */
+static void start_link_dma(lvds_link_t *l)
 {
-    if (dma_chan < 0)
-        dma_chan = dma_claim_unused_channel(true);
+    if (l->dma_chan < 0)
+        l->dma_chan = dma_claim_unused_channel(true);
+    if (l->ring_ctrl_chan < 0)
+        l->ring_ctrl_chan = dma_claim_unused_channel(true);
 
-    dma_channel_config c = dma_channel_get_default_config(dma_chan);
-    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    dma_channel_config c = dma_channel_get_default_config(l->dma_chan);
     channel_config_set_read_increment(&c, false);
     channel_config_set_write_increment(&c, true);
-    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, false));
+    channel_config_set_dreq(&c, pio_get_dreq(pio, l->sm, false));
     channel_config_set_ring(&c, true, RING_BITS);
 
-    memset(ring_buf, 0, sizeof(ring_buf));
-    ring_rd  = 0;
-    max_fill = 0;
+    channel_config_set_chain_to(&c, l->ring_ctrl_chan);
 
-    const volatile uint8_t *pio_rxf_byte3 =
-        (const volatile uint8_t *)&pio->rxf[sm] + 3;
+    memset(l->ring_buf, 0, RING_SIZE);
+    l->parser.ring_rd = 0;
+    l->ring_rd_pos = 0;
 
-    dma_channel_configure(dma_chan, &c,
-        ring_buf, pio_rxf_byte3,
-        0x0FFFFFFF, true);
+#if LVDS_PACKED_FIFO
+    /* Whole FIFO words: the write pointer advances 4 bytes at a time */
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    const volatile void *src = &pio->rxf[l->sm];
+    const uint32_t lap_count = RING_SIZE / 4;
+#else
+    /* Shift-right ISR: the received byte is in bits 31:24 */
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    const volatile void *src = (const volatile uint8_t *)&pio->rxf[l->sm] + 3;
+    const uint32_t lap_count = RING_SIZE;
+#endif
+
+    for (uint32_t i = 0; i < RING_LAPS; i++)
+        l->ring_reload[i] = lap_count;
+
+    dma_channel_config cc = dma_channel_get_default_config(l->ring_ctrl_chan);
+    channel_config_set_transfer_data_size(&cc, DMA_SIZE_32);
+    channel_config_set_read_increment(&cc, true);
+    channel_config_set_write_increment(&cc, false);
+    channel_config_set_ring(&cc, false, RING_LAP_BITS + 2);
+    dma_channel_configure(l->ring_ctrl_chan, &cc,
+        &dma_hw->ch[l->dma_chan].al1_transfer_count_trig, l->ring_reload,
+        1, false);
+
+    dma_channel_configure(l->dma_chan, &c,
+        l->ring_buf, src,
+        lap_count, true);
+}
+
+static void start_dma(void)
+{
+    max_fill = 0;
+    for (int i = 0; i < LVDS_LINKS; i++)
+        start_link_dma(&links[i]);
 }
 
 static void stop_dma(void)
 {
-    if (dma_chan >= 0)
-        dma_channel_abort(dma_chan);
+    for (int i = 0; i < LVDS_LINKS; i++) {
+        lvds_link_t *l = &links[i];
+        /* Control channel first so it cannot re-trigger the data channel */
+        if (l->ring_ctrl_chan >= 0)
+            dma_channel_abort(l->ring_ctrl_chan);
+        if (l->dma_chan >= 0)
+            dma_channel_abort(l->dma_chan);
+        if (l->ring_ctrl_chan >= 0)
+            dma_channel_abort(l->ring_ctrl_chan);
+    }
+}
+
+static inline uint32_t get_dma_wr(const lvds_link_t *l)
+{
+    uint32_t wa = dma_channel_hw_addr(l->dma_chan)->write_addr;
+    return (wa - (uintptr_t)l->ring_buf) & RING_MASK;
 }
 
-static inline uint32_t get_dma_wr(void)
+/* Write position with lap count.  If dma_chan just wrapped and the
+ * control channel has not stepped yet, the result is one lap behind;
+ * the parser corrects that since it can never be ahead of the writer. */
+static uint32_t get_ring_wr_pos(const lvds_link_t *l)
 {
-    uint32_t wa = dma_channel_hw_addr(dma_chan)->write_addr;
-    return (wa - (uintptr_t)ring_buf) & RING_MASK;
+    const volatile uint32_t *lap_addr = &dma_channel_hw_addr(l->ring_ctrl_chan)->read_addr;
+    uint32_t la, wr;
+    do {
+        la = *lap_addr;
+        wr = get_dma_wr(l);
+    } while (*lap_addr != la);
+    uint32_t lap = ((la - (uintptr_t)l->ring_reload) / 4) & (RING_LAPS - 1);
+    return (lap << RING_BITS) | wr;
+}
+
+/* ================================================================= */
+/*  Synthetic line generator                                          */
+/* ================================================================= */
+
+static uint32_t gen_rand(void)
+{
+    uint32_t x = gen_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return gen_rng = x;
+}
+
+/* One line of frame gen_seq plus its idle gap, as the ECU sends it */
+static void gen_line(uint8_t *dst, int row)
+{
+    uint32_t w = proto->width;
+    uint8_t *pix = dst + 2;
+
+    dst[0] = proto->sync_byte;
+    /* Nichia: odd parity in bit 7 (row 0 = 0x80) */
+    dst[1] = (proto->row_mask == 0xFF) ? (uint8_t)row
+           : (uint8_t)(row | (__builtin_parity(row) ? 0 : 0x80));
+
+    if (gen_pattern == GEN_BAR) {
+        uint32_t bar = gen_seq % proto->active_height;
+        uint8_t v = ((uint32_t)row - bar < 4) ? 0xF0 : 0x10;
+        memset(pix, v, w);
+    } else {
+        for (uint32_t c = 0; c < w; c++)
+            pix[c] = (uint8_t)(c + row + gen_seq);
+    }
+    if (row == 0)
+        put_le32(pix, gen_seq);
+
+    uint8_t *crc = pix + w;
+    if (proto->crc_type == LVDS_CRC16) {
+        uint16_t v = lvds_crc16_ccitt(pix, w);
+        crc[0] = (uint8_t)(v >> 8);
+        crc[1] = (uint8_t)v;
+    } else {
+        put_le32(crc, lvds_crc32_iso_hdlc(pix, w));
+    }
+    if (gen_errors && gen_rand() % 1000 < gen_errors)
+        pix[gen_rand() % w] ^= (uint8_t)(1u << (gen_rand() % 8));
+
+    memset(crc + proto->crc_len, 0x00, GEN_GAP_BYTES);
+}
+
+/* Load the TX program for the current protocol and start at frame 0 */
+static void gen_start(void)
+{
+    if (gen_dma_chan < 0)
+        gen_dma_chan = dma_claim_unused_channel(true);
+
+    if (proto->parity == LVDS_PARITY_NONE) {
+        gen_prog = &uart_tx_8n1_program;
+        gen_prog_off = pio_add_program(GEN_PIO, gen_prog);
+        uart_tx_8n1_program_init(GEN_PIO, GEN_SM, gen_prog_off, GEN_TX_PIN, proto->baud);
+    } else {
+        gen_prog = &uart_tx_8n2_program;
+        gen_prog_off = pio_add_program(GEN_PIO, gen_prog);
+        uart_tx_8n2_program_init(GEN_PIO, GEN_SM, gen_prog_off, GEN_TX_PIN, proto->baud);
+    }
+
+    dma_channel_config c = dma_channel_get_default_config(gen_dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(GEN_PIO, GEN_SM, true));
+    dma_channel_configure(gen_dma_chan, &c, &GEN_PIO->txf[GEN_SM], gen_bufs[0], 0, false);
+
+    gen_len = proto->lvds_height * (proto->line_size + GEN_GAP_BYTES);
+    gen_period_us = 1000000u / gen_fps;
+    gen_next_us = time_us_64();
+    gen_fill_buf = 0;
+    gen_fill_row = 0;
+    gen_seq = 0;
+}
+
+static void gen_stop(void)
+{
+    if (gen_prog == NULL) return;
+    dma_channel_abort(gen_dma_chan);
+    pio_sm_set_enabled(GEN_PIO, GEN_SM, false);
+    /* Leave the line idle even if a byte was cut off */
+    pio_sm_set_pins_with_mask(GEN_PIO, GEN_SM, 1u << GEN_TX_PIN, 1u << GEN_TX_PIN);
+    pio_remove_program(GEN_PIO, gen_prog, gen_prog_off);
+    gen_prog = NULL;
+}
+
+/* Main loop: build the next frame a few lines at a time, send it when
+ * its slot comes up and the previous frame is out */
+static void gen_step(void)
+{
+    if (gen_fps == 0) return;
+
+    uint32_t stride = proto->line_size + GEN_GAP_BYTES;
+    uint8_t *buf = gen_bufs[gen_fill_buf];
+    for (int n = 0; n < GEN_ROWS_PER_STEP && gen_fill_row < proto->lvds_height; n++, gen_fill_row++)
+        gen_line(buf + gen_fill_row * stride, gen_fill_row);
+    if (gen_fill_row < proto->lvds_height) return;
+
+    if (dma_channel_is_busy(gen_dma_chan)) return;
+    uint64_t now = time_us_64();
+    if (now < gen_next_us) return;
+
+    dma_channel_transfer_from_buffer_now(gen_dma_chan, buf, gen_len);
+    gen_frames++;
+    if (now - gen_next_us > gen_period_us) {
+        /* Slot missed (frame rate above what the line carries) */
+        gen_late++;
+        gen_next_us = now;
+    }
+    gen_next_us += gen_period_us;
+    gen_fill_buf ^= 1;
+    gen_fill_row = 0;
+    gen_seq++;
 }
 
 /* ================================================================= */
 /*  PIO capture                                                       */
 /* ================================================================= */
 
-static void start_pio(protocol_mode_t mode)
+/* RX oversampling for `baud`: 8x while the PIO clock allows it, 4x up
+ * to clk_sys / 4, 0 = too fast to receive */
+static uint rx_oversampling(uint32_t baud)
 {
-    current_mode = mode;
-    if (mode == MODE_NICHIA) {
-        proto = &PROTO_NICHIA;
+    uint32_t clk = clock_get_hz(clk_sys);
+    if (baud == 0)           return 0;
+    if (baud <= clk / 8)     return 8;
+    if (baud <= clk / 4)     return 4;
+    return 0;
+}
+
+/* Timing derived from the line format */
+static void proto_timing_update(void)
+{
+    parse_idle_us = (uint32_t)((uint64_t)proto->line_size * proto->bits_per_byte *
+                               1000000u / proto->baud) / PARSE_WAKES_PER_LINE;
+    if (line_dma_chan >= 0)
+        line_dma_configure();
+}
+
+/* One program in instruction memory, one state machine per link; the
+ * program follows proto->baud */
+static void start_pio(void)
+{
+    rx_os = rx_oversampling(proto->baud);
+    if (rx_os == 8) {
+#if LVDS_PACKED_FIFO
+        uint off = pio_add_program(pio, &uart_rx_8x_packed_program);
+        for (int i = 0; i < LVDS_LINKS; i++)
+            uart_rx_8x_packed_program_init(pio, links[i].sm, off, links[i].pin, proto->baud);
+#else
         uint off = pio_add_program(pio, &uart_rx_8x_program);
-        uart_rx_8x_program_init(pio, sm, off, UART_RX_PIN, BAUD_NICHIA);
+        for (int i = 0; i < LVDS_LINKS; i++)
+            uart_rx_8x_program_init(pio, links[i].sm, off, links[i].pin, proto->baud);
+#endif
     } else {
-        proto = &PROTO_OSRAM;
+#if LVDS_PACKED_FIFO
+        uint off = pio_add_program(pio, &uart_rx_4x_packed_program);
+        for (int i = 0; i < LVDS_LINKS; i++)
+            uart_rx_4x_packed_program_init(pio, links[i].sm, off, links[i].pin, proto->baud);
+#else
         uint off = pio_add_program(pio, &uart_rx_4x_program);
-        uart_rx_4x_program_init(pio, sm, off, UART_RX_PIN, BAUD_OSRAM);
+        for (int i = 0; i < LVDS_LINKS; i++)
+            uart_rx_4x_program_init(pio, links[i].sm, off, links[i].pin, proto->baud);
+#endif
     }
+    for (int i = 0; i < LVDS_LINKS; i++)
+        links[i].parser.proto = proto;
+    proto_timing_update();
 }
 
 static void stop_pio(void)
 {
-    pio_sm_set_enabled(pio, sm, false);
+    for (int i = 0; i < LVDS_LINKS; i++)
+        pio_sm_set_enabled(pio, links[i].sm, false);
     pio_clear_instruction_memory(pio);
-    while (!pio_sm_is_rx_fifo_empty(pio, sm))
-        (void)pio_sm_get(pio, sm);
+    for (int i = 0; i < LVDS_LINKS; i++)
+        while (!pio_sm_is_rx_fifo_empty(pio, links[i].sm))
+            (void)pio_sm_get(pio, links[i].sm);
 }
 
-static void restart_capture(protocol_mode_t mode)
+/* Switch to line format `np` ('S' names it after `mode`).
+ *
+ * The ring DMA keeps running throughout, so nothing is re-armed or
+ * cleared: a new baud rate with the same oversampling is a clock
+ * divider change, a different oversampling reloads the RX program
+ * (a few instructions), and the parsers restart at the write pointer.
+ * Frame buffers keep their old pixels; rows a frame does not get are
+ * zeroed at hand-off as always.  Frames in flight are dropped and the
+ * next one is a keyframe. */
+static void switch_proto(const lvds_proto_t *np, protocol_mode_t mode)
 {
-    stop_dma();
-    stop_pio();
-    reset_frame_state();
-    start_pio(mode);
-    start_dma();
+    bool gen_on = gen_fps != 0;
+    parser_pause();
+    if (gen_on) gen_stop();
+    if (line_dma_busy) {
+        dma_channel_abort(line_dma_chan);
+        line_dma_busy = false;
+    }
+    drop_queued_frames();
+
+    uint32_t old_baud = proto->baud;
+    active_proto = *np;
+    current_mode = mode;
+    if (rx_oversampling(np->baud) != rx_os) {
+        stop_pio();
+        start_pio();
+    } else {
+        if (np->baud != old_baud) {
+            float div = (float)clock_get_hz(clk_sys) / ((float)np->baud * rx_os);
+            for (int i = 0; i < LVDS_LINKS; i++) {
+                pio_sm_set_clkdiv(pio, links[i].sm, div);
+                pio_sm_clkdiv_restart(pio, links[i].sm);
+            }
+        }
+        proto_timing_update();
+    }
+
+    for (int i = 0; i < LVDS_LINKS; i++) {
+        lvds_link_t *l = &links[i];
+        lvds_parser_reset(&l->parser, l->parser.asm_fb);
+        l->ring_rd_pos = get_ring_wr_pos(l);
+        lvds_parser_resync(&l->parser, l->ring_rd_pos);
+        l->row_win.step = 0;
+        l->row_ended = true;
+    }
+    line_q_head = 0;
+    line_q_tail = 0;
+    keyframe_req = true;
+    if (gen_on) gen_start();
+    parser_resume();
+}
+
+/* ================================================================= */
+/*  Protocol descriptors and auto-detection                           */
+/* ================================================================= */
+
+static inline uint32_t get_le16(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+/* Parse an uploaded descriptor into `pr`; false if it is not usable */
+static bool proto_from_desc(const uint8_t *a, lvds_proto_t *pr)
+{
+    pr->width         = (uint16_t)get_le16(a);
+    pr->active_height = (uint16_t)get_le16(a + 2);
+    pr->lvds_height   = (uint16_t)get_le16(a + 4);
+    pr->line_size     = (uint16_t)get_le16(a + 6);
+    pr->baud          = get_le16(a + 8) | (get_le16(a + 10) << 16);
+    pr->crc_type      = a[12] ? LVDS_CRC32 : LVDS_CRC16;
+    pr->crc_len       = pr->crc_type == LVDS_CRC16 ? 2 : 4;
+    pr->parity        = a[13];
+    pr->bits_per_byte = pr->parity == LVDS_PARITY_NONE ? 10 : 11;
+    pr->sync_byte     = a[14];
+    pr->row_mask      = a[15];
+    return a[12] <= LVDS_CRC32 && lvds_proto_valid(pr) && rx_oversampling(pr->baud) != 0;
+}
+
+/* Bit time on link 0 from the shortest of the detect_n pulses, in 1/16
+ * PIO cycles at clk_sys; 0 = no signal */
+static uint32_t detect_bit_x16(void)
+{
+    if (detect_n < DETECT_PULSES / 4) return 0;
+
+    /* Pulses up to 1.5 bit times are single bits; their mean resolves
+     * the bit time below the 2-cycle loop step, as edges fall at all
+     * phases of the PIO clock */
+    uint32_t sum = 0, cnt = 0;
+    for (uint32_t i = 0; i < detect_n; i++)
+        if (detect_pulses[i] * 2 < detect_min_cy * 3) {
+            sum += detect_pulses[i];
+            cnt++;
+        }
+    return sum * 16 / cnt;
+}
+
+static void detect_timer_stop(void)
+{
+    pio_sm_set_enabled(pio, DETECT_SM, false);
+    pio_remove_program(pio, &edge_timer_program, detect_prog_off);
+}
+
+/* A measured rate close to one of a known format is taken as that one */
+static uint32_t snap_baud(uint32_t measured, const lvds_proto_t *cand, int ncand)
+{
+    for (int i = 0; i < ncand; i++) {
+        uint32_t b = cand[i].baud;
+        if ((uint64_t)(measured > b ? measured - b : b - measured) * 100 <= (uint64_t)b * DETECT_SNAP_PCT)
+            return b;
+    }
+    return (measured + 5000) / 10000 * 10000;
+}
+
+static uint8_t *detect_frame_done(lvds_parser_t *p)
+{
+    return p->asm_fb;                           /* trial parse: keep nothing */
+}
+
+static const lvds_parser_ops_t detect_parser_ops = {
+    .frame_done = detect_frame_done,
+};
+
+/* CRC-valid lines of format `pr` in `len` ring bytes of link `l` from
+ * offset `start`.  Runs the parser with software CRC over link 0's
+ * own frame buffer, so only while the parser is paused. */
+static uint32_t detect_score(lvds_link_t *l, const lvds_proto_t *pr, uint32_t start, uint32_t len)
+{
+    static lvds_parser_t tp;
+    lvds_parse_stats_t st = { 0 };
+    lvds_parser_init(&tp, &detect_parser_ops, &st, l->ring_buf, pr, l->parser.asm_fb);
+    tp.crc_reject = true;
+    lvds_parser_resync(&tp, start);
+    uint32_t end = (start + len) & RING_MASK;
+    while (tp.ring_rd != end)
+        lvds_parser_feed(&tp, end, 0, RING_SIZE);
+    return st.crc_ok_lines;
+}
+
+/* 'A': measure the bit rate, capture at it, and keep the known format
+ * (built-ins, last upload) that parses the most valid lines.  Parity is
+ * not visible to the receiver and stays as the format defines it.  The
+ * previous format is restored if nothing fits.  detect_step() does the
+ * work; an 'A' while one is running is ignored. */
+static void auto_detect_begin(void)
+{
+    if (detect_state != DETECT_IDLE) return;
+
+    detect_prev = active_proto;
+    detect_prev_mode = current_mode;
+    detect_cand[0] = PROTO_NICHIA;
+    detect_cand[1] = PROTO_OSRAM;
+    detect_cand[2] = custom_proto;
+    detect_cand_mode[0] = MODE_NICHIA;
+    detect_cand_mode[1] = MODE_OSRAM;
+    detect_cand_mode[2] = MODE_CUSTOM;
+    detect_ncand = custom_valid ? 3 : 2;
+    detect_lines = 0;
+    detect_baud = 0;
+
+    /* Capture keeps running on its own state machine meanwhile */
+    detect_prog_off = pio_add_program(pio, &edge_timer_program);
+    edge_timer_program_init(pio, DETECT_SM, detect_prog_off, links[0].pin);
+    detect_n = 0;
+    detect_min_cy = UINT32_MAX;
+    detect_first = true;
+    detect_t0 = time_us_32();
+    detect_state = DETECT_MEASURE;
+}
+
+static void detect_finish(detect_result_t r)
+{
+    detect_result = r;
+    detect_state = DETECT_IDLE;
+    status_req = true;           /* report the result */
+}
+
+/* A protocol command overrides a detection in progress (and its PIO
+ * reload would take the edge timer program with it) */
+static void detect_cancel(void)
+{
+    if (detect_state == DETECT_MEASURE)
+        detect_timer_stop();
+    detect_state = DETECT_IDLE;
+}
+
+/* Main loop: drain the edge timer for up to DETECT_SLICE_US per pass,
+ * then wait for DETECT_BYTES at the measured rate, then score the
+ * candidates over them with the parser paused */
+static void detect_step(void)
+{
+    lvds_link_t *l = &links[0];
+
+    switch (detect_state) {
+    case DETECT_IDLE:
+        return;
+
+    case DETECT_MEASURE:
+    {
+        uint32_t t = time_us_32();
+        while (detect_n < DETECT_PULSES && time_us_32() - t < DETECT_SLICE_US) {
+            if (pio_sm_is_rx_fifo_empty(pio, DETECT_SM)) continue;
+            uint32_t passes = ~pio_sm_get(pio, DETECT_SM);
+            if (detect_first) { detect_first = false; continue; }
+            if (passes > UINT16_MAX / 4) continue;  /* idle between lines */
+            uint32_t cy = 2 * passes + EDGE_TIMER_FIXED_CY;
+            detect_pulses[detect_n++] = (uint16_t)cy;
+            if (cy < detect_min_cy) detect_min_cy = cy;
+        }
+        if (detect_n < DETECT_PULSES && time_us_32() - detect_t0 < DETECT_TIMEOUT_US)
+            return;
+        detect_timer_stop();
+
+        uint32_t bit_x16 = detect_bit_x16();
+        detect_baud = bit_x16 ? (uint32_t)((uint64_t)clock_get_hz(clk_sys) * 16 / bit_x16) : 0;
+        uint32_t baud = snap_baud(detect_baud, detect_cand, detect_ncand);
+        if (!bit_x16 || !rx_oversampling(baud)) {
+            detect_finish(DETECT_NO_SIGNAL);
+            return;
+        }
+        for (int i = 0; i < detect_ncand; i++) {
+            if (detect_cand[i].baud != baud) detect_cand_mode[i] = MODE_CUSTOM;
+            detect_cand[i].baud = baud;
+        }
+
+        /* Capture a stretch at the new rate; the parser keeps running on it */
+        switch_proto(&detect_cand[0], detect_cand_mode[0]);
+        detect_start = get_ring_wr_pos(l);
+        detect_t0 = time_us_32();
+        detect_state = DETECT_CAPTURE;
+        return;
+    }
+
+    case DETECT_CAPTURE:
+    {
+        if (((get_ring_wr_pos(l) - detect_start) & RING_POS_MASK) < DETECT_BYTES) {
+            if (time_us_32() - detect_t0 > DETECT_WAIT_US) {
+                switch_proto(&detect_prev, detect_prev_mode);
+                detect_finish(DETECT_NO_SIGNAL);
+            }
+            return;
+        }
+
+        parser_pause();
+        int best = 0;
+        uint32_t best_lines = 0;
+        for (int i = 0; i < detect_ncand; i++) {
+            uint32_t n = detect_score(l, &detect_cand[i], detect_start, DETECT_BYTES);
+            if (n > best_lines) {
+                best_lines = n;
+                best = i;
+            }
+        }
+        parser_resume();
+
+        detect_lines = best_lines;
+        if (best_lines < DETECT_MIN_LINES) {
+            switch_proto(&detect_prev, detect_prev_mode);
+            detect_finish(DETECT_NO_LINES);
+            return;
+        }
+        switch_proto(&detect_cand[best], detect_cand_mode[best]);
+        detect_finish(DETECT_OK);
+        return;
+    }
+    }
 }
 
 static void reset_frame_state(void)
 {
-    ps = SCAN_SYNC;
-    line_pos = 0;
-    gap_budget = 0;
-    frame_locked = false;
-    prev_row = -1;
-    lines_placed = 0;
-    memset(line_placed, 0, sizeof(line_placed));
-    memset(fb_a, 0, sizeof(fb_a));
-    memset(fb_b, 0, sizeof(fb_b));
-    asm_fb = fb_a;
+    if (line_dma_busy) {
+        dma_channel_abort(line_dma_chan);
+        line_dma_busy = false;
+    }
+    for (int i = 0; i < LVDS_LINKS; i++)
+        lvds_parser_reset(&links[i].parser, frame_pool[i]);
     send_fb = NULL;
-    send_offset = 0;
+    send_nseg = 0;
+    send_cur = 0;
+    send_seg_off = 0;
+    comp_phase = COMP_IDLE;
+    stats_busy = false;
+    stats_len = 0;
+    delta_refs_invalidate();
+    line_q_head = 0;
+    line_q_tail = 0;
+    fq_reset(&ready_q);
+    fq_reset(&free_q);
+    for (int i = LVDS_LINKS; i < FRAME_POOL_SIZE; i++)
+        fq_release_buffer(frame_pool[i]);
 }
 
 /* ================================================================= */
 /*  Host commands                                                     */
 /* ================================================================= */
 
+/* Read the argument bytes of a multi-byte command.  The host writes the
+ * command and its arguments in one transfer, so they normally arrive in
+ * the same packet; allow a short grace period otherwise. */
+static bool read_cmd_args(uint8_t *buf, uint32_t len)
+{
+    uint32_t got = 0;
+    for (int tries = 0; got < len && tries < 100; tries++) {
+        got += tud_vendor_read(buf + got, len - got);
+        if (got < len) {
+            tud_task();
+            sleep_us(10);
+        }
+    }
+    return got == len;
+}
+
 static void process_host_commands(void)
 {
     if (!tud_vendor_available()) return;
@@ -550,63 +2502,202 @@ static void process_host_commands(void)
     switch (cmd)
     {
     case 'N': case 'n':
-        restart_capture(MODE_NICHIA);
+        detect_cancel();
+        switch_proto(&PROTO_NICHIA, MODE_NICHIA);
         break;
 
     case 'O': case 'o':
-        restart_capture(MODE_OSRAM);
+        detect_cancel();
+        switch_proto(&PROTO_OSRAM, MODE_OSRAM);
         break;
 
-    case 'S': case 's':
+    case 'U': case 'u':
     {
-        stop_dma();
-        pio_sm_set_enabled(pio, sm, false);
-        ps = SCAN_SYNC;
-        line_pos = 0;
-        ring_rd = 0;
-        if (send_fb) { send_fb = NULL; send_offset = 0; }
+        uint8_t args[PROTO_DESC_SIZE];
+        lvds_proto_t np;
+        if (!read_cmd_args(args, PROTO_DESC_SIZE)) break;
+        if (!proto_from_desc(args, &np)) {
+            proto_rejects++;
+            break;
+        }
+        custom_proto = np;
+        custom_valid = true;
+        detect_cancel();
+        switch_proto(&np, MODE_CUSTOM);
+        break;
+    }
 
-        tud_vendor_write_flush();
-        for (int d = 0; d < 100; d++) {
-            tud_task();
-            if (tud_vendor_write_available() >= 256) break;
-            sleep_us(200);
+    case 'A': case 'a':
+        auto_detect_begin();         /* detect_step() reports the result */
+        break;
+
+    case 'C': case 'c':
+    {
+        uint8_t arg;
+        if (!read_cmd_args(&arg, 1)) break;
+        parser_pause();
+        crc_reject = (arg != 0);
+        for (int i = 0; i < LVDS_LINKS; i++)
+            links[i].parser.crc_reject = crc_reject;
+        parser_resume();
+        break;
+    }
+
+    case 'D': case 'd':
+    {
+        uint8_t arg;
+        if (read_cmd_args(&arg, 1)) {
+            delta_enabled = (arg != 0);
+            keyframe_req = true;
         }
+        break;
+    }
 
-        char status[300];
-        int len = snprintf(status, sizeof(status),
-            "MODE=%s BAUD=%u USB=%u SENT=%u DROP=%u CRC_OK=%u CRC_ERR=%u ROW_SKIP=%u GAP=%u RESYNC=%u MAXFILL=%u/%u\n",
-            current_mode == MODE_NICHIA ? "NICHIA" : "OSRAM",
-            proto->baud,
-            total_usb_bytes, frames_sent, frames_dropped,
-            crc_ok_lines, crc_errors, row_seq_skip,
-            gap_bytes_total, gap_resyncs,
-            max_fill, RING_SIZE);
-        tud_vendor_write(status, len);
-        tud_vendor_write_flush();
+    case 'K': case 'k':
+        keyframe_req = true;
+        break;
 
-        for (int d = 0; d < 50; d++) {
-            tud_task();
-            sleep_us(200);
+    case 'L': case 'l':
+    {
+        uint8_t args[3];   /* enable, row_lo, row_hi */
+        if (!read_cmd_args(args, 3)) break;
+        parser_pause();
+        drop_queued_frames();
+        line_q_head = 0;
+        line_q_tail = 0;
+        line_row_lo = args[1];
+        line_row_hi = args[2];
+        line_mode = (args[0] != 0);
+        if (line_mode) row_mode = false;
+        keyframe_req = true;
+        parser_resume();
+        break;
+    }
+
+    case 'Y': case 'y':
+    {
+        uint8_t arg;
+        if (!read_cmd_args(&arg, 1)) break;
+        parser_pause();
+        drop_queued_frames();
+        line_q_head = 0;
+        line_q_tail = 0;
+        for (int i = 0; i < LVDS_LINKS; i++) {
+            links[i].row_win.step = 0;      /* no window yet */
+            links[i].row_ended = true;      /* nothing to end */
         }
+        row_mode = (arg != 0);
+        if (row_mode) line_mode = false;
+        keyframe_req = true;
+        parser_resume();
+        break;
+    }
 
-        while (!pio_sm_is_rx_fifo_empty(pio, sm))
-            (void)pio_sm_get(pio, sm);
-        pio_sm_set_enabled(pio, sm, true);
-        start_dma();
+    case 'Z': case 'z':
+    {
+        uint8_t arg;
+        if (read_cmd_args(&arg, 1) && arg <= COMP_AUTO)
+            comp_mode = arg;
+        break;
+    }
+
+    case 'P': case 'p':
+    {
+        uint8_t arg;
+        if (read_cmd_args(&arg, 1))
+            pace_div = arg;
+        break;
+    }
+
+    case 'S': case 's':
+        /* Sent by the sender between packets; capture keeps running */
+        status_req = true;
+        break;
+
+    case 'T': case 't':
+    {
+        uint8_t arg;
+        if (!read_cmd_args(&arg, 1)) break;
+        if (arg == 0xFF) {
+            telem_due = true;                 /* one-shot */
+        } else if (arg == 0) {
+            telem_period_us = 0;
+        } else {
+            if (arg > TELEM_MAX_HZ) arg = TELEM_MAX_HZ;
+            telem_period_us = 1000000u / arg;
+            telem_next_us = time_us_64();
+        }
+        break;
+    }
+
+    case 'G': case 'g':
+    {
+        uint8_t args[3];   /* fps, pattern, errors */
+        if (!read_cmd_args(args, 3)) break;
+        gen_stop();
+        gen_fps = args[0];
+        gen_pattern = args[1];
+        gen_errors = args[2];
+        if (gen_fps) gen_start();
+        break;
+    }
+
+    case 'W': case 'w':
+    {
+        uint8_t args[7];   /* x_lo, x_hi, y, w_lo, w_hi, h, step */
+        if (!read_cmd_args(args, 7)) break;
+        roi_x = (uint16_t)(args[0] | (args[1] << 8));
+        roi_y = args[2];
+        roi_w = (uint16_t)(args[3] | (args[4] << 8));
+        roi_h = args[5];
+        roi_step = args[6];
+        keyframe_req = true;      /* delta refs hold the old window */
+        break;
+    }
+
+    case 'H': case 'h':
+    {
+        uint8_t arg;   /* bit0 row summary, bit1 histogram, 0 = off */
+        if (read_cmd_args(&arg, 1))
+            stats_flags = arg & (STATS_FLAG_ROWS | STATS_FLAG_HIST);
+        break;
+    }
+
+    case 'X': case 'x':
+    {
+        uint8_t arg;
+        if (read_cmd_args(&arg, 1) && arg <= USB_TX_PACKED)
+            usb_tx_mode = arg;
         break;
     }
 
     case 'R': case 'r':
+        /* parse_stats, max_fill, ring_overruns and (row mode) frames_sent
+         * are read-modify-written by core 1: reset them while it waits */
+        parser_pause();
         total_usb_bytes = 0;
         frames_sent = 0;
         frames_dropped = 0;
-        crc_errors = 0;
-        crc_ok_lines = 0;
-        row_seq_skip = 0;
-        gap_bytes_total = 0;
-        gap_resyncs = 0;
+        queue_hwm = 0;
+        line_recs = 0;
+        line_rec_drops = 0;
+        memset(&parse_stats, 0, sizeof(parse_stats));
         max_fill = 0;
+        ring_overruns = 0;
+        gen_frames = 0;
+        gen_late = 0;
+        usb_xfers = 0;
+        usb_packets = 0;
+        usb_zlps = 0;
+        pace_packets0 = 0;
+        key_frames = 0;
+        delta_frames = 0;
+        delta_rows = 0;
+        comp_frames = 0;
+        comp_in_bytes = 0;
+        comp_out_bytes = 0;
+        stats_frames = 0;
+        parser_resume();
         break;
 
     case 'B': case 'b':
@@ -642,6 +2733,28 @@ static void update_led(void)
 /*  TinyUSB callbacks                                                 */
 /* ================================================================= */
 
+/* A bulk IN transfer completed (tud_task() context).  TinyUSB 0.17 and
+ * later send a ZLP themselves when a transfer ends on a packet boundary
+ * with nothing left to send; 0.16 does not, and without it a host read
+ * larger than the frame tail would wait for the next frame. */
+void tud_vendor_tx_cb(uint8_t itf, uint32_t sent_bytes)
+{
+    (void)itf;
+    usb_xfers++;
+    if (sent_bytes == 0) {
+        usb_packets++;
+        usb_zlps++;
+        return;
+    }
+    usb_packets += (sent_bytes + USB_PKT_SIZE - 1) / USB_PKT_SIZE;
+#if TUSB_VERSION_MAJOR == 0 && TUSB_VERSION_MINOR < 17
+    if (sent_bytes % USB_PKT_SIZE == 0 &&
+        tud_vendor_write_available() == CFG_TUD_VENDOR_TX_BUFSIZE &&
+        usbd_edpt_claim(0, USB_EP_IN))
+        usbd_edpt_xfer(0, USB_EP_IN, NULL, 0);
+#endif
+}
+
 /*
 void tud_vendor_line_state_cb(uint8_t itf, bool dtr, bool rts)
 {
@@ -47,17 +47,30 @@ extern "C" {
 
 
 /* ── Vendor buffer sizes ─────────────────────────────────────────── */
-/* FS bulk max packet = 64 bytes.                                     */
+/*
+ * FS bulk max packet = 64 bytes (wMaxPacketSize in usb_descriptors.c).
+ *
+ * TX FIFO holds one whole Osram packet (56-byte header + 26880 pixel
+ * bytes), so the sender can queue a frame in one go and the bus never
+ * waits for the main loop mid-frame.  Must stay a multiple of 64: the
+ * packed sender keeps only whole packets in it.
+ */
 #ifndef CFG_TUD_VENDOR_RX_BUFSIZE
 #define CFG_TUD_VENDOR_RX_BUFSIZE  512     /* host → device (commands) */
 #endif
 #ifndef CFG_TUD_VENDOR_TX_BUFSIZE
-#define CFG_TUD_VENDOR_TX_BUFSIZE  8192    /* device → host (stream) */
+#define CFG_TUD_VENDOR_TX_BUFSIZE  32768   /* device → host (stream) */
 #endif
 
-/* ── Endpoint sizes ──────────────────────────────────────────────── */
+/* ── Endpoint transfer buffer ────────────────────────────────────── */
+/*
+ * Size of the buffer TinyUSB moves out of the FIFO per bulk transfer,
+ * not the packet size.  At 64 every transfer is one packet and the
+ * next one is only queued from tud_task(); at 4096 the DCD sends up to
+ * 64 packets per transfer from its interrupt handler.
+ */
 #ifndef CFG_TUD_VENDOR_EPSIZE
-#define CFG_TUD_VENDOR_EPSIZE      64
+#define CFG_TUD_VENDOR_EPSIZE      4096
 #endif
 
 #ifdef __cplusplus
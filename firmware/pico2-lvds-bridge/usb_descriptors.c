@@ -2,10 +2,12 @@
  * usb_descriptors.c — USB device / configuration / string descriptors
  *
  * Single CDC interface for LVDS-to-USB bridge.
- * VID/PID uses Pico default (Raspberry Pi).
+ * VID/PID uses Pico default (Raspberry Pi).  The serial number is the
+ * RP2350 chip ID, so a host with several bridges can tell them apart.
  */
 
 #include "tusb.h"
+#include "pico/unique_id.h"
 
 /* ── Device Descriptor ───────────────────────────────────────────── */
 
@@ -63,12 +65,15 @@ static char const *string_desc_arr[] = {
     (const char[]){0x09, 0x04},       /* 0: Language = English */
     "VilsSharpX",                      /* 1: Manufacturer */
     "LVDS-to-USB Bridge (Pico 2)",     /* 2: Product */
-    "000001",                          /* 3: Serial */
+    NULL,                              /* 3: Serial (chip ID, see below) */
     "LVDS VENDOR",                        /* 4: Vendor Interface */
 };
 
 static uint16_t _desc_str[32];
 
+/* 16 hex digits of the chip ID, read once on the first request */
+static char serial_str[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1];
+
 uint16_t const *tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
     (void)langid;
     uint8_t chr_count;
@@ -81,6 +86,11 @@ uint16_t const *tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
             return NULL;
 
         const char *str = string_desc_arr[index];
+        if (index == 3) {
+            if (!serial_str[0])
+                pico_get_unique_board_id_string(serial_str, sizeof serial_str);
+            str = serial_str;
+        }
         chr_count = (uint8_t)strlen(str);
         if (chr_count > 31) chr_count = 31;
 